@@ -6,74 +6,407 @@ import re
 import sys
 
 import bz2
+import hashlib
 import json
+import time
+from collections import Counter
 from objdict import ObjDict
 
 c_head="/* Generated by lsusb for rp2040 */"
+c_digest_head="/* usb.ids sha1: "
 
 def addslashes(s):
   return repr('"' + s)[2:-1].replace('"', '\\"')
 
-def parse_usb_ids_list(data):
-    cre_vendor = re.compile(r'^(?P<vendor_id>[a-fA-F0-9]+)\s+' r'(?P<vendor_name>.*)$')
-    cre_product = re.compile(r'^\s+(?P<product_id>[a-fA-F0-9]+)\s+' r'(?P<product_name>.*)$')
 
-    usb_ids = {}
-    vendor_j = None
-
-    for line_i in data.strip().splitlines():
+def mph_hash(seed, key):
+    # must match usb_ids_hash() in usb.org/lsusb_info.h
+    h = (key * 0x9E3779B1 + seed * 0x85EBCA6B) & 0xffffffff
+    h ^= h >> 15
+    h = (h * 0x2C1B3C6D) & 0xffffffff
+    h ^= h >> 12
+    return h
+
+
+def mph_build(keys, bucket_count):
+    # hash-and-displace minimal perfect hash, every key gets its own slot in [0, len(keys))
+    #   disp[bucket] > 0 : slot = hash(disp, key) % len(keys)
+    #   disp[bucket] < 0 : slot = -disp-1 (single key bucket)
+    keys_count = len(keys)
+    buckets = [[] for _ in range(bucket_count)]
+    for key_idx, key in enumerate(keys):
+        buckets[mph_hash(0, key) % bucket_count].append(key_idx)
+    disp = [0] * bucket_count
+    slot = [None] * keys_count
+    buckets_order = sorted(range(bucket_count), key=lambda b: len(buckets[b]), reverse=True)
+    for bucket_idx in buckets_order:
+        bucket = buckets[bucket_idx]
+        if len(bucket) <= 1:
+            break
+        d = 1
+        while True:
+            slots = [mph_hash(d, keys[key_idx]) % keys_count for key_idx in bucket]
+            if len(set(slots)) == len(slots) and all(slot[s] is None for s in slots):
+                break
+            d = d + 1
+            if d > 0x7fff:
+                raise ValueError("Unable to build perfect hash, increase bucket count")
+        for key_idx, s in zip(bucket, slots):
+            slot[s] = key_idx
+        disp[bucket_idx] = d
+    free_slots = [s for s in range(keys_count) if slot[s] is None]
+    for bucket_idx in buckets_order:
+        if len(buckets[bucket_idx]) == 1:
+            s = free_slots.pop()
+            slot[s] = buckets[bucket_idx][0]
+            disp[bucket_idx] = -s-1
+    return disp, slot
+
+
+def keys_to_c(name, keys):
+    c_list = []
+    c_list.append("const uint16_t " + name + "[] = \n{")
+    for i in range(0, len(keys), 16):
+        c_list.append("  " + " ".join("0x%04x," % key for key in keys[i:i+16]))
+    c_list.append("};\n")
+    return c_list
+
+
+def mph_to_c(name, disp, slot):
+    c_list = []
+    c_list.append("const int16_t " + name + "_mph_disp[] = \n{")
+    for i in range(0, len(disp), 16):
+        c_list.append("  " + " ".join(str(d) + "," for d in disp[i:i+16]))
+    c_list.append("};\n")
+    c_list.append("const uint16_t " + name + "_mph_slot[] = \n{")
+    for i in range(0, len(slot), 16):
+        c_list.append("  " + " ".join(str(s) + "," for s in slot[i:i+16]))
+    c_list.append("};\n\n")
+    return c_list
+
+
+def interpolation_probes(keys, keys_idx, key):
+    # probes spent by the map() + linear walk previously used by get_vendor()
+    keys_count = len(keys)
+    maybe_idx = ((key - keys[0]) * (keys_count - 1) // (keys[-1] - keys[0])) & 0xffff
+    if maybe_idx >= keys_count:
+        return 1
+    if key in keys_idx:
+        return 1 + abs(keys_idx[key] - maybe_idx)
+    last_idx = 0 if key < keys[maybe_idx] else keys_count - 1
+    return 1 + abs(last_idx - maybe_idx)
+
+
+def mph_report(keys):
+    keys_idx = {key: idx for idx, key in enumerate(keys)}
+    hits   = [interpolation_probes(keys, keys_idx, key) for key in keys]
+    misses = [interpolation_probes(keys, keys_idx, key) for key in range(0x10000) if key not in keys_idx]
+    print("Vendor lookup probes (interpolation walk): hit avg %.1f worst %d, miss avg %.1f worst %d" %
+        (sum(hits)/len(hits), max(hits), sum(misses)/len(misses), max(misses)))
+    print("Vendor lookup probes (perfect hash): hit/miss 1")
+
+
+# Name pool: every name is stored once in usb_ids_pool[] as a zero terminated
+# string of codes, see usb_ids_name() in usb.org/lsusb_info.h
+#   0x01-0x7f           : literal ascii char
+#   0x80-0xef           : short token, usb_ids_token(code-0x80)
+#   0xf0-0xfe + 1 byte  : word token, usb_ids_token(112 + ((code-0xf0)<<8 | byte))
+#   0xff + 1 byte       : literal byte (non ascii chars)
+POOL_TOKEN1        = 0x80
+POOL_TOKEN2        = 0xf0
+POOL_ESCAPE        = 0xff
+POOL_TOKEN1_COUNT  = POOL_TOKEN2 - POOL_TOKEN1
+POOL_TOKEN2_COUNT  = (POOL_ESCAPE - POOL_TOKEN2) * 256
+POOL_TOKEN1_MAX_LEN = 8
+POOL_TOKEN2_MAX_LEN = 24
+cre_pool_word = re.compile(rb' ?[^ ]+')
+
+def pool_index(tokens):
+    # tokens grouped by their first two bytes, longest first
+    index = {}
+    for sym in sorted(tokens, key=len, reverse=True):
+        index.setdefault(sym[:2], []).append(sym)
+    return index
+
+
+def pool_tokenize(name, index):
+    # greedy longest match
+    syms = []
+    i = 0
+    while i < len(name):
+        sym = name[i:i+1]
+        for token in index.get(name[i:i+2], ()):
+            if name.startswith(token, i):
+                sym = token
+                break
+        syms.append(sym)
+        i = i + len(sym)
+    return syms
+
+
+def pool_build_tokens(names, rounds=4):
+    # word tokens (2 bytes codes): whole words with their leading space, by gain
+    words = Counter()
+    for name in names:
+        words.update(cre_pool_word.findall(name))
+    gains = sorted(((count * (len(word)-2), word) for word, count in words.items() if 3 < len(word) <= POOL_TOKEN2_MAX_LEN), reverse=True)
+    tokens2 = [word for gain, word in gains if gain > len(word)+3][:POOL_TOKEN2_COUNT]
+    # short tokens (1 byte codes): FSST-like training on what the words don't cover, each
+    # round counts the symbols produced by the current table plus adjacent symbol pairs
+    tokens1 = []
+    sample = names[::2]
+    for _ in range(rounds):
+        tokens2_set = set(tokens2)
+        index = pool_index(tokens1 + tokens2)
+        counts = Counter()
+        for name in sample:
+            syms = [sym for sym in pool_tokenize(name, index)]
+            for i in range(len(syms)):
+                if syms[i] in tokens2_set:
+                    continue
+                counts[syms[i]] += 1
+                if i+1 < len(syms) and syms[i+1] not in tokens2_set and len(syms[i]) + len(syms[i+1]) <= POOL_TOKEN1_MAX_LEN:
+                    counts[syms[i] + syms[i+1]] += 1
+        gains = sorted(((count * (len(sym)-1), sym) for sym, count in counts.items() if len(sym) > 1), reverse=True)
+        tokens1 = [sym for gain, sym in gains[:POOL_TOKEN1_COUNT]]
+    return tokens1 + [word for word in tokens2 if word not in tokens1]
+
+
+def pool_encode(name, tokens, index):
+    codes = bytearray()
+    for sym in pool_tokenize(name, index):
+        if len(sym) > 1:
+            token_idx = tokens[sym]
+            if token_idx < POOL_TOKEN1_COUNT:
+                codes.append(POOL_TOKEN1 + token_idx)
+            else:
+                token_idx = token_idx - POOL_TOKEN1_COUNT
+                codes.append(POOL_TOKEN2 + (token_idx >> 8))
+                codes.append(token_idx & 0xff)
+        elif sym[0] >= 0x80:
+            codes.append(POOL_ESCAPE)
+            codes.append(sym[0])
+        else:
+            codes.append(sym[0])
+    return bytes(codes)
+
+
+def pool_literal(data):
+    literal = ''
+    for byte in data:
+        char = chr(byte)
+        if char in '"\\?':
+            literal += '\\' + char
+        elif 0x20 <= byte < 0x7f:
+            literal += char
+        else:
+            literal += '\\%03o' % byte
+    return literal
+
+
+class NamePool:
+    def __init__(self, names):
+        unique_names = sorted(set(name.encode('utf-8') for name in names))
+        tokens = pool_build_tokens(unique_names)
+        index  = pool_index(tokens)
+        self.tokens  = {sym: idx for idx, sym in enumerate(tokens)}
+        self.offsets = {b'': 0}
+        self.data    = bytearray(b'\0')
+        self.lines   = ['  "\\0"']
+        self.raw_size = sum(len(name)+1 for name in unique_names)
+        self.name_max = max(len(name) for name in unique_names) + 1
+        for name in unique_names:
+            codes = pool_encode(name, self.tokens, index)
+            self.offsets[name] = len(self.data)
+            self.data += codes + b'\0'
+            self.lines.append('  "' + pool_literal(codes) + '\\0"')
+        self.tokens_size = sum(len(sym)+1 for sym in tokens)
+        if self.tokens_size > 0xffff or len(self.data) > 0xffffff:
+            raise ValueError("Name pool overflow")
+
+    def offset(self, name):
+        return self.offsets[name.encode('utf-8')]
+
+    def to_c(self):
+        c_list = [c_head]
+        c_list.append("// compressed name pool, see usb_ids_name()")
+        c_list.append("#define USB_IDS_NAME_MAX    " + str(self.name_max) + " // longest decoded name + terminator")
+        c_list.append("#define USB_IDS_POOL_TOKEN1 0x%02x" % POOL_TOKEN1)
+        c_list.append("#define USB_IDS_POOL_TOKEN2 0x%02x" % POOL_TOKEN2)
+        c_list.append("#define USB_IDS_POOL_ESCAPE 0x%02x\n" % POOL_ESCAPE)
+        c_list.append("struct usb_ids_str_t { uint8_t offset[3]; }; // 24 bits offset in usb_ids_pool[]\n")
+        c_list.append("#define USB_IDS_STR(offset) { { (uint8_t)(offset), (uint8_t)((offset)>>8), (uint8_t)((offset)>>16) } }\n")
+        tokens = sorted(self.tokens, key=lambda sym: self.tokens[sym])
+        token_offsets = []
+        token_offset = 0
+        for sym in tokens:
+            token_offsets.append(token_offset)
+            token_offset = token_offset + len(sym) + 1
+        c_list.append("const uint16_t usb_ids_tokens_idx[] = \n{")
+        for i in range(0, len(token_offsets), 16):
+            c_list.append("  " + " ".join(str(o) + "," for o in token_offsets[i:i+16]))
+        c_list.append("};\n")
+        c_list.append("const char usb_ids_tokens[] = \n{")
+        for sym in tokens:
+            c_list.append('  "' + pool_literal(sym) + '\\0"')
+        c_list.append("};\n")
+        c_list.append("const uint8_t usb_ids_pool[] = \n{")
+        c_list.extend(self.lines)
+        c_list.append("};\n\n")
+        return c_list
+
+    def report(self, vendors_count, products_count):
+        tokens_size = self.tokens_size + 2*len(self.tokens)
+        before = self.raw_size + vendors_count*16 + products_count*8
+        after  = len(self.data) + tokens_size + vendors_count*(8+2) + products_count*(3+2)
+        print("Name pool: %d unique names, %d bytes raw, %d bytes encoded + %d bytes tokens" % (len(self.offsets)-1, self.raw_size, len(self.data), tokens_size))
+        print("Name tables flash footprint: %d bytes -> %d bytes (%d bytes saved)" % (before, after, before-after))
+        names_count = len(self.offsets)-1
+        print("Name decoding: avg %.1f pool bytes read for %.1f chars per name" % ((len(self.data)-1)/names_count, self.raw_size/names_count - 1))
+
+
+# precompiled once, the parsers are fed line by line in a single pass over usb.ids
+cre_section  = re.compile(r'^# List of (?P<section_name>.*)$')
+cre_vendor   = re.compile(r'^(?P<vendor_id>[a-fA-F0-9]+)\s+' r'(?P<vendor_name>.*)$')
+cre_product  = re.compile(r'^\s+(?P<product_id>[a-fA-F0-9]+)\s+' r'(?P<product_name>.*)$')
+cre_class    = re.compile(r'^C\s(?P<class>[a-fA-F0-9]+)\s+' r'(?P<class_name>.*)$')
+cre_subclass = re.compile(r'^\s(?P<subclass>[a-fA-F0-9]+)\s+' r'(?P<subclass_name>.*)$')
+cre_protocol = re.compile(r'^\s\s(?P<protocol>[a-fA-F0-9]+)\s+' r'(?P<protocol_name>.*)$')
+cre_hid_item = re.compile(r'^(?P<kind>HUT|R|PHY|BIAS)\s(?P<id>[a-fA-F0-9]+)\s+' r'(?P<name>.*)$')
+cre_usage    = re.compile(r'^\t(?P<usage>[a-fA-F0-9]+)\s+' r'(?P<usage_name>.*)$')
+cre_language = re.compile(r'^L\s(?P<language>[a-fA-F0-9]+)\s+' r'(?P<language_name>.*)$')
+cre_dialect  = re.compile(r'^\t(?P<dialect>[a-fA-F0-9]+)\s+' r'(?P<dialect_name>.*)$')
+
+
+class UsbIdsParser:
+    def __init__(self):
+        self.usb_ids  = {}
+        self.vendor_j = None
+
+    def feed(self, line_i):
         match_i = cre_vendor.match(line_i)
         if match_i:
-            vendor_j = {'name': match_i.group('vendor_name')}
-            usb_ids[match_i.group('vendor_id')] = vendor_j
-            continue
+            self.vendor_j = {'name': match_i.group('vendor_name')}
+            self.usb_ids[match_i.group('vendor_id')] = self.vendor_j
+            return
 
         match_i = cre_product.match(line_i)
-        if match_i and vendor_j is not None:
-            products_j = vendor_j.get('products', {})
+        if match_i and self.vendor_j is not None:
+            products_j = self.vendor_j.get('products', {})
             products_j[match_i.group('product_id')] =\
                 {'name': match_i.group('product_name')}
-            vendor_j['products'] = products_j
-            continue
-    return usb_ids
-
+            self.vendor_j['products'] = products_j
 
-def parse_usb_class_list(data):
+    def result(self):
+        return self.usb_ids
 
-    usb_ids    = {}
 
-    classes    = []
-    subclasses = []
-    protocols  = []
+class UsbClassParser:
+    def __init__(self):
+        self.classes    = []
+        self.subclasses = []
+        self.protocols  = []
 
-    for line in data.strip().splitlines():
-
-        usb_class = re.compile(r'^C\s(?P<class>[a-fA-F0-9]+)\s+' r'(?P<class_name>.*)$')
-        match_c = usb_class.match(line)
+    def feed(self, line):
+        match_c = cre_class.match(line)
         if match_c:
-            classes.append({"class":match_c.group('class'), "name":match_c.group('class_name'), "subclass_idx":len(subclasses), "subclass_count":0})
+            self.classes.append({"class":match_c.group('class'), "name":match_c.group('class_name'), "subclass_idx":len(self.subclasses), "subclass_count":0})
+            return
 
-        usb_subclass = re.compile(r'^\s(?P<subclass>[a-fA-F0-9]+)\s+' r'(?P<subclass_name>.*)$')
-        match_s = usb_subclass.match(line)
+        match_s = cre_subclass.match(line)
         if match_s:
-            subclasses.append({"subclass":match_s.group('subclass'), "name":match_s.group('subclass_name'), "proto_idx":len(protocols), "proto_count":0})
-            classes[len(classes)-1]["subclass_count"] = classes[len(classes)-1]["subclass_count"] + 1
-            #classes[len(classes)-1]["subclass_idx"] = len(subclasses) - classes[len(classes)-1]["subclass_count"]
+            self.subclasses.append({"subclass":match_s.group('subclass'), "name":match_s.group('subclass_name'), "proto_idx":len(self.protocols), "proto_count":0})
+            self.classes[-1]["subclass_count"] = self.classes[-1]["subclass_count"] + 1
+            return
 
-        usb_protocol = re.compile(r'^\s\s(?P<protocol>[a-fA-F0-9]+)\s+' r'(?P<protocol_name>.*)$')
-        match_p = usb_protocol.match(line)
+        match_p = cre_protocol.match(line)
         if match_p:
-            protocols.append({"protocol":match_p.group('protocol'), "name":match_p.group('protocol_name')})
-            subclasses[len(subclasses)-1]["proto_count"] = subclasses[len(subclasses)-1]["proto_count"] + 1
+            self.protocols.append({"protocol":match_p.group('protocol'), "name":match_p.group('protocol_name')})
+            self.subclasses[-1]["proto_count"] = self.subclasses[-1]["proto_count"] + 1
+
+    def result(self):
+        return {"classes": self.classes, "subclasses": self.subclasses, "protocols": self.protocols}
+
+
+class HidParser:
+    # shared by the HID item types, physical descriptor and HID usages sections
+    def __init__(self):
+        self.items  = {"R": {}, "PHY": {}, "BIAS": {}}
+        self.pages  = []
+        self.usages = []
+
+    def feed(self, line):
+        match_i = cre_hid_item.match(line)
+        if match_i:
+            kind = match_i.group('kind')
+            if kind == "HUT":
+                self.pages.append({"page":match_i.group('id'), "name":match_i.group('name'), "usage_idx":len(self.usages), "usage_count":0})
+            else:
+                self.items[kind][int(match_i.group('id'), 16)] = match_i.group('name')
+            return
+
+        match_u = cre_usage.match(line)
+        if match_u and self.pages:
+            self.usages.append({"usage":match_u.group('usage'), "name":match_u.group('usage_name')})
+            self.pages[-1]["usage_count"] = self.pages[-1]["usage_count"] + 1
+
+    def result(self):
+        return {"items": self.items, "pages": self.pages, "usages": self.usages}
+
 
-    usb_ids["classes"]    = classes
-    usb_ids["subclasses"] = subclasses
-    usb_ids["protocols"]  = protocols
-    return usb_ids
+class LanguageParser:
+    def __init__(self):
+        self.languages = []
+        self.dialects  = []
 
+    def feed(self, line):
+        match_l = cre_language.match(line)
+        if match_l:
+            self.languages.append({"language":match_l.group('language'), "name":match_l.group('language_name'), "dialect_idx":len(self.dialects), "dialect_count":0})
+            return
 
+        # the HID country codes (HCC) share this section, they have no dialect lines
+        match_d = cre_dialect.match(line)
+        if match_d and self.languages:
+            self.dialects.append({"dialect":match_d.group('dialect'), "name":match_d.group('dialect_name')})
+            self.languages[-1]["dialect_count"] = self.languages[-1]["dialect_count"] + 1
 
-def classes_protos_to_c( usb_ids=None, output_file="classes_protos.h" ):
+    def result(self):
+        return {"languages": self.languages, "dialects": self.dialects}
+
+
+
+def write_c_file(output_file, digest, c_lists):
+    with open(output_file, "w") as c_file:
+        c_file.write(c_digest_head + digest + " */\n")
+        for c_list in c_lists:
+            c_file.write("\n".join(c_list))
+
+
+def c_file_digest(output_file):
+    # digest of the inputs the header was generated from, if any
+    try:
+        with open(output_file, "r") as c_file:
+            head = c_file.readline().strip()
+    except OSError:
+        return None
+    if not head.startswith(c_digest_head):
+        return None
+    return head[len(c_digest_head):-len(" */")]
+
+
+def id_map_to_c(slice_ids):
+    # 256 bits map of a sorted slice of 8 bits ids
+    ids = [int(id_str, 16) for id_str in slice_ids]
+    if ids != sorted(set(ids)):
+        raise ValueError("Unsorted or duplicate ids in slice: " + " ".join(slice_ids))
+    words = [0] * 8
+    for id_int in ids:
+        words[id_int >> 5] |= 1 << (id_int & 31)
+    return "{ " + ", ".join("0x%08x" % word for word in words) + " }"
+
+
+def classes_protos_to_c( usb_ids=None, output_file="classes_protos.h", digest="" ):
     if usb_ids==None:
         return
 
@@ -81,9 +414,9 @@ def classes_protos_to_c( usb_ids=None, output_file="classes_protos.h" ):
     u_subcl_t = [c_head]
     u_proto_t = [c_head]
 
-    u_class_t.append("struct usb_class_t { uint8_t class_id; const char* name; uint8_t subclass_t_idx; uint8_t subclass_count; };\n\nconst usb_class_t usb_classes[] = \n{")
-    u_subcl_t.append("struct usb_subclass_t { uint8_t subclass_id; const char* name; uint8_t proto_t_idx; uint8_t proto_count; };\n\nconst usb_subclass_t usb_subclasses[] = \n{")
-    u_proto_t.append("struct usb_proto_t { uint8_t proto_id; const char* name; };\n\nconst usb_proto_t usb_protos[] = \n{")
+    u_class_t.append("struct usb_class_t { uint8_t class_id; const char* name; uint8_t subclass_t_idx; uint8_t subclass_count; };\n\nconstexpr usb_class_t usb_classes[] = \n{")
+    u_subcl_t.append("struct usb_subclass_t { uint8_t subclass_id; const char* name; uint8_t proto_t_idx; uint8_t proto_count; };\n\nconstexpr usb_subclass_t usb_subclasses[] = \n{")
+    u_proto_t.append("struct usb_proto_t { uint8_t proto_id; const char* name; };\n\nconstexpr usb_proto_t usb_protos[] = \n{")
 
     usb_items=ObjDict(usb_ids)
 
@@ -100,20 +433,50 @@ def classes_protos_to_c( usb_ids=None, output_file="classes_protos.h" ):
     u_subcl_t.append( "};\n\n" )
     u_proto_t.append( "};\n\n" )
 
-    with open(output_file, "w") as c_file:
-        c_file.write("\n".join(u_class_t))
-        c_file.write("\n".join(u_subcl_t))
-        c_file.write("\n".join(u_proto_t))
+    # direct indexes: class id -> usb_classes[] index, then one 256 bits map per class
+    # (resp. subclass) where the rank of the subclass (resp. protocol) id bit is its
+    # offset in the slice, see get_class_sub_proto()
+    classes_idx = [0xff] * 256
+    for class_idx, u_class in enumerate(usb_items.classes):
+        classes_idx[int(u_class["class"], 16)] = class_idx
+    u_index_t = [c_head]
+    u_index_t.append("constexpr uint8_t usb_classes_idx[256] = \n{")
+    for i in range(0, 256, 16):
+        u_index_t.append("  " + " ".join("0x%02x," % idx for idx in classes_idx[i:i+16]))
+    u_index_t.append("};\n")
+    u_index_t.append("constexpr uint32_t usb_subclasses_map[][8] = \n{")
+    for u_class in usb_items.classes:
+        slice_ids = [u_subclass["subclass"] for u_subclass in usb_items.subclasses[u_class["subclass_idx"]:u_class["subclass_idx"]+u_class["subclass_count"]]]
+        u_index_t.append("  " + id_map_to_c(slice_ids) + ", // 0x" + u_class["class"])
+    u_index_t.append("};\n")
+    u_index_t.append("constexpr uint32_t usb_protos_map[][8] = \n{")
+    for u_subclass in usb_items.subclasses:
+        slice_ids = [u_protocol["protocol"] for u_protocol in usb_items.protocols[u_subclass["proto_idx"]:u_subclass["proto_idx"]+u_subclass["proto_count"]]]
+        u_index_t.append("  " + id_map_to_c(slice_ids) + ", // 0x" + u_subclass["subclass"])
+    u_index_t.append("};\n\n")
 
+    write_c_file(output_file, digest, [u_class_t, u_subcl_t, u_proto_t, u_index_t])
 
 
-def vid_pid_to_c( usb_ids=None, output_file="usg.ids.h" ):
+
+def vid_pid_to_c( usb_ids=None, output_file="usg.ids.h", digest="" ):
     if usb_ids==None:
         return
+    names = []
+    for vendor_id in usb_ids:
+        names.append(usb_ids[vendor_id]['name'])
+        for product_id in usb_ids[vendor_id].get('products', {}):
+            names.append(usb_ids[vendor_id]['products'][product_id]['name'])
+    pool = NamePool(names)
+
+    # structure of arrays: the searches only touch the dense uint16_t key arrays,
+    # usb_vids[idx] / usb_pids[idx] hold the matching name and product slice
     c_vid_list = [c_head]
-    c_vid_list.append("struct vendor_id_t { uint16_t vendor_id; const char* name; uint16_t product_id_t_idx; size_t product_count; };\n\nconst vendor_id_t usb_vids[] = \n{")
+    c_vid_list.append("struct vendor_id_t { usb_ids_str_t name; uint16_t product_id_t_idx; uint16_t product_count; };\n\nconst vendor_id_t usb_vids[] = \n{")
     c_pid_list = [c_head]
-    c_pid_list.append("struct product_id_t { uint16_t product_id; const char* name; };\n\nconst product_id_t usb_pids[] = \n{")
+    c_pid_list.append("struct product_id_t { usb_ids_str_t name; };\n\nconst product_id_t usb_pids[] = \n{")
+    vendor_keys  = []
+    product_keys = []
     vendor_idx  = 0
     product_idx = 0
     for vendor_id in usb_ids:
@@ -121,47 +484,180 @@ def vid_pid_to_c( usb_ids=None, output_file="usg.ids.h" ):
         products_count=0
         if hasattr(vendor_data, 'products'):
             products_count=len(vendor_data.products)
-            for product_id in vendor_data.products:
+            # get_product() does a binary search in the vendor's slice, keep it sorted
+            for product_id in sorted(vendor_data.products, key=lambda pid: int(pid, 16)):
                 product_data = ObjDict( vendor_data.products[product_id] )
-                c_pid_list.append( '  { 0x' + product_id + ', "' + addslashes(product_data.name) + '"' +"}," )
-        c_vid_list.append( '  { 0x' + vendor_id + ', "' + addslashes(vendor_data.name) + '"' + ", " + str(product_idx) + ", "+ str(products_count) +"}," )
+                c_pid_list.append( '  { USB_IDS_STR(' + str(pool.offset(product_data.name)) + ') }, // 0x' + product_id )
+                product_keys.append(int(product_id, 16))
+        c_vid_list.append( '  { USB_IDS_STR(' + str(pool.offset(vendor_data.name)) + ')' + ", " + str(product_idx) + ", "+ str(products_count) +" }, // 0x" + vendor_id )
+        vendor_keys.append(int(vendor_id, 16))
         product_idx=product_idx+products_count
         vendor_idx=vendor_idx+1
 
     c_vid_list.append( "};\n\n" )
     c_pid_list.append( "};\n\n" )
 
-    with open(output_file, "w") as c_file:
-        c_file.write("\n".join(c_vid_list))
-        c_file.write("\n".join(c_pid_list))
+    c_keys_list = [c_head]
+    c_keys_list.extend(keys_to_c("usb_vid_keys", vendor_keys))
+    c_keys_list.extend(keys_to_c("usb_pid_keys", product_keys))
 
+    mph_disp, mph_slot = mph_build(vendor_keys, len(vendor_keys)//2)
+    c_mph_list = [c_head]
+    c_mph_list.append("// minimal perfect hash over usb_vid_keys[], see get_vendor()")
+    c_mph_list.extend(mph_to_c("usb_vids", mph_disp, mph_slot))
+    mph_report(vendor_keys)
+    pool.report(vendor_idx, product_idx)
 
-def main():
-    input_file="usb.org/usb.ids" # get a copy from http://www.linux-usb.org/usb.ids
-    vid_pid_file="usb.org/lsusb.ids.h" # will be overwritten
-    classes_proto_file="usb.org/lsusb.classes_protos.h" # will be overwritten
+    write_c_file(output_file, digest, [pool.to_c(), c_vid_list, c_pid_list, c_keys_list, c_mph_list])
 
-    with open(input_file, 'r', encoding='windows-1252') as input_:
-        contents=input_.read()
 
-    sections=contents.split("# List of")
+def id_names_to_c(name, id_names, size, id_shift=0):
+    # id-indexed name array, gaps are nullptr
+    c_list = ["constexpr const char* " + name + "[" + str(size) + "] = \n{"]
+    for id_int in range(size):
+        if id_int in id_names:
+            c_list.append('  "' + addslashes(id_names[id_int]) + '", // 0x%02x' % (id_int << id_shift))
+        else:
+            c_list.append("  nullptr,")
+    c_list.append("};\n")
+    return c_list
 
-    for section in sections:
-        section_name=section.split("\n")[0]
-        if section_name=='#':
-            section_name=" Vendors, devices and interfaces"
-            usb_ids = parse_usb_ids_list(section)
-            vid_pid_to_c(usb_ids, vid_pid_file)
-        if section_name==' known device classes, subclasses and protocols':
-            usb_classes=parse_usb_class_list(section) # TODO: parse this
-            classes_protos_to_c(usb_classes, classes_proto_file)
 
+def hid_to_c( hid_ids=None, output_file="hid.h", digest="" ):
+    if hid_ids==None:
+        return
 
+    u_page_t  = [c_head]
+    u_usage_t = [c_head]
 
+    u_page_t.append("struct hid_usage_page_t { uint8_t page_id; const char* name; uint16_t usage_t_idx; uint16_t usage_count; };\n\nconstexpr hid_usage_page_t hid_usage_pages[] = \n{")
+    u_usage_t.append("struct hid_usage_t { uint16_t usage_id; const char* name; };\n\nconstexpr hid_usage_t hid_usages[] = \n{")
 
-if __name__ == '__main__':
-    main()
+    hid_items=ObjDict(hid_ids)
+
+    pages_idx = [0xff] * 256
+    for page_idx, u_page in enumerate(hid_items.pages):
+        pages_idx[int(u_page["page"], 16)] = page_idx
+        u_page_t.append("  {0x"+u_page["page"]+ ', "' + addslashes(u_page["name"]) + '", ' +str(u_page["usage_idx"])+ ", "  +str(u_page["usage_count"])+ "},")
+        # get_hid_usage() does a binary search in the page's slice
+        slice_ids = [int(u_usage["usage"], 16) for u_usage in hid_items.usages[u_page["usage_idx"]:u_page["usage_idx"]+u_page["usage_count"]]]
+        if slice_ids != sorted(set(slice_ids)):
+            raise ValueError("Unsorted or duplicate usages in page 0x" + u_page["page"])
+
+    for u_usage in hid_items.usages:
+        u_usage_t.append("  {0x"+u_usage["usage"]+ ', "' + addslashes(u_usage["name"]) + '"},')
+
+    u_page_t.append( "};\n\n" )
+    u_usage_t.append( "};\n\n" )
+
+    u_index_t = [c_head]
+    u_index_t.append("constexpr uint8_t hid_usage_pages_idx[256] = \n{")
+    for i in range(0, 256, 16):
+        u_index_t.append("  " + " ".join("0x%02x," % idx for idx in pages_idx[i:i+16]))
+    u_index_t.append("};\n\n")
+
+    # item tags are indexed without their 2 bits size field
+    u_items_t = [c_head]
+    u_items_t.extend(id_names_to_c("hid_item_types", {item>>2: name for item, name in hid_items["items"]["R"].items()}, 64, 2))
+    u_items_t.extend(id_names_to_c("hid_phys_items", hid_items["items"]["PHY"], max(hid_items["items"]["PHY"])+1))
+    u_items_t.extend(id_names_to_c("hid_phys_biases", hid_items["items"]["BIAS"], max(hid_items["items"]["BIAS"])+1))
+    u_items_t.append("\n")
+
+    write_c_file(output_file, digest, [u_page_t, u_usage_t, u_index_t, u_items_t])
+
+
+def languages_to_c( usb_langs=None, output_file="languages.h", digest="" ):
+    if usb_langs==None:
+        return
+
+    u_lang_t    = [c_head]
+    u_dialect_t = [c_head]
+
+    # a LANGID is the 10 bits primary language id, and the dialect id in the upper 6 bits
+    u_lang_t.append("struct usb_lang_t { uint16_t lang_id; const char* name; uint8_t dialect_t_idx; uint8_t dialect_count; };\n\nconstexpr usb_lang_t usb_langs[] = \n{")
+    u_dialect_t.append("struct usb_dialect_t { uint8_t dialect_id; const char* name; };\n\nconstexpr usb_dialect_t usb_dialects[] = \n{")
 
+    lang_items=ObjDict(usb_langs)
 
+    # get_lang() does a binary search on the languages, then in the language's dialect slice
+    lang_ids = [int(u_lang["language"], 16) for u_lang in lang_items.languages]
+    if lang_ids != sorted(set(lang_ids)):
+        raise ValueError("Unsorted or duplicate language ids")
 
+    for u_lang in lang_items.languages:
+        u_lang_t.append("  {0x"+u_lang["language"]+ ', "' + addslashes(u_lang["name"]) + '", ' +str(u_lang["dialect_idx"])+ ", "  +str(u_lang["dialect_count"])+ "},")
+        slice_ids = [int(u_dialect["dialect"], 16) for u_dialect in lang_items.dialects[u_lang["dialect_idx"]:u_lang["dialect_idx"]+u_lang["dialect_count"]]]
+        if slice_ids != sorted(set(slice_ids)):
+            raise ValueError("Unsorted or duplicate dialects in language 0x" + u_lang["language"])
 
+    for u_dialect in lang_items.dialects:
+        u_dialect_t.append("  {0x"+u_dialect["dialect"]+ ', "' + addslashes(u_dialect["name"]) + '"},')
+
+    u_lang_t.append( "};\n\n" )
+    u_dialect_t.append( "};\n\n" )
+
+    write_c_file(output_file, digest, [u_lang_t, u_dialect_t])
+
+
+# usb.ids sections with a generator: title => (parser, emitter, output file),
+# sections sharing an output file are fed to the same parser
+SECTIONS = {
+    "Vendors, devices and interfaces"                : (UsbIdsParser,   vid_pid_to_c,        "usb.org/lsusb.ids.h"),
+    "known device classes, subclasses and protocols" : (UsbClassParser, classes_protos_to_c, "usb.org/lsusb.classes_protos.h"),
+    "HID Descriptor Item Types"                      : (HidParser,      hid_to_c,            "usb.org/lsusb.hid.h"),
+    "Physical Descriptor Bias Types"                 : (HidParser,      hid_to_c,            "usb.org/lsusb.hid.h"),
+    "Physical Descriptor Item Types"                 : (HidParser,      hid_to_c,            "usb.org/lsusb.hid.h"),
+    "HID Usages"                                     : (HidParser,      hid_to_c,            "usb.org/lsusb.hid.h"),
+    "Languages"                                      : (LanguageParser, languages_to_c,      "usb.org/lsusb.languages.h"),
+}
+
+
+def main():
+    arg_parser = argparse.ArgumentParser(description="Generate lsusb-rp2040 lookup tables from usb.ids")
+    arg_parser.add_argument("--input", default="usb.org/usb.ids", help="get a copy from http://www.linux-usb.org/usb.ids")
+    arg_parser.add_argument("--force", action="store_true", help="regenerate headers even if their inputs are unchanged")
+    args = arg_parser.parse_args()
+
+    # headers also depend on this script
+    with open(__file__, 'rb') as gen_file:
+        gen_source = gen_file.read()
+
+    # single streaming pass: every line is hashed and fed to its output file's parser
+    parse_start = time.perf_counter()
+    parsers  = {}
+    hashes   = {}
+    emitters = {}
+    def open_section(section_name):
+        if section_name not in SECTIONS:
+            return None
+        parser_class, emitter, output_file = SECTIONS[section_name]
+        if output_file not in parsers:
+            parsers[output_file]  = parser_class()
+            hashes[output_file]   = hashlib.sha1(gen_source)
+            emitters[output_file] = emitter
+        return output_file
+
+    output_file = open_section("Vendors, devices and interfaces")
+    with open(args.input, 'r', encoding='windows-1252') as input_:
+        for line in input_:
+            match_section = cre_section.match(line)
+            if match_section:
+                output_file = open_section(match_section.group('section_name').strip())
+                continue
+            if output_file:
+                hashes[output_file].update(line.encode('utf-8'))
+                parsers[output_file].feed(line.rstrip('\n'))
+    print("Parsed %s in %.0f ms" % (args.input, (time.perf_counter()-parse_start)*1000))
+
+    for output_file in parsers:
+        digest = hashes[output_file].hexdigest()
+        if not args.force and c_file_digest(output_file) == digest:
+            print("%s is up to date" % output_file)
+            continue
+        emit_start = time.perf_counter()
+        emitters[output_file](parsers[output_file].result(), output_file, digest)
+        print("Generated %s in %.0f ms" % (output_file, (time.perf_counter()-emit_start)*1000))
+
+
+if __name__ == '__main__':
+    main()
@@ -26,7 +26,13 @@
 
 #pragma once
 
-#define LANGUAGE_ID 0x0409  // English
+#define LANGUAGE_ID 0x0409  // English (US), preferred when the device supports it
+#define LANGID_MAX  8       // LANGIDs kept per device
+#define STRINGS_MAX 16      // string descriptors kept per device
+#define STRING_LEN  64      // utf-8 bytes kept per string descriptor
+#define CONFIGS_MAX 4       // configuration descriptors kept per device
+#define DEVICES_MAX (CFG_TUH_DEVICE_MAX + CFG_TUH_HUB) // device table size, hubs take an address too
+#define ENUM_RETRY_MS 1000  // how long a request waits for the control pipe shared by all devices
 
 // #include "pico/stdlib.h"
 // #include "pico/multicore.h"
@@ -38,74 +44,162 @@
 
 #include "pio_usb.h"          // Bring USB-HOST Headers from Library: Pico_PIO_USB
 #include "tusb.h"             // tinyUSB stack
+#include "host/hcd.h"         // hcd_devtree_get_info()
 #include "Adafruit_TinyUSB.h" // Adafruit layer
 
 // string functions, labels, helpers
 #include "usb.org/lsusb_info.h"
 #include "misc/helpers.h"
+#include "misc/desc_cache.h"
+#include "misc/event_ring.h"
+#include "misc/uart_tx.h"
+#include "misc/output.h"
+#include "misc/capture.h"
+#include "misc/json.h"
+#include "misc/console.h"
 
 
 // Each HID instance can has multiple reports
 #define MAX_REPORT  4
-static struct
+#define HID_EP_MAX  4 // HID IN endpoints per device whose last report the delta mode keeps
+
+#if !defined HID_REPORT_DELTA
+  #define HID_REPORT_DELTA false // print only the bytes that changed, the 'r' command toggles it
+#endif
+
+// set on core0 by the console
+volatile bool hid_report_delta = HID_REPORT_DELTA;
+
+enum enum_stage_t
+{
+  ENUM_IDLE,
+  ENUM_DEVICE,  // device descriptor
+  ENUM_LANGIDS, // string descriptor 0
+  ENUM_CONFIG_HEADER, // first 9 bytes of the configuration descriptor, for wTotalLength
+  ENUM_CONFIG,  // full configuration descriptor, then the next configuration's header
+  ENUM_STRINGS, // every string index the device and configuration descriptors refer to
+  ENUM_VERIFY,  // device descriptor, rendered from the descriptor cache
+  ENUM_VERIFY_SERIAL, // serial string, the last part of the cache key
+};
+
+// Everything known about one device address. Each device runs its own callback chained
+// enumeration: each completion callback submits the next request so tuh_task() never
+// blocks on a round-trip, the descriptors are pushed to core0 once everything is in.
+// Devices plugged together (e.g. behind a hub) are enumerated side by side.
+// Core0 keeps its own copy of each device, rebuilt from the event ring and rendered.
+struct usb_device_t
 {
-  uint8_t report_count;
-  tuh_hid_report_info_t report_info[MAX_REPORT];
-}hid_info[CFG_TUH_HID];
+  uint8_t daddr;       // 0 when the slot is free
+  uint8_t rhport;      // topology, from hcd_devtree_get_info() at mount
+  uint8_t hub_addr;    // 0 when plugged in the root port
+  uint8_t hub_port;
+  uint8_t speed;       // tusb_speed_t
+  uint8_t stage;       // enum_stage_t
+  bool ready;          // enumerated, enum_redump() can render it
+  bool listening;      // HID IN endpoints polled, once per mount
+  bool retry;          // the control pipe was busy, enum_task() submits again
+  uint32_t retry_ms;   // first busy submit of the current request
+  uint32_t start_us;
+  uint16_t xfers;
+  tusb_desc_device_t desc;
+  // LANGIDs from string descriptor 0, read once per device
+  struct {
+    uint8_t count; // 0 when the device has no string descriptors
+    uint16_t langid[LANGID_MAX];
+    uint16_t best; // LANGUAGE_ID when supported, else the first LANGID
+  } langs;
+  uint8_t string_count;
+  uint8_t string_next; // next string to fetch
+  struct {
+    uint8_t index;
+    bool valid;
+    char utf8[STRING_LEN];
+  } strings[STRINGS_MAX];
+  uint16_t string_buf[128];
+  tusb_desc_configuration_t config_header;
+  uint8_t config_next; // next configuration index to fetch
+  uint8_t config_count;
+  struct {
+    uint8_t* desc;     // wTotalLength bytes from the device's configuration descriptor pool
+    uint16_t len;      // bytes actually received
+  } configs[CONFIGS_MAX];
+  tusb_desc_device_t verify_device;
+  desc_cache_entry_t* cached; // entry rendered before verification
+  struct {
+    uint8_t report_count;
+    tuh_hid_report_info_t report_info[MAX_REPORT];
+  } hid[CFG_TUH_HID];
+  // core0: last report printed per endpoint, for hid_report_delta
+  struct {
+    uint8_t ep;        // 0 when the slot is free
+    uint8_t len;
+    uint8_t data[HID_REPORT_SIZE];
+  } hid_last[HID_EP_MAX];
+};
+
+static usb_device_t usb_devices[DEVICES_MAX]; // core1, enumeration state
+static usb_device_t usb_views[DEVICES_MAX];   // core0, rendered state
+static cfg_pool_t enum_cfg_pool, view_cfg_pool;
+
+// core1: device table slot of an address, NULL when out of range
+usb_device_t* get_device(uint8_t daddr)
+{
+  return (daddr > 0 && daddr <= DEVICES_MAX) ? &usb_devices[daddr-1] : NULL;
+}
 
-tusb_desc_device_t plugged_device;
+// core0: rendered copy of a device, NULL when out of range
+usb_device_t* get_view(uint8_t daddr)
+{
+  return (daddr > 0 && daddr <= DEVICES_MAX) ? &usb_views[daddr-1] : NULL;
+}
 
-void print_device_descriptor(tuh_xfer_t* xfer);
-void parse_config_descriptor(uint8_t dev_addr, tusb_desc_configuration_t const* desc_cfg);
+void enum_start(uint8_t daddr);
+void print_usb_tree_ports(uint8_t rhport, uint8_t hub_addr, uint8_t depth);
+void print_device_descriptor(uint8_t daddr);
+void parse_config_descriptor(uint8_t dev_addr, tusb_desc_configuration_t const* desc_cfg, uint16_t len);
 void parse_hid_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, uint16_t max_len);
 void parse_audio_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, uint16_t max_len);
 void parse_generic_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, uint16_t max_len);
 void parse_cdc_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, tusb_desc_interface_assoc_t* desc_assoc, uint16_t max_len);
 void parse_mtp_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, uint16_t max_len);
+void json_device(uint8_t daddr);
+void event_render_json(const event_header_t* header, const uint8_t* payload);
 
 
-void debug_print(char* str)
-{
-  printf(str);
-}
-
+// USB host callbacks run on core1, they only push events for core0 to render
 
 void tuh_mount_cb (uint8_t daddr)
 {
-  printf("[tuh_mount_cb] Device attached, address = %d\r\n", daddr);
-  tuh_descriptor_get_device(daddr, &plugged_device, 18, print_device_descriptor, 0);
+  // the topology only changes on mount and unmount, core0 keeps it with its copy of the device
+  hcd_devtree_info_t devtree;
+  hcd_devtree_get_info(daddr, &devtree);
+  event_push(EVT_MOUNT, daddr, &devtree, sizeof(devtree));
+  enum_start(daddr);
 }
 
 
-void tuh_umount_cb(uint8_t dev_addr, uint8_t instance)
+void tuh_umount_cb(uint8_t daddr)
 {
-  printf("[tuh_umount_cb][%u] Interface%u is unmounted\r\n", dev_addr, instance);
+  event_push(EVT_UNMOUNT, daddr);
+  usb_device_t* dev = get_device(daddr);
+  if (dev == NULL) return;
+  // the address is handed out again, late completions for this one are dropped
+  free_cfg_bufs(enum_cfg_pool, daddr);
+  memset(dev, 0, sizeof(usb_device_t));
 }
 
 
 void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_report, uint16_t desc_len)
 {
-  printf("HID device address = %d, instance = %d is mounted\r\n", dev_addr, instance);
-
-  // Interface protocol (hid_interface_protocol_enum_t)
-  const char* protocol_str[] = { "None", "Keyboard", "Mouse" };
-  uint8_t const itf_protocol = tuh_hid_interface_protocol(dev_addr, instance);
-
-  printf("HID Interface Protocol = %s\r\n", protocol_str[itf_protocol]);
-
-  // By default host stack will use activate boot protocol on supported interface.
-  // Therefore for this simple example, we only need to parse generic report descriptor (with built-in parser)
-  if ( itf_protocol == HID_ITF_PROTOCOL_NONE )
-  {
-    hid_info[instance].report_count = tuh_hid_parse_report_descriptor(hid_info[instance].report_info, MAX_REPORT, desc_report, desc_len);
-    printf("HID has %u reports \r\n", hid_info[instance].report_count);
-  }
+  // Interface protocol (hid_interface_protocol_enum_t), the report descriptor is parsed by core0
+  uint8_t const hid[2] = { instance, tuh_hid_interface_protocol(dev_addr, instance) };
+  event_push(EVT_HID_MOUNT, dev_addr, hid, sizeof(hid), desc_report, desc_len);
 
   // request to receive report
   // tuh_hid_report_received_cb() will be invoked when report is available
   if ( !tuh_hid_receive_report(dev_addr, instance) )
   {
-    printf("Error: cannot request to receive report\r\n");
+    event_log(dev_addr, LOG_HID_RECEIVE_FAILED);
   }
 }
 
@@ -113,7 +207,7 @@ void tuh_hid_mount_cb(uint8_t dev_addr, uint8_t instance, uint8_t const* desc_re
 // Invoked when device with hid interface is un-mounted
 void tuh_hid_umount_cb(uint8_t dev_addr, uint8_t instance)
 {
-  printf("[tuh_hid_umount_cb][%u] HID Interface%u is unmounted\r\n", dev_addr, instance);
+  event_push(EVT_HID_UNMOUNT, dev_addr, &instance, sizeof(instance));
   free_hid_buf(dev_addr);
 }
 
@@ -124,18 +218,13 @@ void hid_report_received(tuh_xfer_t* xfer)
   // For instance, xfer->buffer is NULL. We have used user_data to store buffer when submitted callback
   uint8_t* buf = (uint8_t*) xfer->user_data;
   if (xfer->result == XFER_RESULT_SUCCESS) {
-    printf("[dev %u: ep %02x] HID Report:", xfer->daddr, xfer->ep_addr);
-    for(uint32_t i=0; i<xfer->actual_len; i++) {
-      if (i%16 == 0) printf("\r\n  ");
-      printf("%02X ", buf[i]);
-    }
-    printf("\r\n");
+    event_push(EVT_HID_REPORT, xfer->daddr, &xfer->ep_addr, sizeof(xfer->ep_addr), buf, xfer->actual_len);
   } else {
-    printf("Error\n");
+    event_log(xfer->daddr, LOG_HID_REPORT_FAILED, xfer->ep_addr);
   }
   // continue to submit transfer, with updated buffer
   // other field remain the same
-  xfer->buflen = 64;
+  xfer->buflen = HID_REPORT_SIZE;
   xfer->buffer = buf;
   tuh_edpt_xfer(xfer);
 }
@@ -164,169 +253,1379 @@ uint16_t count_interface_total_len(tusb_desc_interface_t const* desc_itf, uint8_
 }
 
 
-void print_device_descriptor(tuh_xfer_t* xfer)
+void parse_langids(usb_device_t* dev, const uint16_t* desc)
+{
+  uint8_t const bLength = desc[0] & 0xff;
+  uint8_t const count = bLength < 2 ? 0 : (bLength-2) / sizeof(uint16_t);
+  dev->langs.count = count < LANGID_MAX ? count : LANGID_MAX;
+  for (uint8_t i=0; i<dev->langs.count; i++) {
+    dev->langs.langid[i] = desc[1+i];
+  }
+  if (dev->langs.count > 0) {
+    dev->langs.best = dev->langs.langid[0];
+    for (uint8_t i=0; i<dev->langs.count; i++) {
+      if (dev->langs.langid[i] == LANGUAGE_ID) dev->langs.best = LANGUAGE_ID;
+    }
+  }
+}
+
+
+void enum_queue_string(usb_device_t* dev, uint8_t index)
 {
-  if ( XFER_RESULT_SUCCESS != xfer->result ) {
-    printf("Failed to get device descriptor\r\n");
+  if (index == 0 || dev->string_count == STRINGS_MAX) return;
+  for (uint8_t i=0; i<dev->string_count; i++) {
+    if (dev->strings[i].index == index) return;
+  }
+  dev->strings[dev->string_count].index = index;
+  dev->strings[dev->string_count].valid = false;
+  dev->string_count++;
+}
+
+
+// iConfiguration, iFunction and iInterface
+void enum_queue_config_strings(usb_device_t* dev, tusb_desc_configuration_t const* desc_cfg, uint16_t len)
+{
+  uint16_t const total_len = tu_le16toh(desc_cfg->wTotalLength);
+  uint8_t const* desc_end = ((uint8_t const*) desc_cfg) + (total_len < len ? total_len : len);
+  uint8_t const* p_desc   = (uint8_t const*) desc_cfg;
+
+  enum_queue_string(dev, desc_cfg->iConfiguration);
+  while (p_desc + 2 <= desc_end && tu_desc_len(p_desc) >= 2 && p_desc + tu_desc_len(p_desc) <= desc_end) {
+    if (tu_desc_type(p_desc) == TUSB_DESC_INTERFACE_ASSOCIATION) {
+      enum_queue_string(dev, ((tusb_desc_interface_assoc_t const*) p_desc)->iFunction);
+    } else if (tu_desc_type(p_desc) == TUSB_DESC_INTERFACE) {
+      enum_queue_string(dev, ((tusb_desc_interface_t const*) p_desc)->iInterface);
+    }
+    p_desc = tu_desc_next(p_desc);
+  }
+}
+
+
+void enum_complete(tuh_xfer_t* xfer);
+void enum_fetch_config_header(usb_device_t* dev);
+void enum_fetch_next_string(usb_device_t* dev);
+void enum_cache_stale(usb_device_t* dev);
+void enum_full(usb_device_t* dev);
+
+
+// string fetched by the enumeration, empty when absent
+const char* enum_string(const usb_device_t* dev, uint8_t index)
+{
+  for (uint8_t i=0; index != 0 && i<dev->string_count; i++) {
+    if (dev->strings[i].index == index && dev->strings[i].valid) return dev->strings[i].utf8;
+  }
+  return "";
+}
+
+
+// units of the same model differ by their serial number only, which picks the entry
+bool enum_cache_has_serial(const usb_device_t* dev)
+{
+  return dev->desc.iSerialNumber != 0 && dev->langs.count > 0;
+}
+
+
+// snapshot of a full enumeration, not cached when it is larger than the whole arena,
+// the cached entries stay untouched then
+void enum_cache_store(usb_device_t* dev, uint32_t enum_us)
+{
+  size_t blob_len = 0;
+  for (uint8_t i=0; i<dev->string_count; i++) {
+    if (dev->strings[i].valid) blob_len += desc_cache_string_size(dev->strings[i].utf8);
+  }
+  for (uint8_t i=0; i<dev->config_count; i++) {
+    blob_len += desc_cache_config_size(dev->configs[i].len);
+  }
+  const char* serial = enum_string(dev, dev->desc.iSerialNumber);
+  auto entry = desc_cache_slot(dev->desc.idVendor, dev->desc.idProduct, dev->desc.bcdDevice, serial, blob_len);
+  if (entry == NULL) {
+    desc_cache_stats.too_large++;
     return;
   }
-  uint8_t const daddr = xfer->daddr;
-
-  auto vid_pid = get_vid_pid( plugged_device.idVendor, plugged_device.idProduct );
-  auto vendor  = vid_pid.vendor;
-  auto product = vid_pid.product;
-  auto class_sub_proto = get_class_sub_proto(plugged_device.bDeviceClass, plugged_device.bDeviceSubClass, plugged_device.bDeviceProtocol );
-
-  printf("Device %u: ID %04x:%04x\r\n", daddr, plugged_device.idVendor, plugged_device.idProduct);
-  printf("Device Descriptor:\r\n");
-  printf("  bLength             %u\r\n"        , plugged_device.bLength);
-  printf("  bDescriptorType     %u\r\n"        , plugged_device.bDescriptorType);
-  printf("  bcdUSB              %04x\r\n"      , plugged_device.bcdUSB);
-  printf("  bDeviceClass        %u %s\r\n"     , plugged_device.bDeviceClass, class_sub_proto.dev_class->name );
-  printf("  bDeviceSubClass     %u %s\r\n"     , plugged_device.bDeviceSubClass, class_sub_proto.dev_subclass->name );
-  printf("  bDeviceProtocol     %u %s\r\n"     , plugged_device.bDeviceProtocol, class_sub_proto.dev_proto->name);
-  printf("  bMaxPacketSize0     %u\r\n"        , plugged_device.bMaxPacketSize0);
-  printf("  idVendor            0x%04x %s\r\n" , plugged_device.idVendor, vendor->name );
-  printf("  idProduct           0x%04x %s\r\n" , plugged_device.idProduct, product->name);
-  printf("  bcdDevice           %04x\r\n"      , plugged_device.bcdDevice);
-  // Get String descriptor using Sync API
-  uint16_t temp_buf[128];
-  printf("  iManufacturer       %u ", plugged_device.iManufacturer);
-  if (XFER_RESULT_SUCCESS == tuh_descriptor_get_manufacturer_string_sync(daddr, LANGUAGE_ID, temp_buf, sizeof(temp_buf)) ) {
-    print_utf16(temp_buf, TU_ARRAY_SIZE(temp_buf), debug_print);
-  }
-  printf("\r\n");
-  printf("  iProduct            %u ", plugged_device.iProduct);
-  if (XFER_RESULT_SUCCESS == tuh_descriptor_get_product_string_sync(daddr, LANGUAGE_ID, temp_buf, sizeof(temp_buf))) {
-    print_utf16(temp_buf, TU_ARRAY_SIZE(temp_buf), debug_print);
-  }
-  printf("\r\n");
-  printf("  iSerialNumber       %u ", plugged_device.iSerialNumber);
-  if (XFER_RESULT_SUCCESS == tuh_descriptor_get_serial_string_sync(daddr, LANGUAGE_ID, temp_buf, sizeof(temp_buf))) {
-    print_utf16(temp_buf, TU_ARRAY_SIZE(temp_buf), debug_print);
-  }
-  printf("\r\n");
-  printf("  bNumConfigurations  %u\r\n", plugged_device.bNumConfigurations);
-  // Get configuration descriptor with sync API
-  if (XFER_RESULT_SUCCESS == tuh_descriptor_get_configuration_sync(daddr, 0, temp_buf, sizeof(temp_buf))) {
-    parse_config_descriptor(daddr, (tusb_desc_configuration_t*) temp_buf);
+  entry->vid          = dev->desc.idVendor;
+  entry->pid          = dev->desc.idProduct;
+  entry->bcdDevice    = dev->desc.bcdDevice;
+  strncpy(entry->serial, serial, STRING_LEN);
+  entry->device       = dev->desc;
+  entry->langid_count = dev->langs.count;
+  memcpy(entry->langid, dev->langs.langid, sizeof(entry->langid));
+  entry->best_langid  = dev->langs.best;
+  entry->enum_us      = enum_us;
+  entry->xfers        = dev->xfers;
+  for (uint8_t i=0; i<dev->string_count; i++) {
+    if (dev->strings[i].valid) desc_cache_put_string(entry, dev->strings[i].index, dev->strings[i].utf8);
   }
+  for (uint8_t i=0; i<dev->config_count; i++) {
+    desc_cache_put_config(entry, dev->configs[i].desc, dev->configs[i].len);
+  }
+  desc_cache_touch(entry);
 }
 
 
-void print_hid_dev_descriptor( tusb_hid_descriptor_hid_t const * desc_hid )
+// the cached configuration descriptors are copied back to the device's pool, the entry
+// may be evicted later. false for a corrupt entry, see desc_cache_check()
+bool enum_cache_restore(usb_device_t* dev, const desc_cache_entry_t* entry)
 {
-  printf("        HID Device Descriptor:\n");
-  printf("          bLength         %2d\n", desc_hid->bLength);         /**< Numeric expression that is the total size of the HID descriptor */
-  printf("          bDescriptorType %2d\n", desc_hid->bDescriptorType); /**< Constant name specifying type of HID descriptor. */
-  printf("          bcdHID         %3d\n",  desc_hid->bcdHID);          /**< Numeric expression identifying the HID Class Specification release */
-  printf("          bCountryCode    %2d\n", desc_hid->bCountryCode);    /**< Numeric expression identifying country code of the localized hardware.  */
-  printf("          bNumDescriptors %2d\n", desc_hid->bNumDescriptors); /**< Numeric expression specifying the number of class descriptors */
-  printf("          bReportType     %2d\n", desc_hid->bReportType);     /**< Type of HID class report. */
-  printf("          wReportLength   %2d\n", desc_hid->wReportLength);   /**< the total size of the Report descriptor. */
+  dev->desc        = entry->device;
+  dev->langs.count = entry->langid_count;
+  memcpy(dev->langs.langid, entry->langid, sizeof(dev->langs.langid));
+  dev->langs.best  = entry->best_langid;
+  dev->string_count = 0;
+  dev->config_count = 0;
+  free_cfg_bufs(enum_cfg_pool, dev->daddr);
+  return desc_cache_unpack(entry,
+    [dev](uint8_t index, const char* utf8, uint8_t len) {
+      if (dev->string_count == STRINGS_MAX || len > STRING_LEN - 1) return;
+      auto string = &dev->strings[dev->string_count++];
+      string->index = index;
+      string->valid = true;
+      memcpy(string->utf8, utf8, len);
+      string->utf8[len] = '\0';
+    },
+    [dev](const uint8_t* desc, uint16_t len) {
+      uint8_t* buf = dev->config_count < CONFIGS_MAX ? get_cfg_buf(enum_cfg_pool, dev->daddr, len) : NULL;
+      if (buf == NULL) return;
+      memcpy(buf, desc, len);
+      dev->configs[dev->config_count++] = { buf, len };
+    }
+  );
 }
 
 
+// false when another device's enumeration reused the entry since it was rendered
+bool enum_cache_owned(const usb_device_t* dev)
+{
+  return memcmp(&dev->cached->device, &dev->desc, sizeof(tusb_desc_device_t)) == 0;
+}
 
-void print_interface_descriptor(uint8_t dev_addr, tusb_desc_interface_t const* desc_itf )
+
+void enum_finish(usb_device_t* dev)
+{
+  dev->stage = ENUM_IDLE;
+  dev->retry = false;
+}
+
+
+// the whole device as one snapshot for core0, dropped as a whole when the ring can't take it
+void enum_push_device(const usb_device_t* dev, uint8_t kind, uint32_t us)
+{
+  size_t size = 2 * sizeof(event_header_t) + sizeof(tusb_desc_device_t) + dev->langs.count * sizeof(uint16_t) + sizeof(event_device_end_t);
+  for (uint8_t i=0; i<dev->string_count; i++) {
+    if (dev->strings[i].valid) size += sizeof(event_header_t) + 1 + strlen(dev->strings[i].utf8);
+  }
+  for (uint8_t i=0; i<dev->config_count; i++) {
+    size += sizeof(event_header_t) + dev->configs[i].len;
+  }
+  if (size > event_ring_free()) {
+    event_ring_stats.dropped++;
+    event_ring_stats.dropped_bytes += size;
+    return;
+  }
+  event_push(EVT_DEVICE, dev->daddr, &dev->desc, sizeof(tusb_desc_device_t), dev->langs.langid, dev->langs.count * sizeof(uint16_t));
+  for (uint8_t i=0; i<dev->string_count; i++) {
+    if (dev->strings[i].valid) event_push(EVT_STRING, dev->daddr, &dev->strings[i].index, 1, dev->strings[i].utf8, strlen(dev->strings[i].utf8));
+  }
+  for (uint8_t i=0; i<dev->config_count; i++) {
+    event_push(EVT_CONFIG, dev->daddr, dev->configs[i].desc, dev->configs[i].len);
+  }
+  event_device_end_t const end = { kind, dev->xfers, us };
+  event_push(EVT_DEVICE_END, dev->daddr, &end, sizeof(end));
+}
+
+
+void enum_listen_endpoint(uint8_t daddr, tusb_desc_endpoint_t const* desc_ep)
+{
+  // skip if failed to open endpoint
+  if ( ! tuh_edpt_open(daddr, desc_ep) ) {
+    event_log(daddr, LOG_EP_OPEN_FAILED, desc_ep->bEndpointAddress);
+    return;
+  }
+  uint8_t* buf = get_hid_buf(daddr);
+  if (!buf) {
+    event_log(daddr, LOG_EP_NO_BUFFER, desc_ep->bEndpointAddress);
+    return; // out of memory
+  }
+
+  #pragma GCC diagnostic push
+  #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
+  tuh_xfer_t xfer =
+  {
+    .daddr       = daddr,
+    .ep_addr     = desc_ep->bEndpointAddress,
+    .buflen      = HID_REPORT_SIZE,
+    .buffer      = buf,
+    .complete_cb = hid_report_received,
+    .user_data   = (uintptr_t) buf, // since buffer is not available in callback, use user data to store the buffer
+  };
+  #pragma GCC diagnostic pop
+  // submit transfer for this EP
+  tuh_edpt_xfer(&xfer);
+  event_log(daddr, LOG_EP_LISTEN, desc_ep->bEndpointAddress);
+}
+
+
+// HID IN endpoints of the first configuration, once per mount
+void enum_listen_hid(usb_device_t* dev)
 {
-  auto class_sub_proto = get_class_sub_proto(desc_itf->bInterfaceClass, desc_itf->bInterfaceSubClass, desc_itf->bInterfaceProtocol );
-  printf("    Interface Descriptor #%d:\n",   desc_itf->bInterfaceNumber );
-  printf("      bLength            %8d\n",    desc_itf->bLength );
-  printf("      bDescriptorType    %8d\n",    desc_itf->bDescriptorType );
-  printf("      bInterfaceNumber   %8d\n",    desc_itf->bInterfaceNumber );
-  printf("      bAlternateSetting  %8d\n",    desc_itf->bAlternateSetting );
-  printf("      bNumEndpoints      %8d\n",    desc_itf->bNumEndpoints );
-  printf("      bInterfaceClass    %8d %s\n", desc_itf->bInterfaceClass, class_sub_proto.dev_class->name );
-  printf("      bInterfaceSubClass %8d %s\n", desc_itf->bInterfaceSubClass, class_sub_proto.dev_subclass->name  );
-  printf("      bInterfaceProtocol %8d %s\n", desc_itf->bInterfaceProtocol, class_sub_proto.dev_proto->name );
-  printf("      iInterface         %8d ",    desc_itf->iInterface );  ///< Index of string descriptor describing this interface
-  if (desc_itf->iInterface != 0) {
-    uint16_t str[128];
-    if (XFER_RESULT_SUCCESS == tuh_descriptor_get_string_sync(dev_addr, desc_itf->iInterface, LANGUAGE_ID, str, sizeof(str)) ) {
-      print_utf16( str, sizeof(str), debug_print );
+  if (dev->listening || dev->config_count == 0) return;
+  dev->listening = true;
+  auto desc_cfg = (tusb_desc_configuration_t const*) dev->configs[0].desc;
+  uint16_t const total_len = tu_le16toh(desc_cfg->wTotalLength);
+  uint8_t const* desc_end = dev->configs[0].desc + (total_len < dev->configs[0].len ? total_len : dev->configs[0].len);
+  uint8_t const* p_desc   = dev->configs[0].desc;
+  uint8_t itf_class = 0;
+  while (p_desc + 2 <= desc_end && tu_desc_len(p_desc) >= 2 && p_desc + tu_desc_len(p_desc) <= desc_end) {
+    if (tu_desc_type(p_desc) == TUSB_DESC_INTERFACE && tu_desc_len(p_desc) >= sizeof(tusb_desc_interface_t)) {
+      itf_class = ((tusb_desc_interface_t const*) p_desc)->bInterfaceClass;
+    } else if (tu_desc_type(p_desc) == TUSB_DESC_ENDPOINT && tu_desc_len(p_desc) >= sizeof(tusb_desc_endpoint_t) && itf_class == TUSB_CLASS_HID) {
+      auto desc_ep = (tusb_desc_endpoint_t const*) p_desc;
+      if (tu_edpt_dir(desc_ep->bEndpointAddress) == TUSB_DIR_IN) enum_listen_endpoint(dev->daddr, desc_ep);
     }
+    p_desc = tu_desc_next(p_desc);
   }
-  printf("\n");
 }
 
 
-void print_interface_association(uint8_t dev_addr, tusb_desc_interface_assoc_t const* desc_assoc )
+void enum_done(usb_device_t* dev)
+{
+  uint32_t const enum_us = micros() - dev->start_us;
+  enum_push_device(dev, END_ENUMERATED, enum_us);
+  enum_listen_hid(dev);
+  desc_cache_stats.misses++;
+  enum_cache_store(dev, enum_us);
+  enum_finish(dev);
+}
+
+
+void enum_cache_hit(usb_device_t* dev)
+{
+  auto entry = dev->cached;
+  uint32_t const verify_us = micros() - dev->start_us;
+  uint32_t saved_us = 0;
+  desc_cache_stats.hits++;
+  if (enum_cache_owned(dev)) {
+    saved_us = entry->enum_us > verify_us ? entry->enum_us - verify_us : 0;
+    desc_cache_stats.saved_us += saved_us;
+    desc_cache_stats.saved_xfers += entry->xfers > dev->xfers ? entry->xfers - dev->xfers : 0;
+    desc_cache_touch(entry);
+  }
+  event_log(dev->daddr, LOG_CACHE_VERIFIED, verify_us, dev->xfers, saved_us);
+  enum_finish(dev);
+}
+
+
+// the request of the current stage, with enum_complete() as callback
+bool enum_submit(usb_device_t* dev)
+{
+  uint8_t const daddr = dev->daddr;
+  switch (dev->stage) {
+    case ENUM_DEVICE:
+      return tuh_descriptor_get_device(daddr, &dev->desc, 18, enum_complete, 0);
+    case ENUM_LANGIDS:
+      return tuh_descriptor_get_string(daddr, 0, 0, dev->string_buf, sizeof(dev->string_buf), enum_complete, 0);
+    case ENUM_CONFIG_HEADER:
+      return tuh_descriptor_get_configuration(daddr, dev->config_next, &dev->config_header, sizeof(dev->config_header), enum_complete, 0);
+    case ENUM_CONFIG:
+      return tuh_descriptor_get_configuration(daddr, dev->config_next, dev->configs[dev->config_count].desc, dev->configs[dev->config_count].len, enum_complete, 0);
+    case ENUM_STRINGS:
+      return tuh_descriptor_get_string(daddr, dev->strings[dev->string_next].index, dev->langs.best, dev->string_buf, sizeof(dev->string_buf), enum_complete, 0);
+    case ENUM_VERIFY:
+      return tuh_descriptor_get_device(daddr, &dev->verify_device, 18, enum_complete, 0);
+    case ENUM_VERIFY_SERIAL:
+      return tuh_descriptor_get_string(daddr, dev->desc.iSerialNumber, dev->langs.best, dev->string_buf, sizeof(dev->string_buf), enum_complete, 0);
+    default:
+      return false;
+  }
+}
+
+
+// TinyUSB runs one control transfer at a time for all devices, a request finding the pipe
+// busy is submitted again by enum_task() for up to ENUM_RETRY_MS, false once given up
+bool enum_request(usb_device_t* dev)
+{
+  if (enum_submit(dev)) {
+    dev->retry = false;
+    dev->xfers++;
+    return true;
+  }
+  if (!dev->retry) {
+    dev->retry    = true;
+    dev->retry_ms = millis();
+  }
+  if (millis() - dev->retry_ms < ENUM_RETRY_MS) return true;
+  dev->retry = false;
+  return false;
+}
+
+
+// move past a request that was given up
+void enum_skip(usb_device_t* dev)
+{
+  switch (dev->stage) {
+    case ENUM_DEVICE:
+      event_log(dev->daddr, LOG_DEVICE_FAILED);
+      enum_finish(dev);
+      break;
+    case ENUM_LANGIDS:
+      enum_fetch_config_header(dev);
+      break;
+    case ENUM_CONFIG_HEADER:
+    case ENUM_CONFIG:
+      dev->config_next++;
+      enum_fetch_config_header(dev);
+      break;
+    case ENUM_STRINGS:
+      dev->string_next++;
+      enum_fetch_next_string(dev);
+      break;
+    case ENUM_VERIFY:
+      if (enum_cache_has_serial(dev)) {
+        enum_full(dev); // nothing rendered yet
+      } else {
+        enum_finish(dev); // keep the cached dump
+      }
+      break;
+    case ENUM_VERIFY_SERIAL:
+      enum_cache_stale(dev);
+      break;
+    default: break;
+  }
+}
+
+
+void enum_fetch(usb_device_t* dev, uint8_t stage)
+{
+  dev->stage = stage;
+  if (!enum_request(dev)) enum_skip(dev);
+}
+
+
+// requests that found the control pipe busy, called after tuh_task()
+void enum_task()
+{
+  for (auto& dev : usb_devices) {
+    if (dev.daddr != 0 && dev.retry && !enum_request(&dev)) enum_skip(&dev);
+  }
+}
+
+
+// each enum_fetch_*() submits a request through enum_fetch(), or moves on to the next
+// stage when there is nothing to fetch
+
+// no transfer at all for absent strings (index 0) or devices without a string table
+void enum_fetch_next_string(usb_device_t* dev)
+{
+  if (dev->langs.count > 0 && dev->string_next < dev->string_count) {
+    enum_fetch(dev, ENUM_STRINGS);
+    return;
+  }
+  enum_done(dev);
+}
+
+
+// every configuration is fetched before the strings, so their string indexes
+// are collected (and deduplicated) in a single pass
+void enum_fetch_config_header(usb_device_t* dev)
+{
+  uint8_t const count = dev->desc.bNumConfigurations < CONFIGS_MAX ? dev->desc.bNumConfigurations : CONFIGS_MAX;
+  if (dev->config_next < count) {
+    enum_fetch(dev, ENUM_CONFIG_HEADER);
+    return;
+  }
+  enum_fetch_next_string(dev);
+}
+
+
+// exactly wTotalLength bytes, or whatever is left in the device's pool
+void enum_fetch_config(usb_device_t* dev)
+{
+  uint16_t const total_len = tu_le16toh(dev->config_header.wTotalLength);
+  uint16_t len = total_len;
+  uint8_t* desc = get_cfg_buf(enum_cfg_pool, dev->daddr, len);
+  if (desc == NULL) {
+    len = cfg_pool_left(enum_cfg_pool, dev->daddr);
+    event_log(dev->daddr, LOG_CFG_TRUNCATED, dev->config_next, len, total_len);
+    desc = get_cfg_buf(enum_cfg_pool, dev->daddr, len);
+  }
+  dev->configs[dev->config_count] = { desc, len };
+  if (len >= sizeof(tusb_desc_configuration_t)) {
+    enum_fetch(dev, ENUM_CONFIG);
+    return;
+  }
+  dev->config_next++;
+  enum_fetch_config_header(dev);
+}
+
+
+void enum_full(usb_device_t* dev)
+{
+  dev->start_us     = micros();
+  dev->xfers        = 0;
+  dev->string_count = 0;
+  dev->string_next  = 0;
+  dev->config_next  = 0;
+  dev->config_count = 0;
+  dev->langs.count  = 0;
+  dev->langs.best   = LANGUAGE_ID;
+  free_cfg_bufs(enum_cfg_pool, dev->daddr);
+  enum_fetch(dev, ENUM_DEVICE);
+}
+
+
+// a re-plugged device is rendered from the descriptor cache, then only its device
+// descriptor (and serial string, if any) is read back to check the entry matches.
+// A device with a serial number is rendered once the serial picked its own entry:
+// the most recent entry for its vid:pid may be another unit's
+void enum_start(uint8_t daddr)
+{
+  usb_device_t* dev = get_device(daddr);
+  if (dev == NULL) return;
+  dev->daddr = daddr;
+  dev->retry = false;
+  uint16_t vid, pid;
+  dev->cached = tuh_vid_pid_get(daddr, &vid, &pid) ? desc_cache_find(vid, pid) : NULL;
+  if (dev->cached == NULL) {
+    enum_full(dev);
+    return;
+  }
+  dev->start_us = micros();
+  dev->xfers    = 0;
+  if (!enum_cache_restore(dev, dev->cached)) {
+    enum_cache_stale(dev);
+    return;
+  }
+  if (!enum_cache_has_serial(dev)) {
+    enum_push_device(dev, END_CACHED, 0);
+    enum_listen_hid(dev);
+  }
+  enum_fetch(dev, ENUM_VERIFY);
+}
+
+
+// the device changed since it was cached (e.g. firmware update), drop its entry
+void enum_cache_stale(usb_device_t* dev)
+{
+  event_log(dev->daddr, LOG_CACHE_STALE);
+  desc_cache_stats.stale++;
+  if (enum_cache_owned(dev)) dev->cached->lru = 0;
+  enum_full(dev);
+}
+
+
+// another unit of a cached model, the entries of the other units stay
+void enum_cache_new_serial(usb_device_t* dev)
+{
+  event_log(dev->daddr, LOG_CACHE_NEW_SERIAL);
+  enum_full(dev);
+}
+
+
+// completions are routed to their device by address, late ones for a removed device are dropped
+void enum_complete(tuh_xfer_t* xfer)
+{
+  usb_device_t* dev = get_device(xfer->daddr);
+  if (dev == NULL || dev->daddr != xfer->daddr) return;
+  bool const success = XFER_RESULT_SUCCESS == xfer->result;
+  switch (dev->stage) {
+    case ENUM_DEVICE:
+      if (!success) {
+        event_log(dev->daddr, LOG_DEVICE_FAILED);
+        enum_finish(dev);
+        return;
+      }
+      enum_queue_string(dev, dev->desc.iManufacturer);
+      enum_queue_string(dev, dev->desc.iProduct);
+      enum_queue_string(dev, dev->desc.iSerialNumber);
+      enum_fetch(dev, ENUM_LANGIDS);
+      break;
+    case ENUM_LANGIDS:
+      if (success) parse_langids(dev, dev->string_buf);
+      enum_fetch_config_header(dev);
+      break;
+    case ENUM_CONFIG_HEADER:
+      if (success && xfer->actual_len >= sizeof(tusb_desc_configuration_t) && tu_le16toh(dev->config_header.wTotalLength) >= sizeof(tusb_desc_configuration_t)) {
+        enum_fetch_config(dev);
+      } else {
+        dev->config_next++;
+        enum_fetch_config_header(dev);
+      }
+      break;
+    case ENUM_CONFIG:
+      if (success && xfer->actual_len >= sizeof(tusb_desc_configuration_t)) {
+        auto config = &dev->configs[dev->config_count++];
+        config->len = xfer->actual_len;
+        enum_queue_config_strings(dev, (tusb_desc_configuration_t const*) config->desc, config->len);
+      }
+      dev->config_next++;
+      enum_fetch_config_header(dev);
+      break;
+    case ENUM_STRINGS:
+      if (success) {
+        string_desc_to_utf8(dev->string_buf, dev->strings[dev->string_next].utf8, STRING_LEN);
+        dev->strings[dev->string_next].valid = true;
+      }
+      dev->string_next++;
+      enum_fetch_next_string(dev);
+      break;
+    case ENUM_VERIFY:
+      // against the rendered copy, the entry itself may have been reused in the meantime
+      if (!success || memcmp(&dev->verify_device, &dev->desc, sizeof(tusb_desc_device_t)) != 0) {
+        enum_cache_stale(dev);
+        break;
+      }
+      if (enum_cache_has_serial(dev)) {
+        enum_fetch(dev, ENUM_VERIFY_SERIAL);
+        break;
+      }
+      enum_cache_hit(dev);
+      break;
+    case ENUM_VERIFY_SERIAL: {
+      char serial[STRING_LEN];
+      if (!success) {
+        enum_cache_stale(dev);
+        break;
+      }
+      string_desc_to_utf8(dev->string_buf, serial, STRING_LEN);
+      auto match = desc_cache_find_serial(dev->desc.idVendor, dev->desc.idProduct, dev->desc.bcdDevice, serial);
+      if (match == NULL) {
+        enum_cache_new_serial(dev);
+        break;
+      }
+      if (match != dev->cached) { // another known unit of the same model
+        event_log(dev->daddr, LOG_CACHE_OTHER_UNIT, 0, 0, 0, serial);
+        dev->cached = match;
+        if (!enum_cache_restore(dev, match)) {
+          enum_cache_stale(dev);
+          break;
+        }
+      }
+      enum_push_device(dev, END_CACHED, 0);
+      enum_listen_hid(dev);
+      enum_cache_hit(dev);
+    } break;
+    default: break;
+  }
+}
+
+
+// core0: render the events pushed by core1
+
+#define EVENT_PAYLOAD_MAX (CFG_POOL_SIZE > 1024 ? CFG_POOL_SIZE : 1024) // largest event payload, a configuration descriptor
+static uint8_t event_payload[EVENT_PAYLOAD_MAX];
+
+
+void event_render_log(uint8_t daddr, const event_log_t* log, const char* str, uint16_t str_len)
+{
+  switch (log->msg) {
+    case LOG_DEVICE_FAILED:      out_printf("Device %u: failed to get device descriptor\r\n", daddr); break;
+    case LOG_CFG_TRUNCATED:      out_printf("Configuration descriptor #%lu truncated to %lu of %lu bytes, increase CFG_POOL_SIZE\r\n", (unsigned long)log->args[0], (unsigned long)log->args[1], (unsigned long)log->args[2]); break;
+    case LOG_CACHE_STALE:        out_printf("Device %u: cached descriptors are stale, enumerating\r\n", daddr); break;
+    case LOG_CACHE_NEW_SERIAL:   out_printf("Device %u: serial number not in cache, enumerating\r\n", daddr); break;
+    case LOG_CACHE_OTHER_UNIT:   out_printf("Device %u: serial number %.*s is another cached unit\r\n", daddr, str_len, str); break;
+    case LOG_CACHE_VERIFIED:     out_printf("Device %u: cache verified in %lu us, %lu transfers, %lu us saved\r\n", daddr, (unsigned long)log->args[0], (unsigned long)log->args[1], (unsigned long)log->args[2]); break;
+    case LOG_CACHE_SAVED:        out_printf("Descriptor cache saved\r\n"); break;
+    case LOG_HID_RECEIVE_FAILED: out_printf("Error: cannot request to receive report\r\n"); break;
+    case LOG_HID_REPORT_FAILED:  out_printf("Error\n"); break;
+    case LOG_EP_LISTEN:          out_printf("        Listen to [dev %u: ep %02lx]\r\n", daddr, (unsigned long)log->args[0]); break;
+    case LOG_EP_OPEN_FAILED:     out_printf("        [ERROR] Failed to open endpoint\n"); break;
+    case LOG_EP_NO_BUFFER:       out_printf("        [ERROR] OOM\n"); break;
+    default: break;
+  }
+}
+
+
+void event_render_hid_mount(uint8_t daddr, const uint8_t* payload, uint16_t len)
+{
+  if (len < 2) return;
+  uint8_t const instance = payload[0];
+  uint8_t const itf_protocol = payload[1];
+  out_printf("HID device address = %d, instance = %d is mounted\r\n", daddr, instance);
+
+  // Interface protocol (hid_interface_protocol_enum_t)
+  const char* protocol_str[] = { "None", "Keyboard", "Mouse" };
+  out_printf("HID Interface Protocol = %s\r\n", itf_protocol < 3 ? protocol_str[itf_protocol] : "");
+
+  // parsed by event_apply()
+  usb_device_t* view = get_view(daddr);
+  if ( itf_protocol == HID_ITF_PROTOCOL_NONE && view != NULL && instance < CFG_TUH_HID )
+  {
+    auto hid = &view->hid[instance];
+    out_printf("HID has %u reports \r\n", hid->report_count);
+    for( uint8_t i=0; i<hid->report_count; i++ ) {
+      tuh_hid_report_info_t* info = &hid->report_info[i];
+      const hid_usage_page_t* page = get_hid_usage_page( info->usage_page );
+      out_printf("  Report #%u: ID %u, Usage Page 0x%04x %s, Usage 0x%02x %s\r\n", i, info->report_id, info->usage_page, page->name, info->usage, get_hid_usage( page, info->usage )->name );
+    }
+  }
+}
+
+
+// core0: the report bytes, 16 per row. In delta mode only the bytes that changed since the
+// last report printed for the endpoint, as offset=value pairs, 8 per row
+void event_render_hid_report(uint8_t daddr, uint8_t ep, const uint8_t* report, uint16_t len)
+{
+  usb_device_t* view = get_view(daddr);
+  decltype(&view->hid_last[0]) last = NULL; // the endpoint's slot, else a free one, else the first one
+  if (view != NULL && len <= HID_REPORT_SIZE) {
+    for (uint8_t i = 0; i < HID_EP_MAX && (last == NULL || last->ep != ep); i++) {
+      if (view->hid_last[i].ep == ep || (view->hid_last[i].ep == 0 && last == NULL)) last = &view->hid_last[i];
+    }
+    if (last == NULL) last = &view->hid_last[0];
+  }
+
+  out_str("[dev ");
+  out_dec(daddr);
+  out_str(": ep ");
+  out_hex(ep, 2);
+  if (hid_report_delta && last != NULL && last->ep == ep && last->len == len) {
+    uint8_t changed = 0;
+    for (uint8_t offset = 0; offset < len; offset++) {
+      if (report[offset] == last->data[offset]) continue;
+      if (changed == 0) out_str("] HID Report delta:");
+      if (changed++ % 8 == 0) out_str("\r\n  ");
+      out_hex_bytes(&offset, 1, '=', true);
+      out_hex_bytes(&report[offset], 1, ' ', true);
+    }
+    out_str(changed == 0 ? "] HID Report unchanged\r\n" : "\r\n");
+  } else {
+    out_str("] HID Report:");
+    for (uint16_t i = 0; i < len; i += 16) {
+      out_str("\r\n  ");
+      out_hex_bytes(&report[i], len - i < 16 ? len - i : 16, ' ', true);
+    }
+    out_str("\r\n");
+  }
+
+  if (last != NULL) {
+    last->ep = ep;
+    last->len = len;
+    memcpy(last->data, report, len);
+  }
+}
+
+
+// core0: keep the rendered copies in sync with core1, whatever the output mode
+void event_apply(const event_header_t* header, const uint8_t* payload)
+{
+  uint8_t const daddr = header->daddr;
+  uint16_t const len  = header->len;
+  usb_device_t* view  = get_view(daddr);
+  if (view == NULL) return;
+  switch (header->type) {
+    case EVT_MOUNT:
+      if (len >= sizeof(hcd_devtree_info_t)) {
+        hcd_devtree_info_t devtree;
+        memcpy(&devtree, payload, sizeof(devtree));
+        view->daddr    = daddr;
+        view->rhport   = devtree.rhport;
+        view->hub_addr = devtree.hub_addr;
+        view->hub_port = devtree.hub_port;
+        view->speed    = devtree.speed;
+        view->ready    = false;
+      }
+      break;
+    case EVT_UNMOUNT:
+      free_cfg_bufs(view_cfg_pool, daddr);
+      memset(view, 0, sizeof(usb_device_t));
+      break;
+    case EVT_DEVICE:
+      if (len < sizeof(tusb_desc_device_t)) break;
+      memcpy(&view->desc, payload, sizeof(tusb_desc_device_t));
+      view->langs.count = (len - sizeof(tusb_desc_device_t)) / sizeof(uint16_t);
+      if (view->langs.count > LANGID_MAX) view->langs.count = LANGID_MAX;
+      memcpy(view->langs.langid, payload + sizeof(tusb_desc_device_t), view->langs.count * sizeof(uint16_t));
+      view->string_count = 0;
+      view->config_count = 0;
+      view->ready        = false;
+      view->start_us     = micros();
+      free_cfg_bufs(view_cfg_pool, daddr);
+      break;
+    case EVT_STRING:
+      if (len < 1 || view->string_count == STRINGS_MAX) break;
+      {
+        auto string = &view->strings[view->string_count++];
+        uint16_t const utf8_len = len - 1 < STRING_LEN - 1 ? len - 1 : STRING_LEN - 1;
+        string->index = payload[0];
+        string->valid = true;
+        memcpy(string->utf8, payload + 1, utf8_len);
+        string->utf8[utf8_len] = '\0';
+      }
+      break;
+    case EVT_CONFIG:
+      if (view->config_count == CONFIGS_MAX) break;
+      {
+        uint8_t* buf = get_cfg_buf(view_cfg_pool, daddr, len);
+        if (buf == NULL) break;
+        memcpy(buf, payload, len);
+        view->configs[view->config_count++] = { buf, len };
+      }
+      break;
+    case EVT_DEVICE_END:
+      view->ready = true;
+      break;
+    case EVT_HID_MOUNT:
+      // By default host stack will use activate boot protocol on supported interface.
+      // Therefore for this simple example, we only need to parse generic report descriptor (with built-in parser)
+      if (len < 2 || payload[1] != HID_ITF_PROTOCOL_NONE || payload[0] >= CFG_TUH_HID) break;
+      {
+        auto hid = &view->hid[payload[0]];
+        hid->report_count = tuh_hid_parse_report_descriptor(hid->report_info, MAX_REPORT, payload + 2, len - 2);
+      }
+      break;
+    default: break;
+  }
+}
+
+
+// core0: the text of an event, once applied
+void event_render(const event_header_t* header, const uint8_t* payload)
 {
-  auto class_sub_proto = get_class_sub_proto(desc_assoc->bFunctionClass, desc_assoc->bFunctionSubClass, desc_assoc->bFunctionProtocol );
-  printf("    Interface Association:\n" );
-  printf("      bLength                %2d\n", desc_assoc->bLength );
-  printf("      bDescriptorType        %2d\n", desc_assoc->bDescriptorType );
-  printf("      bFirstInterface        %2d\n", desc_assoc->bFirstInterface );
-  printf("      bInterfaceCount        %2d\n", desc_assoc->bInterfaceCount );
-  printf("      bFunctionClass         %2d %s\n", desc_assoc->bFunctionClass, class_sub_proto.dev_class->name );
-  printf("      bFunctionSubClass      %2d %s\n", desc_assoc->bFunctionSubClass, class_sub_proto.dev_subclass->name );
-  printf("      bFunctionProtocol      %2d %s\n", desc_assoc->bFunctionProtocol, class_sub_proto.dev_proto->name );
-  printf("      iFunction              %2d ", desc_assoc->iFunction );
-  if (desc_assoc->iFunction != 0) {
-    uint16_t str[128];
-    if (XFER_RESULT_SUCCESS == tuh_descriptor_get_string_sync(dev_addr, desc_assoc->iFunction, LANGUAGE_ID, str, sizeof(str)) ) {
-      print_utf16( str, sizeof(str), debug_print );
+  uint8_t const daddr = header->daddr;
+  uint16_t const len  = header->len;
+  usb_device_t* view  = get_view(daddr);
+  switch (header->type) {
+    case EVT_MOUNT:
+      out_printf("[tuh_mount_cb] Device attached, address = %d\r\n", daddr);
+      break;
+    case EVT_UNMOUNT:
+      out_printf("[tuh_umount_cb] Device removed, address = %d\r\n", daddr);
+      break;
+    case EVT_DEVICE_END:
+      if (view == NULL || len < sizeof(event_device_end_t)) break;
+      {
+        event_device_end_t end;
+        memcpy(&end, payload, sizeof(end));
+        print_device_descriptor(daddr);
+        if (end.kind == END_ENUMERATED) {
+          out_printf("Device %u: enumerated in %lu us, %u transfers\r\n", daddr, (unsigned long)end.us, end.xfers);
+        } else if (end.kind == END_CACHED) {
+          out_printf("Device %u: rendered from cache in %lu us\r\n", daddr, (unsigned long)(micros() - view->start_us));
+        }
+      }
+      break;
+    case EVT_LOG:
+      if (len < sizeof(event_log_t)) break;
+      {
+        event_log_t log;
+        memcpy(&log, payload, sizeof(log));
+        event_render_log(daddr, &log, (const char*) payload + sizeof(event_log_t), len - sizeof(event_log_t));
+      }
+      break;
+    case EVT_HID_MOUNT:
+      event_render_hid_mount(daddr, payload, len);
+      break;
+    case EVT_HID_UNMOUNT:
+      if (len < 1) break;
+      out_printf("[tuh_hid_umount_cb][%u] HID Interface%u is unmounted\r\n", daddr, payload[0]);
+      break;
+    case EVT_HID_REPORT:
+      if (len < 1) break;
+      event_render_hid_report(daddr, payload[0], payload + 1, len - 1);
+      break;
+    default: break;
+  }
+}
+
+
+// core0: everything core1 pushed since the last call, as text, JSON Lines or binary frames.
+// While the output is backed up the records wait in the ring, core1 counts what it drops
+void event_task()
+{
+  event_header_t header;
+  while (out_ready() && event_pop(&header, event_payload, sizeof(event_payload))) {
+    event_apply(&header, event_payload);
+    if (capture_binary) {
+      capture_write(&header, event_payload);
+    } else if (json_lines) {
+      event_render_json(&header, event_payload);
+    } else {
+      event_render(&header, event_payload);
     }
+    out_flush();
   }
-  printf("\n");
 }
 
 
-void print_bm_attributes( tusb_desc_endpoint_t const * desc_ep, const char*spacing )
+// core0: dump every enumerated device again from its rendered copy, without any transfer
+void enum_redump()
 {
-  int XferIdx  = desc_ep->bmAttributes.xfer  < 4 ? desc_ep->bmAttributes.xfer  : 0;
-  int SyncIdx  = desc_ep->bmAttributes.sync  < 4 ? desc_ep->bmAttributes.sync  : 0;
-  int UsageIdx = desc_ep->bmAttributes.usage < 4 ? desc_ep->bmAttributes.usage : 0;
+  uint8_t count = 0;
+  for (auto& dev : usb_views) {
+    if (dev.daddr == 0 || !dev.ready) continue;
+    if (json_lines) {
+      json_line_begin();
+      json_string("event", "redump");
+      json_uint("daddr", dev.daddr);
+      json_uint("us", micros());
+      json_device(dev.daddr);
+      json_line_end();
+    } else {
+      uint32_t const start_us = micros();
+      print_device_descriptor(dev.daddr);
+      out_printf("Device %u: dumped from cache in %lu us\r\n", dev.daddr, (unsigned long)(micros() - start_us));
+    }
+    count++;
+  }
+  if (count == 0) out_printf("No device to dump\r\n");
+}
+
 
-  printf("%s  bmAttributes:    0x%02x\n", spacing, desc_ep->bmAttributes );
-  printf("%s    Transfer Type:   %s\n", spacing, bmAttrXfer[XferIdx]   );
-  printf("%s    Synch Type:      %s\n", spacing, bmAttrSync[SyncIdx]   );
-  printf("%s    Usage Type:      %s\n", spacing, bmAttrUsage[UsageIdx] );
+const char* speed_to_string(uint8_t speed)
+{
+  switch (speed) {
+    case TUSB_SPEED_LOW:  return "1.5M";
+    case TUSB_SPEED_FULL: return "12M";
+    case TUSB_SPEED_HIGH: return "480M";
+    default: return "?";
+  }
 }
 
 
-void print_endpoint_descriptor( tusb_desc_endpoint_t const* cdc_edp, const char* prefix="", const char* spacing="      " )
+// TinyUSB class driver bound to an interface class
+const char* class_driver_name(uint8_t itf_class)
 {
-  printf("%s%s Endpoint Descriptor:\n", spacing, prefix);
-  printf("%s  bLength         %2d\n", spacing, cdc_edp->bLength);         /**< Numeric expression that is the total size of the HID descriptor */
-  printf("%s  bDescriptorType %2d\n", spacing, cdc_edp->bDescriptorType); /**< Constant name specifying type of HID descriptor. */
-  printf("%s  bEndpointAddress 0x%02x %s\n", spacing, cdc_edp->bEndpointAddress, bEndpointAddress_to_string(cdc_edp->bEndpointAddress) );
-  print_bm_attributes( cdc_edp, spacing);
-  printf("%s  wMaxPacketSize   0x%04x  1x %d bytes\n", spacing, cdc_edp->wMaxPacketSize, cdc_edp->wMaxPacketSize );
-  printf("%s  bInterval       %8d\n", spacing, cdc_edp->bInterval );
+  switch (itf_class) {
+    case TUSB_CLASS_HUB:      return "hub";
+    case TUSB_CLASS_HID:      return CFG_TUH_HID ? "hid" : "[none]";
+    case TUSB_CLASS_CDC:
+    case TUSB_CLASS_CDC_DATA: return CFG_TUH_CDC ? "cdc" : "[none]";
+    case TUSB_CLASS_MSC:      return CFG_TUH_MSC ? "msc" : "[none]";
+    default: return "[none]";
+  }
 }
 
 
+// one line per interface of the first configuration, then the devices plugged in it
+void print_usb_tree_device(const usb_device_t* dev, uint8_t depth)
+{
+  uint8_t const port = dev->hub_addr ? dev->hub_port : 1;
+  if (!dev->ready || dev->config_count == 0) {
+    out_printf("%*s|__ Port %u: Dev %u, %s%s\r\n", depth*4, "", port, dev->daddr, speed_to_string(dev->speed), dev->ready ? "" : ", enumerating");
+  } else {
+    auto desc_cfg = (tusb_desc_configuration_t const*) dev->configs[0].desc;
+    uint16_t const total_len = tu_le16toh(desc_cfg->wTotalLength);
+    uint8_t const* desc_end = dev->configs[0].desc + (total_len < dev->configs[0].len ? total_len : dev->configs[0].len);
+    uint8_t const* p_desc   = dev->configs[0].desc;
+    while (p_desc + 2 <= desc_end && tu_desc_len(p_desc) >= 2 && p_desc + tu_desc_len(p_desc) <= desc_end) {
+      auto desc_itf = (tusb_desc_interface_t const*) p_desc;
+      if (tu_desc_type(p_desc) == TUSB_DESC_INTERFACE && tu_desc_len(p_desc) >= sizeof(tusb_desc_interface_t) && desc_itf->bAlternateSetting == 0) {
+        auto class_sub_proto = get_class_sub_proto(desc_itf->bInterfaceClass, desc_itf->bInterfaceSubClass, desc_itf->bInterfaceProtocol);
+        out_printf("%*s|__ Port %u: Dev %u, If %u, Class=%s, Driver=%s, %s\r\n", depth*4, "", port, dev->daddr, desc_itf->bInterfaceNumber, class_sub_proto.dev_class->name, class_driver_name(desc_itf->bInterfaceClass), speed_to_string(dev->speed));
+      }
+      p_desc = tu_desc_next(p_desc);
+    }
+  }
+  print_usb_tree_ports(dev->rhport, dev->daddr, depth+1);
+}
+
 
-void print_config_descriptor( tusb_desc_configuration_t const* desc_cfg)
+// devices plugged in a hub (or the root port when hub_addr is 0), by port number
+void print_usb_tree_ports(uint8_t rhport, uint8_t hub_addr, uint8_t depth)
 {
+  int last_key = -1;
+  while (true) {
+    const usb_device_t* next = NULL;
+    int next_key = 0;
+    for (auto& dev : usb_views) {
+      int const key = dev.hub_port << 8 | dev.daddr;
+      if (dev.daddr == 0 || dev.rhport != rhport || dev.hub_addr != hub_addr || key <= last_key) continue;
+      if (next == NULL || key < next_key) {
+        next = &dev;
+        next_key = key;
+      }
+    }
+    if (next == NULL) return;
+    print_usb_tree_device(next, depth);
+    last_key = next_key;
+  }
+}
+
+
+// core0: like `lsusb -t`, from the rendered copies without any transfer
+void print_usb_tree()
+{
+  bool found = false;
+  for (uint8_t i=0; i<DEVICES_MAX; i++) {
+    // each root port once, at its first device
+    bool first = usb_views[i].daddr != 0;
+    for (uint8_t j=0; first && j<i; j++) {
+      first = usb_views[j].daddr == 0 || usb_views[j].rhport != usb_views[i].rhport;
+    }
+    if (!first) continue;
+    out_printf("/:  Bus %02u.Port 1: Class=root_hub, Driver=pio_usb\r\n", usb_views[i].rhport);
+    print_usb_tree_ports(usb_views[i].rhport, 0, 1);
+    found = true;
+  }
+  if (!found) out_printf("No device attached\r\n");
+}
+
+
+// strings were fetched by the enumeration, this only prints them
+void print_string_descriptor(uint8_t daddr, uint8_t index)
+{
+  usb_device_t* dev = get_view(daddr);
+  out_str(dev ? enum_string(dev, index) : "");
+}
+
+
+//--------------------------------------------------------------------+
+// Descriptor field schemas
+//--------------------------------------------------------------------+
+
+// One table per descriptor type, built from the TinyUSB struct so offsets and sizes
+// can't drift from it. The text dump (one line per field) and the JSON members are
+// both rendered from these tables, a new class only needs its tables.
+
+enum field_fmt_t
+{
+  FMT_DEC,          // %*u
+  FMT_HEX,          // 0x%0*x
+  FMT_BCD,          // %0*x
+  FMT_STRING,       // %*u then the string descriptor
+  FMT_CLASS,        // %*u then the class name, subclass and protocol follow the field
+  FMT_SUBCLASS,     // %*u then the subclass name, between class and protocol
+  FMT_PROTOCOL,     // %*u then the protocol name, after class and subclass
+  FMT_VENDOR,       // 0x%04x then the vendor name
+  FMT_PRODUCT,      // 0x%04x then the product name, idVendor precedes the field
+  FMT_EP_ADDRESS,   // 0x%02x then "EP n IN|OUT"
+  FMT_EP_ATTRIBUTES,// 0x%02x then transfer, synch and usage types
+  FMT_PACKET_SIZE,  // 0x%04x  1x %u bytes
+  FMT_CFG_ATTRIBUTES, // 0x%02x then the power lines, bMaxPower follows the field
+};
+
+struct desc_field_t
+{
+  uint8_t offset;
+  uint8_t size;     // bytes, little endian
+  uint8_t fmt;      // field_fmt_t
+  uint8_t width;    // columns (decimal) or digits (hex)
+  uint8_t column;   // text: the value starts this far from the indent
+  const char* name; // struct member, also the JSON key
+  void (*suffix)(uint32_t value) = nullptr; // text: printed after a FMT_DEC value
+};
+
+#define DESC_FIELD(type, member, fmt, width, column, ...) \
+  { offsetof(type, member), sizeof(type::member), fmt, width, column, #member, ##__VA_ARGS__ }
+
+void suffix_audio_subtype(uint32_t value) { out_char(' '); out_str(value == 1 ? "(HEADER)" : ""); }
+void suffix_midi_subtype(uint32_t value)  { out_str(" ("); out_str(midi_desc_subtype_to_string(value)); out_char(')'); }
+void suffix_jack_type(uint32_t value)     { out_char(' '); out_str(bJackType_to_string(value)); }
+
+constexpr desc_field_t device_fields[] = {
+  DESC_FIELD(tusb_desc_device_t, bLength,         FMT_DEC,      0, 20),
+  DESC_FIELD(tusb_desc_device_t, bDescriptorType, FMT_DEC,      0, 20),
+  DESC_FIELD(tusb_desc_device_t, bcdUSB,          FMT_BCD,      4, 20),
+  DESC_FIELD(tusb_desc_device_t, bDeviceClass,    FMT_CLASS,    0, 20),
+  DESC_FIELD(tusb_desc_device_t, bDeviceSubClass, FMT_SUBCLASS, 0, 20),
+  DESC_FIELD(tusb_desc_device_t, bDeviceProtocol, FMT_PROTOCOL, 0, 20),
+  DESC_FIELD(tusb_desc_device_t, bMaxPacketSize0, FMT_DEC,      0, 20),
+  DESC_FIELD(tusb_desc_device_t, idVendor,        FMT_VENDOR,   4, 20),
+  DESC_FIELD(tusb_desc_device_t, idProduct,       FMT_PRODUCT,  4, 20),
+  DESC_FIELD(tusb_desc_device_t, bcdDevice,       FMT_BCD,      4, 20),
+};
+
+// after the LANGIDs
+constexpr desc_field_t device_string_fields[] = {
+  DESC_FIELD(tusb_desc_device_t, iManufacturer,      FMT_STRING, 0, 20),
+  DESC_FIELD(tusb_desc_device_t, iProduct,           FMT_STRING, 0, 20),
+  DESC_FIELD(tusb_desc_device_t, iSerialNumber,      FMT_STRING, 0, 20),
+  DESC_FIELD(tusb_desc_device_t, bNumConfigurations, FMT_DEC,    0, 20),
+};
+
+constexpr desc_field_t config_fields[] = {
+  DESC_FIELD(tusb_desc_configuration_t, bLength,             FMT_DEC,            8, 20),
+  DESC_FIELD(tusb_desc_configuration_t, bDescriptorType,     FMT_DEC,            8, 20),
+  DESC_FIELD(tusb_desc_configuration_t, wTotalLength,        FMT_HEX,            4, 22),
+  DESC_FIELD(tusb_desc_configuration_t, bNumInterfaces,      FMT_DEC,            8, 20),
+  DESC_FIELD(tusb_desc_configuration_t, bConfigurationValue, FMT_DEC,            8, 20),
+  DESC_FIELD(tusb_desc_configuration_t, iConfiguration,      FMT_STRING,         8, 20),
+  DESC_FIELD(tusb_desc_configuration_t, bmAttributes,        FMT_CFG_ATTRIBUTES, 2, 24),
+};
+
+constexpr desc_field_t interface_fields[] = {
+  DESC_FIELD(tusb_desc_interface_t, bLength,            FMT_DEC,      8, 19),
+  DESC_FIELD(tusb_desc_interface_t, bDescriptorType,    FMT_DEC,      8, 19),
+  DESC_FIELD(tusb_desc_interface_t, bInterfaceNumber,   FMT_DEC,      8, 19),
+  DESC_FIELD(tusb_desc_interface_t, bAlternateSetting,  FMT_DEC,      8, 19),
+  DESC_FIELD(tusb_desc_interface_t, bNumEndpoints,      FMT_DEC,      8, 19),
+  DESC_FIELD(tusb_desc_interface_t, bInterfaceClass,    FMT_CLASS,    8, 19),
+  DESC_FIELD(tusb_desc_interface_t, bInterfaceSubClass, FMT_SUBCLASS, 8, 19),
+  DESC_FIELD(tusb_desc_interface_t, bInterfaceProtocol, FMT_PROTOCOL, 8, 19),
+  DESC_FIELD(tusb_desc_interface_t, iInterface,         FMT_STRING,   8, 19),
+};
+
+constexpr desc_field_t interface_assoc_fields[] = {
+  DESC_FIELD(tusb_desc_interface_assoc_t, bLength,           FMT_DEC,      2, 23),
+  DESC_FIELD(tusb_desc_interface_assoc_t, bDescriptorType,   FMT_DEC,      2, 23),
+  DESC_FIELD(tusb_desc_interface_assoc_t, bFirstInterface,   FMT_DEC,      2, 23),
+  DESC_FIELD(tusb_desc_interface_assoc_t, bInterfaceCount,   FMT_DEC,      2, 23),
+  DESC_FIELD(tusb_desc_interface_assoc_t, bFunctionClass,    FMT_CLASS,    2, 23),
+  DESC_FIELD(tusb_desc_interface_assoc_t, bFunctionSubClass, FMT_SUBCLASS, 2, 23),
+  DESC_FIELD(tusb_desc_interface_assoc_t, bFunctionProtocol, FMT_PROTOCOL, 2, 23),
+  DESC_FIELD(tusb_desc_interface_assoc_t, iFunction,         FMT_STRING,   2, 23),
+};
+
+constexpr desc_field_t endpoint_fields[] = {
+  DESC_FIELD(tusb_desc_endpoint_t, bLength,          FMT_DEC,           2, 16),
+  DESC_FIELD(tusb_desc_endpoint_t, bDescriptorType,  FMT_DEC,           2, 16),
+  DESC_FIELD(tusb_desc_endpoint_t, bEndpointAddress, FMT_EP_ADDRESS,    2, 17),
+  DESC_FIELD(tusb_desc_endpoint_t, bmAttributes,     FMT_EP_ATTRIBUTES, 2, 17),
+  DESC_FIELD(tusb_desc_endpoint_t, wMaxPacketSize,   FMT_PACKET_SIZE,   4, 17),
+  DESC_FIELD(tusb_desc_endpoint_t, bInterval,        FMT_DEC,           8, 16),
+};
+
+constexpr desc_field_t hid_fields[] = {
+  DESC_FIELD(tusb_hid_descriptor_hid_t, bLength,         FMT_DEC, 2, 16),
+  DESC_FIELD(tusb_hid_descriptor_hid_t, bDescriptorType, FMT_DEC, 2, 16),
+  DESC_FIELD(tusb_hid_descriptor_hid_t, bcdHID,          FMT_DEC, 3, 15),
+  DESC_FIELD(tusb_hid_descriptor_hid_t, bCountryCode,    FMT_DEC, 2, 16),
+  DESC_FIELD(tusb_hid_descriptor_hid_t, bNumDescriptors, FMT_DEC, 2, 16),
+  DESC_FIELD(tusb_hid_descriptor_hid_t, bReportType,     FMT_DEC, 2, 16),
+  DESC_FIELD(tusb_hid_descriptor_hid_t, wReportLength,   FMT_DEC, 2, 16),
+};
+
+constexpr desc_field_t audio_control_fields[] = {
+  DESC_FIELD(audio_desc_cs_ac_interface_t, bLength,            FMT_DEC, 3, 18),
+  DESC_FIELD(audio_desc_cs_ac_interface_t, bDescriptorType,    FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_ac_interface_t, bDescriptorSubType, FMT_DEC, 2, 19, suffix_audio_subtype),
+  DESC_FIELD(audio_desc_cs_ac_interface_t, bcdADC,             FMT_DEC, 3, 18),
+  DESC_FIELD(audio_desc_cs_ac_interface_t, bCategory,          FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_ac_interface_t, wTotalLength,       FMT_HEX, 4, 15),
+  DESC_FIELD(audio_desc_cs_ac_interface_t, bmControls,         FMT_DEC, 2, 19),
+};
+
+constexpr desc_field_t audio_streaming_fields[] = {
+  DESC_FIELD(audio_desc_cs_as_interface_t, bLength,            FMT_DEC, 3, 19),
+  DESC_FIELD(audio_desc_cs_as_interface_t, bDescriptorType,    FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_as_interface_t, bDescriptorSubType, FMT_DEC, 2, 19, suffix_audio_subtype),
+  DESC_FIELD(audio_desc_cs_as_interface_t, bTerminalLink,      FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_as_interface_t, bmControls,         FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_as_interface_t, bFormatType,        FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_as_interface_t, bmFormats,          FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_as_interface_t, bNrChannels,        FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_as_interface_t, bmChannelConfig,    FMT_DEC, 2, 19),
+  DESC_FIELD(audio_desc_cs_as_interface_t, iChannelNames,      FMT_DEC, 2, 19),
+};
+
+constexpr desc_field_t midi_header_fields[] = {
+  DESC_FIELD(midi_desc_header_t, bLength,            FMT_DEC, 2, 19),
+  DESC_FIELD(midi_desc_header_t, bDescriptorType,    FMT_DEC, 2, 19),
+  DESC_FIELD(midi_desc_header_t, bDescriptorSubType, FMT_DEC, 2, 19, suffix_midi_subtype),
+  DESC_FIELD(midi_desc_header_t, bcdMSC,             FMT_DEC, 2, 19),
+  DESC_FIELD(midi_desc_header_t, wTotalLength,       FMT_DEC, 2, 19),
+};
+
+constexpr desc_field_t midi_in_jack_fields[] = {
+  DESC_FIELD(midi_desc_in_jack_t, bLength,            FMT_DEC, 2, 19),
+  DESC_FIELD(midi_desc_in_jack_t, bDescriptorType,    FMT_DEC, 2, 19),
+  DESC_FIELD(midi_desc_in_jack_t, bDescriptorSubType, FMT_DEC, 2, 19, suffix_midi_subtype),
+  DESC_FIELD(midi_desc_in_jack_t, bJackType,          FMT_DEC, 2, 19, suffix_jack_type),
+  DESC_FIELD(midi_desc_in_jack_t, bJackID,            FMT_DEC, 2, 19),
+  DESC_FIELD(midi_desc_in_jack_t, iJack,              FMT_DEC, 2, 19),
+};
+
+constexpr desc_field_t midi_out_jack_fields[] = {
+  DESC_FIELD(midi_desc_out_jack_t, bLength,            FMT_DEC, 2, 20),
+  DESC_FIELD(midi_desc_out_jack_t, bDescriptorType,    FMT_DEC, 2, 20),
+  DESC_FIELD(midi_desc_out_jack_t, bDescriptorSubType, FMT_DEC, 2, 20, suffix_midi_subtype),
+  DESC_FIELD(midi_desc_out_jack_t, bJackType,          FMT_DEC, 2, 20, suffix_jack_type),
+  DESC_FIELD(midi_desc_out_jack_t, bJackID,            FMT_DEC, 2, 20),
+  DESC_FIELD(midi_desc_out_jack_t, bNrInputPins,       FMT_DEC, 2, 20),
+  DESC_FIELD(midi_desc_out_jack_t, baSourceID,         FMT_DEC, 2, 20),
+  DESC_FIELD(midi_desc_out_jack_t, baSourcePin,        FMT_DEC, 2, 20),
+  DESC_FIELD(midi_desc_out_jack_t, iJack,              FMT_DEC, 2, 20),
+};
+
+// class-specific endpoint, only the fields it shares with a jack
+constexpr desc_field_t midi_endpoint_fields[] = {
+  DESC_FIELD(midi_desc_in_jack_t, bLength,            FMT_DEC, 8, 19),
+  DESC_FIELD(midi_desc_in_jack_t, bDescriptorType,    FMT_DEC, 8, 19),
+  DESC_FIELD(midi_desc_in_jack_t, bDescriptorSubType, FMT_DEC, 8, 19),
+  DESC_FIELD(midi_desc_in_jack_t, bJackType,          FMT_DEC, 8, 19),
+  DESC_FIELD(midi_desc_in_jack_t, bJackID,            FMT_DEC, 8, 19),
+};
+
+constexpr desc_field_t cdc_header_fields[] = {
+  DESC_FIELD(cdc_desc_func_header_t, bcdCDC, FMT_BCD, 0, 15),
+};
+
+constexpr desc_field_t cdc_call_management_fields[] = {
+  DESC_FIELD(cdc_desc_func_call_management_t, bmCapabilities, FMT_HEX, 2, 15),
+  DESC_FIELD(cdc_desc_func_call_management_t, bDataInterface, FMT_DEC, 0, 18),
+};
+
+constexpr desc_field_t cdc_acm_fields[] = {
+  DESC_FIELD(cdc_desc_func_acm_t, bmCapabilities, FMT_HEX, 2, 15),
+};
+
+constexpr desc_field_t cdc_union_fields[] = {
+  DESC_FIELD(cdc_desc_func_union_t, bControlInterface,     FMT_HEX, 2, 22),
+  DESC_FIELD(cdc_desc_func_union_t, bSubordinateInterface, FMT_HEX, 2, 22),
+};
+
+
+// the fields are in descriptor order, don't overlap and fit in the struct
+template<size_t N>
+constexpr bool desc_schema_valid(const desc_field_t (&fields)[N], size_t struct_size)
+{
+  size_t end = 0;
+  for (size_t i = 0; i < N; i++) {
+    if (fields[i].offset < end || fields[i].size == 0 || fields[i].size > 4) return false;
+    end = fields[i].offset + fields[i].size;
+  }
+  return end <= struct_size;
+}
+
+static_assert(desc_schema_valid(device_fields, sizeof(tusb_desc_device_t)), "device_fields");
+static_assert(desc_schema_valid(device_string_fields, sizeof(tusb_desc_device_t)), "device_string_fields");
+static_assert(desc_schema_valid(config_fields, sizeof(tusb_desc_configuration_t)), "config_fields");
+static_assert(desc_schema_valid(interface_fields, sizeof(tusb_desc_interface_t)), "interface_fields");
+static_assert(desc_schema_valid(interface_assoc_fields, sizeof(tusb_desc_interface_assoc_t)), "interface_assoc_fields");
+static_assert(desc_schema_valid(endpoint_fields, sizeof(tusb_desc_endpoint_t)), "endpoint_fields");
+static_assert(desc_schema_valid(hid_fields, sizeof(tusb_hid_descriptor_hid_t)), "hid_fields");
+static_assert(desc_schema_valid(audio_control_fields, sizeof(audio_desc_cs_ac_interface_t)), "audio_control_fields");
+static_assert(desc_schema_valid(audio_streaming_fields, sizeof(audio_desc_cs_as_interface_t)), "audio_streaming_fields");
+static_assert(desc_schema_valid(midi_header_fields, sizeof(midi_desc_header_t)), "midi_header_fields");
+static_assert(desc_schema_valid(midi_in_jack_fields, sizeof(midi_desc_in_jack_t)), "midi_in_jack_fields");
+static_assert(desc_schema_valid(midi_out_jack_fields, sizeof(midi_desc_out_jack_t)), "midi_out_jack_fields");
+static_assert(desc_schema_valid(midi_endpoint_fields, sizeof(midi_desc_in_jack_t)), "midi_endpoint_fields");
+static_assert(desc_schema_valid(cdc_header_fields, sizeof(cdc_desc_func_header_t)), "cdc_header_fields");
+static_assert(desc_schema_valid(cdc_call_management_fields, sizeof(cdc_desc_func_call_management_t)), "cdc_call_management_fields");
+static_assert(desc_schema_valid(cdc_acm_fields, sizeof(cdc_desc_func_acm_t)), "cdc_acm_fields");
+static_assert(desc_schema_valid(cdc_union_fields, sizeof(cdc_desc_func_union_t)), "cdc_union_fields");
+
+
+uint32_t desc_field_value(const uint8_t* desc, uint8_t offset, uint8_t size)
+{
+  uint32_t value = 0;
+  for (uint8_t i = size; i > 0; i--) value = value << 8 | desc[offset + i - 1];
+  return value;
+}
 
-  printf("  Configuration Descriptor:\n");
-  printf("    bLength             %8d\n",        desc_cfg->bLength );
-  printf("    bDescriptorType     %8d\n",        desc_cfg->bDescriptorType );
-  printf("    wTotalLength          0x%04x\n",   desc_cfg->wTotalLength );
-  printf("    bNumInterfaces      %8d\n",        desc_cfg->bNumInterfaces );
-  printf("    bConfigurationValue %8d\n",        desc_cfg->bConfigurationValue );
-  printf("    iConfiguration      %8d\n",        desc_cfg->iConfiguration );
-  printf("    bmAttributes            0x%02x\n", desc_cfg->bmAttributes );
 
-  // bmAttributes: a device configuration that uses power from the bus and a local source reports a non-zero value
-  // in bMaxPower to indicate the amount of bus power required and sets bit 6.
-  // The actual power source at runtime can be determined using the GetStatus(DEVICE) request. If a device
-  // configuration supports remote wakeup, bit 5 is set to 1.
-  // Configuration characteristics:
-  //     bit 7: Reserved (must be set to one for historical reasons)
-  //     bit 6: Self-powered
-  //     bit 5: Remote Wakeup
-  //     bit 4...0: Reserved (reset to zero)
-  if( desc_cfg->bmAttributes & 0b01000000 ) {
-    printf ("      Self Powered\n");// bit 6: Self-powered
-    printf("    bMaxPower               %dmA\n",   desc_cfg->bMaxPower );
+// a field the device didn't send (past bLength) reads as whatever follows the descriptor
+bool desc_field_present(const uint8_t* desc, const desc_field_t& field)
+{
+  return field.offset + field.size <= desc[0];
+}
+
+
+void render_field(uint8_t daddr, const uint8_t* desc, const desc_field_t& field, const char* indent, const char* eol)
+{
+  uint32_t const value = desc_field_value(desc, field.offset, field.size);
+  out_str(indent);
+  out_str(field.name);
+  size_t name_len = strlen(field.name);
+  if (field.fmt == FMT_EP_ATTRIBUTES) { // lsusb heads the attribute lines with "bmAttributes:"
+    out_char(':');
+    name_len++;
   }
+  while (name_len++ < field.column) out_char(' ');
+  switch (field.fmt) {
+    case FMT_DEC:
+      out_dec(value, field.width);
+      if (field.suffix) field.suffix(value);
+      break;
+    case FMT_HEX:
+      out_str("0x");
+      out_hex(value, field.width);
+      break;
+    case FMT_BCD:
+      out_hex(value, field.width);
+      break;
+    case FMT_STRING:
+      out_dec(value, field.width);
+      out_char(' ');
+      print_string_descriptor(daddr, value);
+      break;
+    case FMT_CLASS:
+    case FMT_SUBCLASS:
+    case FMT_PROTOCOL: {
+      uint8_t const* triple = &desc[field.offset - (field.fmt - FMT_CLASS)];
+      auto class_sub_proto = get_class_sub_proto(triple[0], triple[1], triple[2]);
+      out_dec(value, field.width);
+      out_char(' ');
+      out_str(field.fmt == FMT_CLASS ? class_sub_proto.dev_class->name : field.fmt == FMT_SUBCLASS ? class_sub_proto.dev_subclass->name : class_sub_proto.dev_proto->name);
+    } break;
+    case FMT_VENDOR:
+    case FMT_PRODUCT: {
+      uint8_t const vendor_offset = field.fmt == FMT_VENDOR ? field.offset : field.offset - 2;
+      auto vid_pid = get_vid_pid(desc_field_value(desc, vendor_offset, 2), desc_field_value(desc, vendor_offset + 2, 2));
+      out_str("0x");
+      out_hex(value, field.width);
+      out_char(' ');
+      out_str(usb_ids_name(field.fmt == FMT_VENDOR ? vid_pid.vendor->name : vid_pid.product->name).c_str);
+    } break;
+    case FMT_EP_ADDRESS:
+      out_str("0x");
+      out_hex(value, field.width);
+      out_str(" EP ");
+      out_dec(value & 0x0f);
+      out_str(value & 0x80 ? " IN" : " OUT");
+      break;
+    case FMT_EP_ATTRIBUTES:
+      out_str("0x");
+      out_hex(value, field.width);
+      out_str(eol);
+      out_str(indent); out_str("  Transfer Type:   "); out_str(bmAttrXfer[value & 3]);       out_str(eol);
+      out_str(indent); out_str("  Synch Type:      "); out_str(bmAttrSync[(value >> 2) & 3]); out_str(eol);
+      out_str(indent); out_str("  Usage Type:      "); out_str(bmAttrUsage[(value >> 4) & 3]);
+      break;
+    case FMT_PACKET_SIZE:
+      out_str("0x");
+      out_hex(value, field.width);
+      out_str("  1x ");
+      out_dec(value);
+      out_str(" bytes");
+      break;
+    case FMT_CFG_ATTRIBUTES:
+      out_str("0x");
+      out_hex(value, field.width);
+      // bmAttributes: a device configuration that uses power from the bus and a local source reports a non-zero value
+      // in bMaxPower to indicate the amount of bus power required and sets bit 6.
+      // The actual power source at runtime can be determined using the GetStatus(DEVICE) request. If a device
+      // configuration supports remote wakeup, bit 5 is set to 1.
+      // Configuration characteristics:
+      //     bit 7: Reserved (must be set to one for historical reasons)
+      //     bit 6: Self-powered
+      //     bit 5: Remote Wakeup
+      //     bit 4...0: Reserved (reset to zero)
+      if (value & 0b01000000) {
+        out_str(eol); out_str(indent); out_str("  Self Powered");
+        out_str(eol); out_str(indent); out_str("bMaxPower               "); out_dec(desc[field.offset + 1]); out_str("mA");
+      }
+      if (value & 0b00100000) {
+        out_str(eol); out_str(indent); out_str("  Remote Wakeup");
+      }
+      break;
+    default: break;
+  }
+  out_str(eol);
+}
+
 
-  if( desc_cfg->bmAttributes & 0b00100000 )
-    printf ("      Remote Wakeup\n");// bit 5: Remote Wakeup
+// the fields the descriptor holds, a short one (bLength) ends early
+template<size_t N>
+void render_fields(uint8_t daddr, const void* desc, const desc_field_t (&fields)[N], const char* indent, const char* eol = "\n")
+{
+  for (auto& field : fields) {
+    if (!desc_field_present((const uint8_t*) desc, field)) break;
+    render_field(daddr, (const uint8_t*) desc, field, indent, eol);
+  }
+}
+
+
+// a JSON member for each field the descriptor holds, the raw numbers: names and
+// strings are left to the reader
+void render_fields_json(const void* desc, const desc_field_t* fields, size_t count)
+{
+  for (size_t i = 0; i < count; i++) {
+    if (!desc_field_present((const uint8_t*) desc, fields[i])) break;
+    json_uint(fields[i].name, desc_field_value((const uint8_t*) desc, fields[i].offset, fields[i].size));
+  }
+}
+
+
+template<size_t N>
+void render_fields_json(const void* desc, const desc_field_t (&fields)[N])
+{
+  render_fields_json(desc, fields, N);
+}
+
+
+// the binary form of a descriptor: the number of fields, then the value of each field the
+// descriptor holds in schema order, little endian and packed. 0 when out is too small
+template<size_t N>
+size_t desc_serialize(const void* desc, const desc_field_t (&fields)[N], uint8_t* out, size_t out_len)
+{
+  if (out_len == 0) return 0;
+  size_t len = 1;
+  uint8_t count = 0;
+  for (auto& field : fields) {
+    if (!desc_field_present((const uint8_t*) desc, field)) break;
+    if (len + field.size > out_len) return 0;
+    uint32_t const value = desc_field_value((const uint8_t*) desc, field.offset, field.size);
+    for (uint8_t i = 0; i < field.size; i++) out[len++] = (uint8_t)(value >> (8*i));
+    count++;
+  }
+  out[0] = count;
+  return len;
+}
+
+
+// desc_serialize() undone: the fields back at their offsets in desc (desc_size bytes, the
+// bytes no field covers are left as they are), the bytes of in used. 0 for a malformed input
+template<size_t N>
+size_t desc_deserialize(const uint8_t* in, size_t in_len, const desc_field_t (&fields)[N], void* desc, size_t desc_size)
+{
+  if (in_len == 0 || in[0] > N) return 0;
+  size_t len = 1;
+  for (uint8_t f = 0; f < in[0]; f++) {
+    const desc_field_t& field = fields[f];
+    if (len + field.size > in_len || field.offset + field.size > desc_size) return 0;
+    memcpy((uint8_t*) desc + field.offset, in + len, field.size); // both little endian
+    len += field.size;
+  }
+  return len;
+}
+
+
+void print_device_descriptor(uint8_t daddr)
+{
+  usb_device_t* dev = get_view(daddr);
+  if (dev == NULL) return;
+  tusb_desc_device_t const& desc = dev->desc;
+
+  out_str("Device "); out_dec(daddr); out_str(": ID "); out_hex(desc.idVendor, 4); out_char(':'); out_hex(desc.idProduct, 4); out_str("\r\n");
+  out_str("Device Descriptor:\r\n");
+  render_fields(daddr, &desc, device_fields, "  ", "\r\n");
+  for (uint8_t i=0; i<dev->langs.count; i++) {
+    out_str("  wLANGID             0x"); out_hex(dev->langs.langid[i], 4); out_char(' '); out_str(langid_to_string(dev->langs.langid[i])); out_str("\r\n");
+  }
+  render_fields(daddr, &desc, device_string_fields, "  ", "\r\n");
+  for (uint8_t i=0; i<dev->config_count; i++) {
+    parse_config_descriptor(daddr, (tusb_desc_configuration_t*) dev->configs[i].desc, dev->configs[i].len);
+  }
+  out_flush();
+}
+
+
+void print_hid_dev_descriptor( tusb_hid_descriptor_hid_t const * desc_hid )
+{
+  out_str("        HID Device Descriptor:\n");
+  render_fields(0, desc_hid, hid_fields, "          ");
+}
+
+
+
+void print_interface_descriptor(uint8_t dev_addr, tusb_desc_interface_t const* desc_itf )
+{
+  out_str("    Interface Descriptor #"); out_dec(desc_itf->bInterfaceNumber); out_str(":\n");
+  render_fields(dev_addr, desc_itf, interface_fields, "      ");
+}
+
+
+void print_interface_association(uint8_t dev_addr, tusb_desc_interface_assoc_t const* desc_assoc )
+{
+  out_str("    Interface Association:\n");
+  render_fields(dev_addr, desc_assoc, interface_assoc_fields, "      ");
+}
+
+
+void print_endpoint_descriptor( tusb_desc_endpoint_t const* cdc_edp, const char* prefix="", const char* spacing="      " )
+{
+  out_str(spacing); out_str(prefix); out_str(" Endpoint Descriptor:\n");
+  char indent[16];
+  snprintf(indent, sizeof(indent), "%s  ", spacing);
+  render_fields(0, cdc_edp, endpoint_fields, indent);
+}
+
+
+
+void print_config_descriptor(uint8_t dev_addr, tusb_desc_configuration_t const* desc_cfg)
+{
+  out_str("  Configuration Descriptor:\n");
+  render_fields(dev_addr, desc_cfg, config_fields, "    ");
 }
 
 
@@ -336,14 +1635,22 @@ void print_config_descriptor( tusb_desc_configuration_t const* desc_cfg)
 
 
 // simple configuration parser
-void parse_config_descriptor(uint8_t dev_addr, tusb_desc_configuration_t const* desc_cfg)
+// len bounds the parsing when less than wTotalLength bytes were received
+void parse_config_descriptor(uint8_t dev_addr, tusb_desc_configuration_t const* desc_cfg, uint16_t len)
 {
-  uint8_t const* desc_end = ((uint8_t const*) desc_cfg) + tu_le16toh(desc_cfg->wTotalLength);
+  uint16_t const total_len = tu_le16toh(desc_cfg->wTotalLength);
+  uint8_t const* desc_end = ((uint8_t const*) desc_cfg) + (total_len < len ? total_len : len);
   uint8_t const* p_desc   = tu_desc_next(desc_cfg);
 
-  print_config_descriptor( desc_cfg );
+  print_config_descriptor( dev_addr, desc_cfg );
 
   // parse each interfaces
+  if( len < total_len ) { // drop the partial descriptor at the end
+    uint8_t const* p_last = p_desc;
+    while( p_last + 2 <= desc_end && tu_desc_len(p_last) >= 2 && p_last + tu_desc_len(p_last) <= desc_end ) p_last = tu_desc_next(p_last);
+    desc_end = p_last;
+  }
+
   while( p_desc < desc_end ) {
     uint8_t assoc_itf_count = 1;
     tusb_desc_interface_assoc_t* desc_assoc = nullptr;
@@ -356,12 +1663,16 @@ void parse_config_descriptor(uint8_t dev_addr, tusb_desc_configuration_t const*
     }
 
     // must be interface from now
-    if( TUSB_DESC_INTERFACE != tu_desc_type(p_desc) ) return;
+    if( p_desc + sizeof(tusb_desc_interface_t) > desc_end || TUSB_DESC_INTERFACE != tu_desc_type(p_desc) ) return;
     auto desc_itf = (tusb_desc_interface_t const*) p_desc;
     print_interface_descriptor( dev_addr, desc_itf );
     uint16_t const drv_len = count_interface_total_len(desc_itf, assoc_itf_count, (uint16_t) (desc_end-p_desc));
     if(drv_len < sizeof(tusb_desc_interface_t)) { // probably corrupted descriptor
-      printf("      ***CORRUPTED DESCRIPTOR\n");
+      out_str("      ***CORRUPTED DESCRIPTOR\n");
+      return;
+    }
+    if( len < total_len && p_desc + drv_len >= desc_end ) { // the class parsers expect whole interfaces
+      out_str("      ***TRUNCATED DESCRIPTOR\n");
       return;
     }
 
@@ -400,7 +1711,6 @@ void parse_config_descriptor(uint8_t dev_addr, tusb_desc_configuration_t const*
 
 void parse_audio_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, uint16_t max_len)
 {
-  (void)daddr;
   (void)max_len;
   uint8_t const *p_desc = (uint8_t const *) desc_itf;
   // get first descriptor
@@ -409,40 +1719,21 @@ void parse_audio_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf,
   switch( desc_itf->bInterfaceSubClass ) {
     case AUDIO_SUBCLASS_CONTROL: {
       auto ac = (audio_desc_cs_ac_interface_t*) p_desc;
-      printf("      AudioControl Interface Descriptor (control)\n");
-      printf("        bLength           %3d\n",     ac->bLength ); ///< Size of this descriptor in bytes: 9.
-      printf("        bDescriptorType    %2d\n",    ac->bDescriptorType ); ///< Descriptor Type. Value: TUSB_DESC_CS_INTERFACE.
-      printf("        bDescriptorSubType %2d %s\n", ac->bDescriptorSubType, ac->bDescriptorSubType==1?"(HEADER)":"" ); ///< Descriptor SubType.
-      printf("        bcdADC            %3d\n",     ac->bcdADC ); ///< Audio Device Class Specification Release Number in Binary-Coded Decimal. Value: U16_TO_U8S_LE(0x0200).
-      printf("        bCategory          %2d\n",    ac->bCategory ); ///< Constant, indicating the primary use of this audio function, as intended by the manufacturer.
-      printf("        wTotalLength   0x%04x\n",     ac->wTotalLength ); ///< Total number of bytes returned for the class-specific descriptor
-      printf("        bmControls         %2d\n",    ac->bmControls ); ///< See: audio_cs_ac_interface_control_pos_t.
+      out_str("      AudioControl Interface Descriptor (control)\n");
+      render_fields(daddr, ac, audio_control_fields, "        ");
     } break;
     case AUDIO_SUBCLASS_STREAMING: {
       auto as = (audio_desc_cs_as_interface_t*) p_desc;
-      printf("      AudioControl Interface Descriptor (stream):\n");
-      printf("        bLength            %3d\n",    as->bLength            ); ///< Size of this descriptor, in bytes: 16.
-      printf("        bDescriptorType    %2d\n",    as->bDescriptorType    ); ///< Descriptor Type. Value: TUSB_DESC_CS_INTERFACE.
-      printf("        bDescriptorSubType %2d %s\n", as->bDescriptorSubType, as->bDescriptorSubType==1?"(HEADER)":"" ); ///< Descriptor SubType.
-      printf("        bTerminalLink      %2d\n",    as->bTerminalLink      ); ///< The Terminal ID of the Terminal to which this interface is connected.
-      printf("        bmControls         %2d\n",    as->bmControls         ); ///< See: audio_cs_as_interface_control_pos_t.
-      printf("        bFormatType        %2d\n",    as->bFormatType        ); ///< Constant identifying the Format Type the AudioStreaming interface is using.
-      printf("        bmFormats          %2lu\n",    as->bmFormats          ); ///< The Audio Data Format(s) that can be used to communicate with this interface.
-      printf("        bNrChannels        %2d\n",    as->bNrChannels        ); ///< Number of physical channels in the AS Interface audio channel cluster.
-      printf("        bmChannelConfig    %2lu\n",    as->bmChannelConfig    ); ///< Describes the spatial location of the physical channels. See: audio_channel_config_t.
-      printf("        iChannelNames      %2d\n",    as->iChannelNames      ); ///< Index of a string descriptor, describing the name of the first physical channel.
+      out_str("      AudioControl Interface Descriptor (stream):\n");
+      render_fields(daddr, as, audio_streaming_fields, "        ");
     } break;
     case AUDIO_SUBCLASS_MIDI_STREAMING: {
       auto midi_header = (midi_desc_header_t*) p_desc;
       auto descType = midi_header->bDescriptorType;
       if( midi_header->bDescriptorSubType != MIDI_CS_INTERFACE_HEADER ) return;
       int to_read = midi_header->wTotalLength - midi_header->bLength;
-      printf("      MIDIStreaming Interface Descriptor (head):\n");
-      printf("        bLength            %2d\n",      midi_header->bLength            ); ///< Size of this descriptor in bytes.
-      printf("        bDescriptorType    %2d\n",      midi_header->bDescriptorType    ); ///< Descriptor Type, must be Class-Specific
-      printf("        bDescriptorSubType %2d (%s)\n", midi_header->bDescriptorSubType, midi_desc_subtype_to_string(midi_header->bDescriptorSubType) );
-      printf("        bcdMSC             %2d\n",      midi_header->bcdMSC             ); ///< MidiStreaming SubClass release number in Binary-Coded Decimal
-      printf("        wTotalLength       %2d\n",      midi_header->wTotalLength       );
+      out_str("      MIDIStreaming Interface Descriptor (head):\n");
+      render_fields(daddr, midi_header, midi_header_fields, "        ");
 
       do {
         p_desc = tu_desc_next(midi_header);
@@ -452,31 +1743,18 @@ void parse_audio_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf,
             case MIDI_CS_INTERFACE_IN_JACK: {
                 auto midi_in_jack = (midi_desc_in_jack_t*)midi_header;
                 to_read -= midi_in_jack->bLength;
-                printf("      MIDIStreaming Interface Descriptor (IN):\n");
-                printf("        bLength            %2d\n",      midi_in_jack->bLength            ); ///< Size of this descriptor in bytes.
-                printf("        bDescriptorType    %2d\n",      midi_in_jack->bDescriptorType    ); ///< Descriptor Type, must be Class-Specific
-                printf("        bDescriptorSubType %2d (%s)\n", midi_in_jack->bDescriptorSubType, midi_desc_subtype_to_string(midi_in_jack->bDescriptorSubType) );
-                printf("        bJackType          %2d %s\n",   midi_in_jack->bJackType, bJackType_to_string(midi_in_jack->bJackType) );
-                printf("        bJackID            %2d\n",      midi_in_jack->bJackID            ); ///< Unique ID for MIDI IN Jack
-                printf("        iJack              %2d\n",      midi_in_jack->iJack              ); ///< string descriptor
+                out_str("      MIDIStreaming Interface Descriptor (IN):\n");
+                render_fields(daddr, midi_in_jack, midi_in_jack_fields, "        ");
             } break;
             case MIDI_CS_INTERFACE_OUT_JACK: {
                 auto midi_out_jack = (midi_desc_out_jack_t*)midi_header;
                 to_read -= midi_out_jack->bLength;
-                printf("      MIDIStreaming Interface Descriptor (OUT):\n");
-                printf("        bLength             %2d\n",      midi_out_jack->bLength            ); ///< Size of this descriptor in bytes.
-                printf("        bDescriptorType     %2d\n",      midi_out_jack->bDescriptorType    ); ///< Descriptor Type, must be Class-Specific
-                printf("        bDescriptorSubType  %2d (%s)\n", midi_out_jack->bDescriptorSubType, midi_desc_subtype_to_string(midi_out_jack->bDescriptorSubType) );
-                printf("        bJackType           %2d %s\n",   midi_out_jack->bJackType, bJackType_to_string(midi_out_jack->bJackType) );
-                printf("        bJackID             %2d\n",      midi_out_jack->bJackID            ); ///< Unique ID for MIDI IN Jack
-                printf("        bNrInputPins        %2d\n",      midi_out_jack->bNrInputPins       );
-                printf("        baSourceID          %2d\n",      midi_out_jack->baSourceID         );
-                printf("        baSourcePin         %2d\n",      midi_out_jack->baSourcePin        );
-                printf("        iJack               %2d\n",      midi_out_jack->iJack              ); ///< string descriptor
+                out_str("      MIDIStreaming Interface Descriptor (OUT):\n");
+                render_fields(daddr, midi_out_jack, midi_out_jack_fields, "        ");
             } break;
             default:
             to_read = 0;
-            printf("      [ERROR] Unhandled bDescriptorSubType: %d\n", midi_header->bDescriptorSubType );
+            out_str("      [ERROR] Unhandled bDescriptorSubType: "); out_dec(midi_header->bDescriptorSubType); out_char('\n');
             return;
             break;
           }
@@ -489,30 +1767,15 @@ void parse_audio_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf,
           } else {
             bEndpointAddress_t edp = {desc_ep->bEndpointAddress};
 
-            if( edp.bits.dir==1 ) {
-              auto desc_in = (midi_desc_in_jack_t*)p_desc;
-              printf("      MIDIStreaming Endpoint Descriptor (IN):\n");
-              printf("        bLength            %8d\n", desc_in->bLength);
-              printf("        bDescriptorType    %8d\n", desc_in->bDescriptorType);
-              printf("        bDescriptorSubType %8d\n", desc_in->bDescriptorSubType);
-              printf("        bJackType          %8d\n", desc_in->bJackType);
-              printf("        bJackID            %8d\n", desc_in->bJackID);
-            } else {
-              auto desc_out = (midi_desc_out_jack_t*)p_desc;
-              printf("      MIDIStreaming Endpoint Descriptor (OUT):\n");
-              printf("        bLength            %8d\n", desc_out->bLength);
-              printf("        bDescriptorType    %8d\n", desc_out->bDescriptorType);
-              printf("        bDescriptorSubType %8d\n", desc_out->bDescriptorSubType);
-              printf("        bJackType          %8d\n", desc_out->bJackType);
-              printf("        bJackID            %8d\n", desc_out->bJackID);
-            }
+            out_str(edp.bits.dir==1 ? "      MIDIStreaming Endpoint Descriptor (IN):\n" : "      MIDIStreaming Endpoint Descriptor (OUT):\n");
+            render_fields(daddr, p_desc, midi_endpoint_fields, "        ");
           }
         }
 
       } while( to_read > 0 );
     } break; // end case AUDIO_SUBCLASS_MIDI_STREAMING
     default:
-      printf("      [ERROR] Bad Interface SubClass: %d\n", desc_itf->bInterfaceSubClass );
+      out_str("      [ERROR] Bad Interface SubClass: "); out_dec(desc_itf->bInterfaceSubClass); out_char('\n');
     break;
   } // end switch( desc_itf->bInterfaceSubClass )
 }
@@ -522,54 +1785,63 @@ void parse_audio_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf,
 
 void parse_cdc_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, tusb_desc_interface_assoc_t* desc_assoc, uint16_t max_len)
 {
-  (void)daddr;
-  (void)max_len;
-  uint8_t const *p_desc = (uint8_t const *) desc_itf;
-  auto desc_generic = (tusb_desc_endpoint_t const *) p_desc;
-  p_desc += desc_generic->bLength;
-
-  auto cdc_header = (cdc_desc_func_header_t*) p_desc;
-  printf("      CDC Header:\n");
-  printf("        bcdCDC         %x\n", cdc_header->bcdCDC);
-  p_desc += sizeof(cdc_desc_func_header_t);
-
-  auto cdc_cm = (cdc_desc_func_call_management_t*) p_desc;
-  printf("      CDC Call Management:\n");
-  printf("        bmCapabilities 0x%02x\n", cdc_cm->bmCapabilities); // see cdc_desc_func_call_management_t::bmCapabilities
-  printf("        bDataInterface    %d\n", cdc_cm->bDataInterface);
-  p_desc += sizeof(cdc_desc_func_call_management_t);
-
-  auto cdc_acm = (cdc_desc_func_acm_t*) p_desc;
-  printf("      CDC ACM:\n");
-  // see cdc_acm_capability_t ( props=support_comm_request, support_line_request, support_send_break, support_notification_network_connection)
-  printf("        bmCapabilities 0x%02x\n", cdc_acm->bmCapabilities);
-  if( cdc_acm->bmCapabilities.support_comm_request )
-    printf("          communication requests\n");
-  if( cdc_acm->bmCapabilities.support_line_request )
-    printf("          line coding and serial state\n");
-  if( cdc_acm->bmCapabilities.support_send_break )
-    printf("          send break\n");
-  if( cdc_acm->bmCapabilities.support_notification_network_connection )
-    printf("          notifications for network connections\n");
-  p_desc += sizeof(cdc_desc_func_acm_t);
-
-  auto cdc_union = (cdc_desc_func_union_t*) p_desc;
-  printf("      CDC Union:\n");
-  printf("        bControlInterface     0x%02x\n", cdc_union->bControlInterface);
-  printf("        bSubordinateInterface 0x%02x\n", cdc_union->bSubordinateInterface);
-
-  p_desc += sizeof(cdc_desc_func_union_t);
-  auto cdc_edp = (tusb_desc_endpoint_t*) p_desc;
-  if( cdc_edp->bLength == 0 ) return;
-
-  print_endpoint_descriptor( cdc_edp );
-  p_desc += cdc_edp->bLength;
-
-  auto cdc_itf = (tusb_desc_interface_t*) p_desc;
-  print_interface_descriptor( daddr, cdc_itf );
-
-  uint16_t const cdc_itf_len = count_interface_total_len(cdc_itf, desc_assoc->bInterfaceCount, cdc_itf->bLength);
-  parse_generic_interface( daddr, cdc_itf, cdc_itf_len );
+  // functional descriptors come in any order and number, each is picked by its subtype
+  uint8_t const *desc_end = ((uint8_t const *) desc_itf) + max_len;
+  uint8_t const *p_desc = tu_desc_next(desc_itf);
+
+  while( p_desc + 2 <= desc_end && tu_desc_len(p_desc) >= 2 && p_desc + tu_desc_len(p_desc) <= desc_end ) {
+    uint8_t const len = tu_desc_len(p_desc);
+    switch( tu_desc_type(p_desc) ) {
+      case TUSB_DESC_CS_INTERFACE:
+        switch( len >= 3 ? p_desc[2] : 0xff ) { // bDescriptorSubtype
+          case CDC_FUNC_DESC_HEADER:
+            out_str("      CDC Header:\n");
+            render_fields(daddr, p_desc, cdc_header_fields, "        ");
+          break;
+          case CDC_FUNC_DESC_CALL_MANAGEMENT:
+            out_str("      CDC Call Management:\n");
+            render_fields(daddr, p_desc, cdc_call_management_fields, "        "); // see cdc_desc_func_call_management_t::bmCapabilities
+          break;
+          case CDC_FUNC_DESC_ABSTRACT_CONTROL_MANAGEMENT: {
+            auto cdc_acm = (cdc_desc_func_acm_t const*) p_desc;
+            out_str("      CDC ACM:\n");
+            // see cdc_acm_capability_t ( props=support_comm_request, support_line_request, support_send_break, support_notification_network_connection)
+            render_fields(daddr, p_desc, cdc_acm_fields, "        ");
+            if( len < sizeof(cdc_desc_func_acm_t) ) break;
+            if( cdc_acm->bmCapabilities.support_comm_request )
+              out_str("          communication requests\n");
+            if( cdc_acm->bmCapabilities.support_line_request )
+              out_str("          line coding and serial state\n");
+            if( cdc_acm->bmCapabilities.support_send_break )
+              out_str("          send break\n");
+            if( cdc_acm->bmCapabilities.support_notification_network_connection )
+              out_str("          notifications for network connections\n");
+          } break;
+          case CDC_FUNC_DESC_UNION:
+            out_str("      CDC Union:\n");
+            render_fields(daddr, p_desc, cdc_union_fields, "        ");
+          break;
+          default:
+            out_str("      UNRECOGNIZED CDC:");
+            for( uint8_t i = 0; i < len; i++ ) { out_char(' '); out_hex(p_desc[i], 2); }
+            out_char('\n');
+          break;
+        }
+      break;
+      case TUSB_DESC_ENDPOINT:
+        print_endpoint_descriptor( (tusb_desc_endpoint_t const*) p_desc );
+      break;
+      case TUSB_DESC_INTERFACE: {
+        // the data interface, only within the range of an IAD, else the caller gets to it
+        if( desc_assoc == NULL || len < sizeof(tusb_desc_interface_t) ) return;
+        auto cdc_itf = (tusb_desc_interface_t const*) p_desc;
+        print_interface_descriptor( daddr, cdc_itf );
+        parse_generic_interface( daddr, cdc_itf, (uint16_t) (desc_end - p_desc) );
+      } return;
+      default: break;
+    }
+    p_desc += len;
+  }
 }
 
 
@@ -616,6 +1888,7 @@ void parse_generic_interface(uint8_t daddr, tusb_desc_interface_t const *desc_it
 }
 
 
+// IN endpoints are opened by core1 (enum_listen_hid), this only prints
 void parse_hid_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, uint16_t max_len)
 {
   (void)daddr;
@@ -623,7 +1896,7 @@ void parse_hid_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, u
   uint16_t const drv_len = (uint16_t) (sizeof(tusb_desc_interface_t) + sizeof(tusb_hid_descriptor_hid_t) + desc_itf->bNumEndpoints * sizeof(tusb_desc_endpoint_t));
   // corrupted descriptor
   if (max_len < drv_len) {
-    printf("        [ERROR] Len overflow\n");
+    out_str("        [ERROR] Len overflow\n");
     return;
   }
   uint8_t const *p_desc = (uint8_t const *) desc_itf;
@@ -631,7 +1904,7 @@ void parse_hid_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, u
   p_desc = tu_desc_next(p_desc);
   auto desc_hid = (tusb_hid_descriptor_hid_t const *) p_desc;
   if(HID_DESC_TYPE_HID != desc_hid->bDescriptorType) {
-    printf("        [ERROR] Not HID Type\n");
+    out_str("        [ERROR] Not HID Type\n");
     return;
   }
 
@@ -642,43 +1915,210 @@ void parse_hid_interface(uint8_t daddr, tusb_desc_interface_t const *desc_itf, u
   auto desc_ep = (tusb_desc_endpoint_t const *) p_desc;
   for(int i = 0; i < desc_itf->bNumEndpoints; i++) {
     if (TUSB_DESC_ENDPOINT != desc_ep->bDescriptorType) {
-      printf("        [ERROR] Bad endpoint type\n");
+      out_str("        [ERROR] Bad endpoint type\n");
       return;
     }
 
     print_endpoint_descriptor( desc_ep, "HID" );
+    p_desc = tu_desc_next(p_desc);
+    desc_ep = (tusb_desc_endpoint_t const *) p_desc;
+  }
+}
 
-    if(tu_edpt_dir(desc_ep->bEndpointAddress) == TUSB_DIR_IN) {
-      // skip if failed to open endpoint
-      if ( ! tuh_edpt_open(daddr, desc_ep) ) {
-        printf("        [ERROR] Failed to open endpoint\n");
-        return;
+
+
+
+//--------------------------------------------------------------------+
+// JSON Lines output, from the same schemas as the text dump
+//--------------------------------------------------------------------+
+
+struct desc_schema_t
+{
+  const char* type;
+  const desc_field_t* fields;
+  size_t count;
+};
+
+#define DESC_SCHEMA(type, fields) desc_schema_t{ type, fields, sizeof(fields)/sizeof(fields[0]) }
+
+
+// the schema of a descriptor found in a configuration, by the interface it belongs to
+desc_schema_t json_descriptor_schema(const uint8_t* desc, uint8_t itf_class, uint8_t itf_subclass)
+{
+  uint8_t const subtype = desc[0] > 2 ? desc[2] : 0;
+  switch (desc[1]) {
+    case TUSB_DESC_INTERFACE:             return DESC_SCHEMA("interface", interface_fields);
+    case TUSB_DESC_ENDPOINT:              return DESC_SCHEMA("endpoint", endpoint_fields);
+    case TUSB_DESC_INTERFACE_ASSOCIATION: return DESC_SCHEMA("interface_association", interface_assoc_fields);
+    case HID_DESC_TYPE_HID:
+      if (itf_class == TUSB_CLASS_HID) return DESC_SCHEMA("hid", hid_fields);
+      break;
+    case TUSB_DESC_CS_INTERFACE:
+      if (itf_class == TUSB_CLASS_AUDIO && itf_subclass == AUDIO_SUBCLASS_CONTROL && subtype == 1 /*HEADER*/) return DESC_SCHEMA("audio_control_header", audio_control_fields);
+      if (itf_class == TUSB_CLASS_AUDIO && itf_subclass == AUDIO_SUBCLASS_STREAMING && subtype == 1 /*AS_GENERAL*/) return DESC_SCHEMA("audio_streaming_general", audio_streaming_fields);
+      if (itf_class == TUSB_CLASS_AUDIO && itf_subclass == AUDIO_SUBCLASS_MIDI_STREAMING) {
+        if (subtype == MIDI_CS_INTERFACE_HEADER)   return DESC_SCHEMA("midi_header", midi_header_fields);
+        if (subtype == MIDI_CS_INTERFACE_IN_JACK)  return DESC_SCHEMA("midi_in_jack", midi_in_jack_fields);
+        if (subtype == MIDI_CS_INTERFACE_OUT_JACK) return DESC_SCHEMA("midi_out_jack", midi_out_jack_fields);
       }
-      uint8_t* buf = get_hid_buf(daddr);
-      if (!buf) {
-        printf("        [ERROR] OOM\n");
-        return; // out of memory
+      if (itf_class == TUSB_CLASS_CDC) {
+        if (subtype == 0 /*HEADER*/)                      return DESC_SCHEMA("cdc_header", cdc_header_fields);
+        if (subtype == 1 /*CALL_MANAGEMENT*/)             return DESC_SCHEMA("cdc_call_management", cdc_call_management_fields);
+        if (subtype == 2 /*ABSTRACT_CONTROL_MANAGEMENT*/) return DESC_SCHEMA("cdc_acm", cdc_acm_fields);
+        if (subtype == 6 /*UNION*/)                       return DESC_SCHEMA("cdc_union", cdc_union_fields);
       }
+      break;
+    case TUSB_DESC_CS_ENDPOINT:
+      if (itf_class == TUSB_CLASS_AUDIO && itf_subclass == AUDIO_SUBCLASS_MIDI_STREAMING) return DESC_SCHEMA("midi_endpoint", midi_endpoint_fields);
+      break;
+    default: break;
+  }
+  return desc_schema_t{ nullptr, nullptr, 0 };
+}
 
-      #pragma GCC diagnostic push
-      #pragma GCC diagnostic ignored "-Wmissing-field-initializers"
-      tuh_xfer_t xfer =
-      {
-        .daddr       = daddr,
-        .ep_addr     = desc_ep->bEndpointAddress,
-        .buflen      = 64,
-        .buffer      = buf,
-        .complete_cb = hid_report_received,
-        .user_data   = (uintptr_t) buf, // since buffer is not available in callback, use user data to store the buffer
-      };
-      #pragma GCC diagnostic pop
-      // submit transfer for this EP
-      tuh_edpt_xfer(&xfer);
-      printf("        Listen to [dev %u: ep %02x]\r\n", daddr, desc_ep->bEndpointAddress);
 
+// every descriptor after the configuration header, a descriptor without a schema as raw bytes
+void json_config(const tusb_desc_configuration_t* desc_cfg, uint16_t len)
+{
+  uint16_t const total_len = tu_le16toh(desc_cfg->wTotalLength);
+  uint8_t const* p_desc   = (uint8_t const*) desc_cfg;
+  uint8_t const* desc_end = p_desc + (total_len < len ? total_len : len);
+  uint8_t itf_class = 0, itf_subclass = 0;
+
+  json_object_begin();
+  render_fields_json(desc_cfg, config_fields);
+  json_uint("bMaxPower", desc_cfg->bMaxPower);
+  json_array_begin("descriptors");
+  for (p_desc = tu_desc_next(p_desc); p_desc + 2 <= desc_end && tu_desc_len(p_desc) >= 2 && p_desc + tu_desc_len(p_desc) <= desc_end; p_desc = tu_desc_next(p_desc)) {
+    if (tu_desc_type(p_desc) == TUSB_DESC_INTERFACE && tu_desc_len(p_desc) >= sizeof(tusb_desc_interface_t)) {
+      itf_class    = ((tusb_desc_interface_t const*) p_desc)->bInterfaceClass;
+      itf_subclass = ((tusb_desc_interface_t const*) p_desc)->bInterfaceSubClass;
     }
-    p_desc = tu_desc_next(p_desc);
-    desc_ep = (tusb_desc_endpoint_t const *) p_desc;
+    desc_schema_t const schema = json_descriptor_schema(p_desc, itf_class, itf_subclass);
+    json_object_begin();
+    if (schema.type) {
+      json_string("type", schema.type);
+      render_fields_json(p_desc, schema.fields, schema.count);
+    } else {
+      json_uint("bDescriptorType", tu_desc_type(p_desc));
+      json_hex("raw", p_desc, tu_desc_len(p_desc));
+    }
+    json_object_end();
   }
+  json_array_end();
+  json_object_end();
 }
 
+
+// the members describing a device, from its rendered copy
+void json_device(uint8_t daddr)
+{
+  usb_device_t* dev = get_view(daddr);
+  if (dev == NULL) return;
+  json_object_begin("device");
+  render_fields_json(&dev->desc, device_fields);
+  render_fields_json(&dev->desc, device_string_fields);
+  json_object_end();
+  json_array_begin("langids");
+  for (uint8_t i=0; i<dev->langs.count; i++) json_uint(nullptr, dev->langs.langid[i]);
+  json_array_end();
+  json_array_begin("strings");
+  for (uint8_t i=0; i<dev->string_count; i++) {
+    if (!dev->strings[i].valid) continue;
+    json_object_begin();
+    json_uint("index", dev->strings[i].index);
+    json_string("value", dev->strings[i].utf8);
+    json_object_end();
+  }
+  json_array_end();
+  json_array_begin("configs");
+  for (uint8_t i=0; i<dev->config_count; i++) {
+    json_config((tusb_desc_configuration_t*) dev->configs[i].desc, dev->configs[i].len);
+  }
+  json_array_end();
+}
+
+
+// core0: an event, once applied, as one JSON line
+void event_render_json(const event_header_t* header, const uint8_t* payload)
+{
+  static const char* const event_names[] = {
+    "mount", "unmount", nullptr, nullptr, nullptr, "device", "log", "hid_mount", "hid_unmount", "hid_report",
+  };
+  static const char* const end_kinds[] = { "enumerated", "cached" };
+  static const char* const log_msgs[] = {
+    "device_failed", "cfg_truncated", "cache_stale", "cache_new_serial", "cache_other_unit", "cache_verified",
+    "cache_saved", "hid_receive_failed", "hid_report_failed", "ep_listen", "ep_open_failed", "ep_no_buffer",
+  };
+  uint8_t const daddr = header->daddr;
+  uint16_t const len  = header->len;
+  usb_device_t* view  = get_view(daddr);
+  // the snapshot events are only rendered as a whole, with EVT_DEVICE_END
+  if (header->type >= sizeof(event_names)/sizeof(event_names[0]) || event_names[header->type] == nullptr) return;
+
+  json_line_begin();
+  json_string("event", event_names[header->type]);
+  json_uint("daddr", daddr);
+  json_uint("us", header->us);
+  switch (header->type) {
+    case EVT_MOUNT:
+      if (view == NULL) break;
+      json_uint("rhport", view->rhport);
+      json_uint("hub_addr", view->hub_addr);
+      json_uint("hub_port", view->hub_port);
+      json_string("speed", speed_to_string(view->speed));
+      break;
+    case EVT_DEVICE_END:
+      if (len >= sizeof(event_device_end_t)) {
+        event_device_end_t end;
+        memcpy(&end, payload, sizeof(end));
+        json_string("end", end.kind < sizeof(end_kinds)/sizeof(end_kinds[0]) ? end_kinds[end.kind] : "");
+        if (end.kind == END_ENUMERATED) {
+          json_uint("enum_us", end.us);
+          json_uint("xfers", end.xfers);
+        }
+      }
+      json_device(daddr);
+      break;
+    case EVT_LOG:
+      if (len < sizeof(event_log_t)) break;
+      {
+        event_log_t log;
+        memcpy(&log, payload, sizeof(log));
+        json_string("msg", log.msg < sizeof(log_msgs)/sizeof(log_msgs[0]) ? log_msgs[log.msg] : "");
+        json_array_begin("args");
+        for (auto arg : log.args) json_uint(nullptr, arg);
+        json_array_end();
+        if (len > sizeof(event_log_t)) json_string("str", (const char*) payload + sizeof(event_log_t), len - sizeof(event_log_t));
+      }
+      break;
+    case EVT_HID_MOUNT:
+      if (len < 2) break;
+      json_uint("instance", payload[0]);
+      json_uint("protocol", payload[1]);
+      if (payload[1] == HID_ITF_PROTOCOL_NONE && view != NULL && payload[0] < CFG_TUH_HID) {
+        auto hid = &view->hid[payload[0]];
+        json_array_begin("reports");
+        for (uint8_t i=0; i<hid->report_count; i++) {
+          json_object_begin();
+          json_uint("report_id", hid->report_info[i].report_id);
+          json_uint("usage_page", hid->report_info[i].usage_page);
+          json_uint("usage", hid->report_info[i].usage);
+          json_object_end();
+        }
+        json_array_end();
+      }
+      break;
+    case EVT_HID_UNMOUNT:
+      if (len < 1) break;
+      json_uint("instance", payload[0]);
+      break;
+    case EVT_HID_REPORT:
+      if (len < 1) break;
+      json_uint("ep", payload[0]);
+      json_hex("data", payload + 1, len - 1);
+      break;
+    default: break;
+  }
+  json_line_end();
+}
@@ -40,21 +40,25 @@ void setup1() {
   tuh_configure(1, TUH_CFGID_RPI_PIO_USB_CONFIGURATION, &pio_cfg);
 
   printf("Core1 setup to run TinyUSB host\n");
-  printf("Loaded %d vendor ids and %d product ids\n", usb_vids_count, usb_pids_count);
+  printf("Loaded %u vendor ids and %u product ids\n", (unsigned) usb_vids_count, (unsigned) usb_pids_count);
 
   // Check for CPU frequency, must be multiple of 120Mhz for bit-banging USB
   uint32_t cpu_hz = clock_get_hz(clk_sys);
   if ( cpu_hz != 120000000UL && cpu_hz != 240000000UL ) {
     while ( !Serial ) delay(10);   // wait for native usb
-    printf("Error: CPU Clock = %lu, PIO USB require CPU clock must be multiple of 120 Mhz\r\n", cpu_hz);
+    printf("Error: CPU Clock = %lu, PIO USB require CPU clock must be multiple of 120 Mhz\r\n", (unsigned long) cpu_hz);
     printf("Change your CPU Clock to either 120 or 240 Mhz in Menu->CPU Speed \r\n");
     while(1) delay(1);
   }
+  #if defined DESC_CACHE_FLASH
+    desc_cache_load();
+  #endif
+
   // To run USB SOF interrupt in core1, init host stack for pio_usb (roothub
   // port1) on core1
   tuh_init(1);
 
-  printf("USB Host ready");
+  printf("USB Host ready\r\n");
 
   // while (true) {
   //   tuh_task(); // tinyusb host task
@@ -64,6 +68,14 @@ void setup1() {
 void loop1()
 {
   tuh_task(); // tinyusb host task
+  enum_task(); // enumeration requests waiting for the control pipe
+  #if defined DESC_CACHE_FLASH
+    if( console_save_request ) {
+      console_save_request = false;
+      desc_cache_save();
+      event_log(0, LOG_CACHE_SAVED);
+    }
+  #endif
   //sleep_ms(10);
 }
 
@@ -72,7 +84,12 @@ void loop1()
 void setup() {
   // default 125MHz is not appropreate. Sysclock should be multiple of 12MHz.
   //set_sys_clock_khz(120000, true);
-  Serial1.begin(115200);
+  #if defined OUTPUT_UART
+    uart_tx_init(); // UART0, instead of Serial1
+    out_begin();
+  #else
+    Serial1.begin(115200);
+  #endif
   Serial.begin(115200);
 
   //sleep_ms(5000);
@@ -97,5 +114,9 @@ void loop()
 {
   //tud_task(); // tinyusb device task
   //tud_cdc_write_flush();
+  event_task(); // render what core1 pushed
+  while( Serial.available() ) {
+    console_command( Serial.read() );
+  }
 }
 
@@ -0,0 +1,95 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+//--------------------------------------------------------------------+
+// Binary capture, the event records framed on the output stream
+//--------------------------------------------------------------------+
+
+// Text output is several times the size of the descriptors and reports it describes
+// and saturates a 115200 baud UART. In binary mode core0 writes each event record as
+// a frame instead of rendering it, tests/host/decode renders the same text on the host.
+//
+// Frame, little endian:
+//   0xA5 0x5A  sync
+//   uint8_t    type, event_type_t
+//   uint8_t    daddr
+//   uint8_t    ep, the endpoint address of EVT_HID_REPORT (dropped from the payload), 0 otherwise
+//   uint16_t   payload length
+//   uint32_t   timestamp, micros() on core1 when the event was pushed
+//   payload    as pushed by core1 (see event_ring.h), structs in the RP2040 layout
+//   uint16_t   CRC-16/CCITT-FALSE of everything after the sync bytes
+//
+// Console text (commands, 'd', 't', ...) goes on the same stream between frames,
+// the decoder passes it through.
+
+#if !defined CAPTURE_BINARY
+  #define CAPTURE_BINARY false // start in binary mode, the 'b' command toggles it
+#endif
+
+#define CAPTURE_SYNC1 0xA5
+#define CAPTURE_SYNC2 0x5A
+#define CAPTURE_HEADER_SIZE 11
+
+// set on core0 by the console
+volatile bool capture_binary = CAPTURE_BINARY;
+
+
+uint16_t crc16_ccitt(uint16_t crc, const uint8_t* data, size_t len)
+{
+  while (len--) {
+    crc ^= (uint16_t)(*data++) << 8;
+    for (uint8_t i = 0; i < 8; i++) {
+      crc = crc & 0x8000 ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+
+// core0: one event as a frame in the output buffer
+void capture_write(const event_header_t* header, const uint8_t* payload)
+{
+  uint16_t len = header->len;
+  uint8_t ep = 0;
+  if (header->type == EVT_HID_REPORT && len > 0) {
+    ep = payload[0];
+    payload++;
+    len--;
+  }
+  uint8_t const frame[CAPTURE_HEADER_SIZE] = {
+    CAPTURE_SYNC1, CAPTURE_SYNC2,
+    header->type, header->daddr, ep,
+    (uint8_t)len, (uint8_t)(len >> 8),
+    (uint8_t)header->us, (uint8_t)(header->us >> 8), (uint8_t)(header->us >> 16), (uint8_t)(header->us >> 24)
+  };
+  uint16_t crc = crc16_ccitt(0xFFFF, frame + 2, sizeof(frame) - 2);
+  crc = crc16_ccitt(crc, payload, len);
+  uint8_t const trailer[2] = { (uint8_t)crc, (uint8_t)(crc >> 8) };
+  out_write((const char*) frame, sizeof(frame));
+  out_write((const char*) payload, len);
+  out_write((const char*) trailer, sizeof(trailer));
+}
@@ -0,0 +1,128 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+//--------------------------------------------------------------------+
+// Serial console, single char commands handled on core0
+//--------------------------------------------------------------------+
+
+// set on core0, served by loop1() on core1 where the descriptor cache is written
+volatile bool console_save_request = false;
+
+// rendered from core0's copy of the devices, see lsusb.host.h
+void enum_redump();
+void print_usb_tree();
+extern volatile bool hid_report_delta;
+
+
+void console_help()
+{
+  out_printf("Commands:\r\n");
+  out_printf("  b  toggle binary capture, decode on the host with tests/host/decode\r\n");
+  out_printf("  d  dump the attached devices again, from cache\r\n");
+  out_printf("  j  toggle JSON Lines output, one object per device or event\r\n");
+  out_printf("  r  toggle HID report delta mode, only the bytes that changed\r\n");
+  out_printf("  s  lookup and descriptor cache stats\r\n");
+  out_printf("  t  bus topology, like lsusb -t\r\n");
+  #if defined OUTPUT_UART
+    out_printf("  u  next UART output baud rate\r\n");
+  #endif
+  #if defined DESC_CACHE_FLASH
+    out_printf("  w  write the descriptor cache to flash\r\n");
+  #endif
+  out_printf("  h  this help\r\n");
+}
+
+
+template<typename cache_t>
+void print_cache_stats( const char* name, cache_t &cache )
+{
+  uint32_t hits = cache.hits, misses = cache.misses; // desc_cache_stats is updated by core1, the lookup caches by core0 while rendering
+  uint32_t total = hits + misses;
+  out_printf("  %-16s hits %8lu misses %8lu (%lu%% hit rate)\r\n", name, (unsigned long)hits, (unsigned long)misses, (unsigned long)(total ? hits*100/total : 0) );
+}
+
+
+void console_command( int cmd )
+{
+  switch( cmd ) {
+    case 'b':
+      if (!capture_binary) out_printf("Binary capture on, send 'b' again to go back to text\r\n");
+      capture_binary = !capture_binary;
+      if (!capture_binary) out_printf("Binary capture off\r\n");
+    break;
+    case 'd':
+      enum_redump();
+    break;
+    case 'j':
+      json_lines = !json_lines;
+      out_printf("JSON Lines %s\r\n", json_lines ? "on, send 'j' again to go back to text" : "off");
+    break;
+    case 'r':
+      hid_report_delta = !hid_report_delta;
+      out_printf("HID report delta mode %s\r\n", hid_report_delta ? "on" : "off");
+    break;
+    case 's':
+      out_printf("Lookup cache:\r\n");
+      print_cache_stats( "vid:pid", vid_pid_cache );
+      print_cache_stats( "class/sub/proto", class_sub_proto_cache );
+      out_printf("Descriptor cache:\r\n");
+      print_cache_stats( "devices", desc_cache_stats );
+      out_printf("  %lu stale, %lu too large, %llu us and %lu transfers saved\r\n", (unsigned long)desc_cache_stats.stale, (unsigned long)desc_cache_stats.too_large, (unsigned long long)desc_cache_stats.saved_us, (unsigned long)desc_cache_stats.saved_xfers );
+      out_printf("Event ring:\r\n");
+      out_printf("  %lu events, %lu dropped (%lu bytes), high water %lu of %u bytes\r\n", (unsigned long)event_ring_stats.events, (unsigned long)event_ring_stats.dropped, (unsigned long)event_ring_stats.dropped_bytes, (unsigned long)event_ring_stats.high_water, EVENT_RING_SIZE );
+      #if defined OUTPUT_UART
+        out_printf("UART output at %lu baud:\r\n", (unsigned long)uart_tx.baud);
+        out_printf("  %lu bytes in %lu transfers, %lu stalls (%llu us), %lu dropped (%lu bytes)\r\n", (unsigned long)uart_tx_stats.bytes, (unsigned long)uart_tx_stats.transfers, (unsigned long)uart_tx_stats.stalls, (unsigned long long)uart_tx_stats.stall_us, (unsigned long)uart_tx_stats.dropped, (unsigned long)uart_tx_stats.dropped_bytes );
+      #endif
+    break;
+    case 't':
+      print_usb_tree();
+    break;
+    #if defined OUTPUT_UART
+      case 'u': {
+        // the terminal on the UART follows with the second line
+        uint32_t const baud = uart_tx_next_baud();
+        out_printf("UART output switching to %lu baud\r\n", (unsigned long)baud);
+        out_flush();
+        uart_tx_set_baud(baud);
+        out_begin();
+        out_printf("UART output at %lu baud\r\n", (unsigned long)uart_tx.baud);
+      } break;
+    #endif
+    #if defined DESC_CACHE_FLASH
+      case 'w':
+        console_save_request = true;
+      break;
+    #endif
+    case 'h':
+    case '?':
+      console_help();
+    break;
+    default: break;
+  }
+  out_flush();
+}
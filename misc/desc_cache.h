@@ -0,0 +1,305 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+//--------------------------------------------------------------------+
+// Descriptor cache, raw descriptors of the last enumerated devices
+//--------------------------------------------------------------------+
+
+// Entries are keyed by VID:PID:bcdDevice:serial, the strings and configuration
+// descriptors of each entry are packed in a blob of the shared arena:
+//   strings : [index][utf-8 length][utf-8 bytes] ...
+//   configs : [length lo][length hi][descriptor bytes] ...
+// Blobs have the size of their device and are kept contiguous at the start of the arena,
+// storing a device evicts the least recently used entries until it fits.
+// With DESC_CACHE_FLASH defined the table fits the 4KB EEPROM flash sector and
+// survives reboots, see desc_cache_load() and desc_cache_save().
+
+#if !defined DESC_CACHE_ENTRIES
+  #define DESC_CACHE_ENTRIES 4
+#endif
+
+#define DESC_CACHE_MAGIC   0x4c535543 // "LSUC"
+#define DESC_CACHE_VERSION 2          // bump when the layout of an entry or of the blob changes
+#define DESC_CACHE_HEADER_SIZE 16     // desc_cache up to the entries
+
+// the largest blob the enumeration can produce: every string, every configuration
+// descriptor of a full CFG_POOL_SIZE pool
+#define DESC_CACHE_DEVICE_MAX (STRINGS_MAX * (2 + STRING_LEN - 1) + CONFIGS_MAX * 2 + CFG_POOL_SIZE)
+
+struct desc_cache_entry_t
+{
+  uint32_t lru;          // 0 when unused
+  uint16_t vid, pid, bcdDevice;
+  char serial[STRING_LEN];
+  tusb_desc_device_t device;
+  uint8_t langid_count;
+  uint16_t langid[LANGID_MAX];
+  uint16_t best_langid;
+  uint8_t string_count;
+  uint8_t config_count;
+  uint16_t blob_offset;  // in desc_cache.arena
+  uint16_t blob_len;
+  uint32_t enum_us;      // what the full enumeration cost, reported as saved on a hit
+  uint16_t xfers;
+};
+
+#if !defined DESC_CACHE_ARENA
+  #if defined DESC_CACHE_FLASH
+    #define DESC_CACHE_ARENA (4096 - DESC_CACHE_HEADER_SIZE - DESC_CACHE_ENTRIES * sizeof(desc_cache_entry_t)) // the rest of the EEPROM sector
+  #else
+    #define DESC_CACHE_ARENA DESC_CACHE_DEVICE_MAX // room for any device, or several smaller ones
+  #endif
+#endif
+
+static struct
+{
+  uint32_t magic;
+  uint16_t version;      // DESC_CACHE_VERSION
+  uint16_t entry_size;   // sizeof(desc_cache_entry_t), follows STRING_LEN and LANGID_MAX
+  uint16_t entry_count;  // DESC_CACHE_ENTRIES
+  uint16_t arena_size;   // DESC_CACHE_ARENA
+  uint32_t lru_clock;
+  desc_cache_entry_t entries[DESC_CACHE_ENTRIES];
+  uint8_t arena[DESC_CACHE_ARENA];
+} desc_cache;
+
+static_assert(offsetof(decltype(desc_cache), entries) == DESC_CACHE_HEADER_SIZE, "DESC_CACHE_HEADER_SIZE must match the header of desc_cache");
+static_assert(DESC_CACHE_ARENA <= UINT16_MAX, "Blob offsets are 16 bit, lower DESC_CACHE_ARENA");
+
+static struct
+{
+  uint32_t hits;
+  uint32_t misses;
+  uint32_t stale;        // cached descriptors that no longer matched the device, or were corrupt
+  uint32_t too_large;    // devices larger than the whole arena
+  uint64_t saved_us;
+  uint32_t saved_xfers;
+} desc_cache_stats;
+
+
+void desc_cache_touch(desc_cache_entry_t* entry)
+{
+  entry->lru = ++desc_cache.lru_clock;
+}
+
+
+// most recently used entry for vid:pid, NULL on a miss
+desc_cache_entry_t* desc_cache_find(uint16_t vid, uint16_t pid)
+{
+  desc_cache_entry_t* found = NULL;
+  for (auto& entry : desc_cache.entries) {
+    if (entry.lru && entry.vid == vid && entry.pid == pid && (!found || entry.lru > found->lru)) found = &entry;
+  }
+  return found;
+}
+
+
+desc_cache_entry_t* desc_cache_find_serial(uint16_t vid, uint16_t pid, uint16_t bcdDevice, const char* serial)
+{
+  for (auto& entry : desc_cache.entries) {
+    if (entry.lru && entry.vid == vid && entry.pid == pid && entry.bcdDevice == bcdDevice && strcmp(entry.serial, serial) == 0) return &entry;
+  }
+  return NULL;
+}
+
+
+// least recently used entry, an unused one first, NULL when all are unused
+desc_cache_entry_t* desc_cache_oldest(bool unused_ok)
+{
+  desc_cache_entry_t* oldest = NULL;
+  for (auto& entry : desc_cache.entries) {
+    if ((unused_ok || entry.lru) && (!oldest || entry.lru < oldest->lru)) oldest = &entry;
+  }
+  return oldest;
+}
+
+
+// moves the blobs of the used entries to the start of the arena, returns the bytes they take
+uint16_t desc_cache_compact()
+{
+  bool placed[DESC_CACHE_ENTRIES] = {};
+  uint16_t end = 0;
+  for (;;) {
+    int next = -1;
+    for (int i=0; i<DESC_CACHE_ENTRIES; i++) {
+      auto& entry = desc_cache.entries[i];
+      if (entry.lru && !placed[i] && (next < 0 || entry.blob_offset < desc_cache.entries[next].blob_offset)) next = i;
+    }
+    if (next < 0) return end;
+    auto& entry = desc_cache.entries[next];
+    memmove(&desc_cache.arena[end], &desc_cache.arena[entry.blob_offset], entry.blob_len);
+    entry.blob_offset = end;
+    end += entry.blob_len;
+    placed[next] = true;
+  }
+}
+
+
+// the entry with the same key, or the least recently used one, emptied with room for
+// a blob of blob_len bytes. NULL when the arena is smaller than that
+desc_cache_entry_t* desc_cache_slot(uint16_t vid, uint16_t pid, uint16_t bcdDevice, const char* serial, size_t blob_len)
+{
+  if (blob_len > DESC_CACHE_ARENA) return NULL;
+  desc_cache_entry_t* slot = desc_cache_find_serial(vid, pid, bcdDevice, serial);
+  if (slot == NULL) slot = desc_cache_oldest(true);
+  slot->lru = 0; // unused until complete
+  uint16_t used = desc_cache_compact();
+  while (used + blob_len > DESC_CACHE_ARENA) {
+    desc_cache_oldest(false)->lru = 0;
+    used = desc_cache_compact();
+  }
+  slot->blob_offset  = used;
+  slot->blob_len     = 0;
+  slot->string_count = 0;
+  slot->config_count = 0;
+  return slot;
+}
+
+
+// the caller reserved the room with desc_cache_slot()
+bool desc_cache_put(desc_cache_entry_t* entry, const void* data, size_t len)
+{
+  if (entry->blob_offset + entry->blob_len + len > DESC_CACHE_ARENA) return false;
+  memcpy(&desc_cache.arena[entry->blob_offset + entry->blob_len], data, len);
+  entry->blob_len += len;
+  return true;
+}
+
+
+size_t desc_cache_string_size(const char* utf8)
+{
+  return 2 + strlen(utf8);
+}
+
+
+bool desc_cache_put_string(desc_cache_entry_t* entry, uint8_t index, const char* utf8)
+{
+  uint8_t const head[2] = { index, (uint8_t) strlen(utf8) };
+  if (!desc_cache_put(entry, head, sizeof(head)) || !desc_cache_put(entry, utf8, head[1])) return false;
+  entry->string_count++;
+  return true;
+}
+
+
+size_t desc_cache_config_size(uint16_t len)
+{
+  return 2 + len;
+}
+
+
+bool desc_cache_put_config(desc_cache_entry_t* entry, const uint8_t* desc, uint16_t len)
+{
+  uint8_t const head[2] = { (uint8_t)(len & 0xff), (uint8_t)(len >> 8) };
+  if (!desc_cache_put(entry, head, sizeof(head)) || !desc_cache_put(entry, desc, len)) return false;
+  entry->config_count++;
+  return true;
+}
+
+
+// false when the counts or a record run past the arrays of a device or past the blob,
+// e.g. an entry restored from flash by another build
+bool desc_cache_check(const desc_cache_entry_t* entry)
+{
+  if (entry->string_count > STRINGS_MAX || entry->config_count > CONFIGS_MAX) return false;
+  if (entry->blob_offset + entry->blob_len > DESC_CACHE_ARENA) return false;
+  if (entry->langid_count > LANGID_MAX || memchr(entry->serial, '\0', STRING_LEN) == NULL) return false;
+  size_t pos = 0;
+  for (uint8_t i=0; i<entry->string_count; i++) {
+    const uint8_t* p = &desc_cache.arena[entry->blob_offset + pos];
+    if (pos + 2 > entry->blob_len || p[1] > STRING_LEN - 1) return false;
+    pos += 2 + p[1];
+  }
+  for (uint8_t i=0; i<entry->config_count; i++) {
+    const uint8_t* p = &desc_cache.arena[entry->blob_offset + pos];
+    if (pos + 2 > entry->blob_len) return false;
+    pos += 2 + (p[0] | p[1] << 8);
+  }
+  return pos == entry->blob_len;
+}
+
+
+// walks the packed blob, strings first, calls string_cb then config_cb for each record.
+// Nothing is called back for an entry that doesn't pass desc_cache_check()
+template<typename string_cb_t, typename config_cb_t>
+bool desc_cache_unpack(const desc_cache_entry_t* entry, string_cb_t string_cb, config_cb_t config_cb)
+{
+  if (!desc_cache_check(entry)) return false;
+  const uint8_t* p = &desc_cache.arena[entry->blob_offset];
+  for (uint8_t i=0; i<entry->string_count; i++) {
+    string_cb(p[0], (const char*) &p[2], p[1]);
+    p += 2 + p[1];
+  }
+  for (uint8_t i=0; i<entry->config_count; i++) {
+    uint16_t const len = p[0] | p[1] << 8;
+    config_cb(&p[2], len);
+    p += 2 + len;
+  }
+  return true;
+}
+
+
+#if defined DESC_CACHE_FLASH
+  #include <EEPROM.h>
+  static_assert(sizeof(desc_cache) <= 4096, "The descriptor cache must fit the EEPROM sector, lower DESC_CACHE_ENTRIES or DESC_CACHE_ARENA");
+
+  // a sector written by a build with another layout is discarded as a whole,
+  // entries that don't pass desc_cache_check() one by one
+  void desc_cache_load()
+  {
+    EEPROM.begin(sizeof(desc_cache));
+    EEPROM.get(0, desc_cache);
+    if (desc_cache.magic != DESC_CACHE_MAGIC || desc_cache.version != DESC_CACHE_VERSION || desc_cache.entry_size != sizeof(desc_cache_entry_t)
+     || desc_cache.entry_count != DESC_CACHE_ENTRIES || desc_cache.arena_size != DESC_CACHE_ARENA) {
+      memset(&desc_cache, 0, sizeof(desc_cache));
+      return;
+    }
+    for (auto& entry : desc_cache.entries) {
+      if (entry.lru && !desc_cache_check(&entry)) entry.lru = 0;
+    }
+    // desc_cache_compact() relies on the blobs not overlapping
+    for (auto& a : desc_cache.entries) {
+      for (auto& b : desc_cache.entries) {
+        if (&a != &b && a.lru && b.lru && a.blob_offset < b.blob_offset + b.blob_len && b.blob_offset < a.blob_offset + a.blob_len) {
+          memset(&desc_cache, 0, sizeof(desc_cache));
+          return;
+        }
+      }
+    }
+  }
+
+  // the flash write stalls both cores for tens of ms, attached devices may see a bus reset
+  void desc_cache_save()
+  {
+    desc_cache.magic       = DESC_CACHE_MAGIC;
+    desc_cache.version     = DESC_CACHE_VERSION;
+    desc_cache.entry_size  = sizeof(desc_cache_entry_t);
+    desc_cache.entry_count = DESC_CACHE_ENTRIES;
+    desc_cache.arena_size  = DESC_CACHE_ARENA;
+    EEPROM.put(0, desc_cache);
+    EEPROM.commit();
+  }
+#endif
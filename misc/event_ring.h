@@ -0,0 +1,193 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+//--------------------------------------------------------------------+
+// Event ring, binary records from core1 (USB host) to core0 (console)
+//--------------------------------------------------------------------+
+
+// Single producer (core1) / single consumer (core0), lock-free: each side only writes
+// its own index, the records become visible to core0 when core1 publishes the head.
+// A record is an event_header_t followed by len payload bytes, records wrap around
+// the end of the buffer. A record that doesn't fit is dropped and counted, core1 never
+// waits for core0.
+
+#include <atomic>
+
+#if !defined EVENT_RING_SIZE
+  #define EVENT_RING_SIZE 8192 // bytes, a power of two
+#endif
+
+static_assert((EVENT_RING_SIZE & (EVENT_RING_SIZE-1)) == 0, "EVENT_RING_SIZE must be a power of two");
+
+enum event_type_t
+{
+  EVT_MOUNT,       // hcd_devtree_info_t
+  EVT_UNMOUNT,     // -
+  EVT_DEVICE,      // device descriptor, LANGID count, LANGIDs: starts a snapshot
+  EVT_STRING,      // string index, utf-8 bytes
+  EVT_CONFIG,      // configuration descriptor
+  EVT_DEVICE_END,  // event_device_end_t: the snapshot is complete
+  EVT_LOG,         // event_log_t, then an optional string
+  EVT_HID_MOUNT,   // instance, interface protocol, report descriptor
+  EVT_HID_UNMOUNT, // instance
+  EVT_HID_REPORT,  // endpoint address, report bytes
+};
+
+enum event_device_end_kind_t
+{
+  END_ENUMERATED,  // full enumeration, us and xfers are set
+  END_CACHED,      // rendered from the descriptor cache, once the serial number (if any) picked the entry
+};
+
+struct event_device_end_t
+{
+  uint8_t kind;    // event_device_end_kind_t
+  uint16_t xfers;
+  uint32_t us;
+};
+
+// status lines, formatted by core0
+enum event_log_msg_t
+{
+  LOG_DEVICE_FAILED,      // -
+  LOG_CFG_TRUNCATED,      // configuration index, kept length, wTotalLength
+  LOG_CACHE_STALE,        // -
+  LOG_CACHE_NEW_SERIAL,   // -
+  LOG_CACHE_OTHER_UNIT,   // serial number string
+  LOG_CACHE_VERIFIED,     // us, transfers, us saved
+  LOG_CACHE_SAVED,        // -
+  LOG_HID_RECEIVE_FAILED, // -
+  LOG_HID_REPORT_FAILED,  // endpoint address
+  LOG_EP_LISTEN,          // endpoint address
+  LOG_EP_OPEN_FAILED,     // endpoint address
+  LOG_EP_NO_BUFFER,       // endpoint address
+};
+
+struct event_log_t
+{
+  uint8_t msg;     // event_log_msg_t
+  uint32_t args[3];
+};
+
+struct event_header_t
+{
+  uint8_t type;  // event_type_t
+  uint8_t daddr;
+  uint16_t len;  // payload bytes following the header
+  uint32_t us;   // micros() on core1 when pushed
+};
+
+static struct
+{
+  std::atomic<uint32_t> head; // free running, written by core1 only
+  std::atomic<uint32_t> tail; // free running, written by core0 only
+  uint8_t buf[EVENT_RING_SIZE];
+} event_ring;
+
+// written by core1 only
+static struct
+{
+  uint32_t events;
+  uint32_t dropped;
+  uint32_t dropped_bytes;
+  uint32_t high_water; // most bytes in use at once
+} event_ring_stats;
+
+
+static void event_ring_write(uint32_t pos, const void* src, size_t len)
+{
+  if (len == 0) return;
+  uint32_t const offset = pos & (EVENT_RING_SIZE-1);
+  size_t const first = len < EVENT_RING_SIZE - offset ? len : EVENT_RING_SIZE - offset;
+  memcpy(&event_ring.buf[offset], src, first);
+  memcpy(event_ring.buf, (const uint8_t*)src + first, len - first);
+}
+
+
+static void event_ring_read(uint32_t pos, void* dst, size_t len)
+{
+  if (len == 0) return;
+  uint32_t const offset = pos & (EVENT_RING_SIZE-1);
+  size_t const first = len < EVENT_RING_SIZE - offset ? len : EVENT_RING_SIZE - offset;
+  memcpy(dst, &event_ring.buf[offset], first);
+  memcpy((uint8_t*)dst + first, event_ring.buf, len - first);
+}
+
+
+// core1: bytes a record can use right now
+uint32_t event_ring_free()
+{
+  return EVENT_RING_SIZE - (event_ring.head.load(std::memory_order_relaxed) - event_ring.tail.load(std::memory_order_acquire));
+}
+
+
+// core1: one record whose payload is made of two parts, false when it was dropped
+bool event_push(uint8_t type, uint8_t daddr, const void* data = nullptr, size_t len = 0, const void* data2 = nullptr, size_t len2 = 0)
+{
+  size_t const size = sizeof(event_header_t) + len + len2;
+  uint32_t const head = event_ring.head.load(std::memory_order_relaxed);
+  uint32_t const used = head - event_ring.tail.load(std::memory_order_acquire);
+  if (len + len2 > UINT16_MAX || size > EVENT_RING_SIZE - used) {
+    event_ring_stats.dropped++;
+    event_ring_stats.dropped_bytes += size;
+    return false;
+  }
+  event_header_t const header = { type, daddr, (uint16_t)(len + len2), (uint32_t)micros() };
+  event_ring_write(head, &header, sizeof(header));
+  event_ring_write(head + sizeof(header), data, len);
+  event_ring_write(head + sizeof(header) + len, data2, len2);
+  event_ring.head.store(head + size, std::memory_order_release);
+  event_ring_stats.events++;
+  if (used + size > event_ring_stats.high_water) event_ring_stats.high_water = used + size;
+  return true;
+}
+
+
+// core0: the next record, false when the ring is empty. A payload larger than
+// max_len can't come from this sketch's producer, it is skipped
+bool event_pop(event_header_t* header, uint8_t* payload, size_t max_len)
+{
+  uint32_t tail = event_ring.tail.load(std::memory_order_relaxed);
+  uint32_t const head = event_ring.head.load(std::memory_order_acquire);
+  while (tail != head) {
+    event_ring_read(tail, header, sizeof(event_header_t));
+    bool const fits = header->len <= max_len;
+    if (fits) event_ring_read(tail + sizeof(event_header_t), payload, header->len);
+    tail += sizeof(event_header_t) + header->len;
+    event_ring.tail.store(tail, std::memory_order_release);
+    if (fits) return true;
+  }
+  return false;
+}
+
+
+// core1: a status line with up to three numbers and a string
+void event_log(uint8_t daddr, uint8_t msg, uint32_t arg0 = 0, uint32_t arg1 = 0, uint32_t arg2 = 0, const char* str = nullptr)
+{
+  event_log_t const log = { msg, { arg0, arg1, arg2 } };
+  event_push(EVT_LOG, daddr, &log, sizeof(log), str, str ? strlen(str) : 0);
+}
@@ -68,24 +68,21 @@ static int _count_utf8_bytes(const uint16_t *buf, size_t len) {
   return total_bytes;
 }
 
-typedef void (*utf16_printer_cb)(char*);
 
-
-static void print_utf16(uint16_t *temp_buf, size_t buf_len, utf16_printer_cb print_cb) {
-  size_t utf16_len = ((temp_buf[0] & 0xff) - 2) / sizeof(uint16_t);
-  size_t utf8_len = _count_utf8_bytes(temp_buf + 1, utf16_len);
-
-  _convert_utf16le_to_utf8(temp_buf + 1, utf16_len, (uint8_t *) temp_buf, sizeof(uint16_t) * buf_len);
-  ((uint8_t*) temp_buf)[utf8_len] = '\0';
-
-  print_cb((char*)temp_buf);
+// bounded conversion of a string descriptor, the utf-8 string is truncated to fit utf8_len
+static void string_desc_to_utf8(const uint16_t *desc, char *utf8, size_t utf8_len) {
+  uint8_t const bLength = desc[0] & 0xff;
+  size_t utf16_len = bLength < 2 ? 0 : (bLength - 2) / sizeof(uint16_t);
+  while (utf16_len > 0 && (size_t)_count_utf8_bytes(desc + 1, utf16_len) >= utf8_len) utf16_len--;
+  _convert_utf16le_to_utf8(desc + 1, utf16_len, (uint8_t *) utf8, utf8_len);
+  utf8[_count_utf8_bytes(desc + 1, utf16_len)] = '\0';
 }
 
 
+#define BUF_COUNT       4
+#define HID_REPORT_SIZE 64 // bytes, the size of the HID IN transfers
 
-#define BUF_COUNT   4
-
-uint8_t buf_pool[BUF_COUNT][64];
+uint8_t buf_pool[BUF_COUNT][HID_REPORT_SIZE];
 uint8_t buf_owner[BUF_COUNT] = { 0 }; // device address that owns buffer
 
 //--------------------------------------------------------------------+
@@ -112,3 +109,42 @@ void free_hid_buf(uint8_t daddr)
     if (buf_owner[i] == daddr) buf_owner[i] = 0;
   }
 }
+
+
+#if !defined CFG_POOL_SIZE
+  #define CFG_POOL_SIZE 4096 // configuration descriptors of one device
+#endif
+
+// one pool per device address
+struct cfg_pool_t
+{
+  uint8_t buf[DEVICES_MAX][CFG_POOL_SIZE];
+  size_t used[DEVICES_MAX];
+};
+
+//--------------------------------------------------------------------+
+// Configuration descriptor pool
+//--------------------------------------------------------------------+
+
+// bytes left in the pool of a device
+size_t cfg_pool_left(cfg_pool_t& pool, uint8_t daddr)
+{
+  if (daddr == 0 || daddr > DEVICES_MAX) return 0;
+  return CFG_POOL_SIZE - pool.used[daddr-1];
+}
+
+// carve len bytes out of the pool of a device, NULL when it is exhausted
+uint8_t* get_cfg_buf(cfg_pool_t& pool, uint8_t daddr, size_t len)
+{
+  if (daddr == 0 || daddr > DEVICES_MAX || len > cfg_pool_left(pool, daddr)) return NULL;
+  uint8_t* buf = &pool.buf[daddr-1][pool.used[daddr-1]];
+  pool.used[daddr-1] += len;
+  return buf;
+}
+
+// release every configuration descriptor of a device at once
+void free_cfg_bufs(cfg_pool_t& pool, uint8_t daddr)
+{
+  if (daddr == 0 || daddr > DEVICES_MAX) return;
+  pool.used[daddr-1] = 0;
+}
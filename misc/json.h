@@ -0,0 +1,147 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+//--------------------------------------------------------------------+
+// JSON Lines, a streaming writer into the output buffer
+//--------------------------------------------------------------------+
+
+// One object per line, written member by member while the descriptors are walked:
+// nothing is built in memory, the writer only remembers whether the object or array
+// at each nesting level already has a member (for the commas). Console text can
+// still show up between the lines, readers skip the lines not starting with '{'.
+
+#if !defined JSON_LINES
+  #define JSON_LINES false // start in JSON mode, the 'j' command toggles it
+#endif
+
+#define JSON_DEPTH_MAX 32
+
+// set on core0 by the console
+volatile bool json_lines = JSON_LINES;
+
+static struct
+{
+  uint32_t empty; // bit n: nothing written yet at nesting level n
+  uint8_t depth;
+} json;
+
+
+// the key of the next member, nullptr in arrays
+void json_key(const char* key)
+{
+  uint32_t const bit = 1UL << json.depth;
+  if (json.empty & bit) json.empty &= ~bit;
+  else out_char(',');
+  if (key == nullptr) return;
+  out_char('"');
+  out_str(key);
+  out_str("\":");
+}
+
+
+void json_open(const char* key, char bracket)
+{
+  json_key(key);
+  out_char(bracket);
+  if (json.depth < JSON_DEPTH_MAX - 1) json.depth++;
+  json.empty |= 1UL << json.depth;
+}
+
+
+void json_close(char bracket)
+{
+  if (json.depth > 0) json.depth--;
+  out_char(bracket);
+}
+
+
+void json_object_begin(const char* key = nullptr) { json_open(key, '{'); }
+void json_object_end()                           { json_close('}'); }
+void json_array_begin(const char* key)           { json_open(key, '['); }
+void json_array_end()                            { json_close(']'); }
+
+
+void json_uint(const char* key, uint32_t value)
+{
+  json_key(key);
+  out_dec(value);
+}
+
+
+void json_string(const char* key, const char* str, size_t len)
+{
+  static const char hex[] = "0123456789abcdef";
+  json_key(key);
+  out_char('"');
+  for (size_t i = 0; i < len; i++) {
+    uint8_t const c = str[i];
+    if (c == '"' || c == '\\') {
+      out_char('\\');
+      out_char(c);
+    } else if (c < 0x20) {
+      out_str("\\u00");
+      out_char(hex[c >> 4]);
+      out_char(hex[c & 0xf]);
+    } else {
+      out_char(c);
+    }
+  }
+  out_char('"');
+}
+
+
+void json_string(const char* key, const char* str)
+{
+  json_string(key, str, strlen(str));
+}
+
+
+// bytes as a lowercase hex string
+void json_hex(const char* key, const uint8_t* data, size_t len)
+{
+  json_key(key);
+  out_char('"');
+  out_hex_bytes(data, len);
+  out_char('"');
+}
+
+
+// a line is one object, written out as soon as it is complete
+void json_line_begin()
+{
+  json.depth = 0;
+  json.empty = 1;
+  json_object_begin();
+}
+
+
+void json_line_end()
+{
+  json_object_end();
+  out_char('\n');
+  out_flush();
+}
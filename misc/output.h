@@ -0,0 +1,200 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+//--------------------------------------------------------------------+
+// Output buffer, text is formatted in place and written in large chunks
+//--------------------------------------------------------------------+
+
+// Everything core0 prints goes through here: the descriptor dumps format integers by
+// hand, the status lines use out_printf(). The buffer reaches stdout (the printf stream)
+// in one write when full or flushed. With OUTPUT_UART defined it is room reserved in the
+// DMA buffers of misc/uart_tx.h instead, and a flush hands the bytes over in place.
+
+#include <stdarg.h>
+
+#if !defined OUT_BUF_SIZE
+  #define OUT_BUF_SIZE 2048 // bytes
+#endif
+
+static struct
+{
+  #if defined OUTPUT_UART
+    char* buf; // OUT_BUF_SIZE bytes reserved in uart_tx, see out_begin()
+  #else
+    char buf[OUT_BUF_SIZE];
+  #endif
+  size_t len;
+} out;
+
+
+#if defined OUTPUT_UART
+  #if defined UART_TX_DROP
+    static char out_dropped[OUT_BUF_SIZE]; // written while uart_tx is full
+  #endif
+
+  // once uart_tx_init() set up the UART
+  void out_begin()
+  {
+    uint8_t* const room = uart_tx_reserve(OUT_BUF_SIZE);
+    #if defined UART_TX_DROP
+      out.buf = room ? (char*) room : out_dropped;
+    #else
+      out.buf = (char*) room;
+    #endif
+    out.len = 0;
+  }
+#endif
+
+
+void out_flush()
+{
+  if (out.len == 0) return;
+  #if defined OUTPUT_UART
+    uart_tx_commit(out.len);
+    out_begin();
+  #else
+    fwrite(out.buf, 1, out.len, stdout);
+    fflush(stdout);
+    out.len = 0;
+  #endif
+}
+
+
+#if defined OUTPUT_UART
+  static_assert(UART_TX_BUF_SIZE >= 2 * OUT_BUF_SIZE, "out_ready() would never be true");
+#endif
+
+// false while the output can't take a full buffer without waiting
+bool out_ready()
+{
+  #if defined OUTPUT_UART
+    // room for the buffer being written and the next one
+    if (uart_tx_room() < 2 * OUT_BUF_SIZE) return false;
+    if (out.len == 0) out_begin(); // a kick may have switched buffers, start in the new one
+    return true;
+  #else
+    return true;
+  #endif
+}
+
+
+void out_write(const char* str, size_t len)
+{
+  while (len > 0) {
+    if (out.len == OUT_BUF_SIZE) out_flush();
+    size_t const chunk = len < OUT_BUF_SIZE - out.len ? len : OUT_BUF_SIZE - out.len;
+    memcpy(&out.buf[out.len], str, chunk);
+    out.len += chunk;
+    str += chunk;
+    len -= chunk;
+  }
+}
+
+
+void out_str(const char* str)
+{
+  out_write(str, strlen(str));
+}
+
+
+void out_char(char c)
+{
+  if (out.len == OUT_BUF_SIZE) out_flush();
+  out.buf[out.len++] = c;
+}
+
+
+// like printf("%*u", width, value)
+void out_dec(uint32_t value, uint8_t width = 0)
+{
+  char digits[10];
+  uint8_t count = 0;
+  do {
+    digits[count++] = '0' + value % 10;
+    value /= 10;
+  } while (value != 0);
+  while (width > count) {
+    out_char(' ');
+    width--;
+  }
+  while (count > 0) out_char(digits[--count]);
+}
+
+
+// like printf("%0*x", digits, value)
+void out_hex(uint32_t value, uint8_t digits)
+{
+  static const char hex[] = "0123456789abcdef";
+  if (digits == 0) digits = 1;
+  while (digits < 8 && (value >> (digits*4)) != 0) digits++;
+  while (digits > 0) out_char(hex[(value >> (--digits*4)) & 0xf]);
+}
+
+
+// bytes as hex pairs, each followed by sep unless it's 0: one pass through a nibble
+// table straight into the buffer instead of a call per byte, for the HID reports
+void out_hex_bytes(const uint8_t* data, size_t len, char sep = 0, bool upper = false)
+{
+  static const char lower_hex[] = "0123456789abcdef";
+  static const char upper_hex[] = "0123456789ABCDEF";
+  const char* const hex = upper ? upper_hex : lower_hex;
+  size_t const width = sep ? 3 : 2;
+  while (len > 0) {
+    if (OUT_BUF_SIZE - out.len < width) out_flush();
+    size_t count = (OUT_BUF_SIZE - out.len) / width;
+    if (count > len) count = len;
+    char* dst = &out.buf[out.len];
+    for (size_t i = 0; i < count; i++) {
+      uint8_t const byte = data[i];
+      *dst++ = hex[byte >> 4];
+      *dst++ = hex[byte & 0xf];
+      if (sep) *dst++ = sep;
+    }
+    out.len += count * width;
+    data += count;
+    len -= count;
+  }
+}
+
+
+// printf into the buffer, for the status lines
+void out_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2)));
+void out_printf(const char* fmt, ...)
+{
+  va_list args;
+  va_start(args, fmt);
+  int len = vsnprintf(&out.buf[out.len], OUT_BUF_SIZE - out.len, fmt, args);
+  va_end(args);
+  if (len >= 0 && out.len + len >= OUT_BUF_SIZE) { // didn't fit, again in an empty buffer
+    out_flush();
+    va_start(args, fmt);
+    len = vsnprintf(out.buf, OUT_BUF_SIZE, fmt, args);
+    va_end(args);
+    if (len >= OUT_BUF_SIZE) len = OUT_BUF_SIZE - 1; // truncated
+  }
+  if (len > 0) out.len += len;
+}
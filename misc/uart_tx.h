@@ -0,0 +1,181 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+//--------------------------------------------------------------------+
+// UART output, double buffered and sent by DMA (OUTPUT_UART defined)
+//--------------------------------------------------------------------+
+
+// core0 fills one buffer while a DMA channel feeds the other one to the UART: the
+// output buffer of misc/output.h is the free end of the buffer being filled, so the text
+// is formatted where the DMA reads it and the CPU never waits on the FIFO one byte at a
+// time. When both buffers are full the writer waits for the transfer in flight (with
+// UART_TX_DROP defined it drops the bytes instead), either way it is counted.
+// event_task() stops popping events before that happens, the events then wait in
+// the event ring and core1 keeps servicing USB.
+
+#if defined OUTPUT_UART
+
+#include "hardware/dma.h"
+#include "hardware/gpio.h"
+#include "hardware/uart.h"
+
+#if !defined OUTPUT_UART_BAUD
+  #define OUTPUT_UART_BAUD 115200 // up to clk_peri/16, 7.5 Mbaud at 120 MHz
+#endif
+
+#if !defined OUTPUT_UART_BAUDS
+  #define OUTPUT_UART_BAUDS 115200, 460800, 921600, 3000000 // the rates the 'u' command steps through
+#endif
+
+#if !defined OUTPUT_UART_TX_PIN
+  #define OUTPUT_UART_TX_PIN 0 // UART0 TX, where Serial1 is
+#endif
+
+#if !defined UART_TX_BUF_SIZE
+  #define UART_TX_BUF_SIZE 4096 // bytes, each of the two buffers
+#endif
+
+static struct
+{
+  uint8_t buf[2][UART_TX_BUF_SIZE];
+  size_t len[2];
+  uint8_t fill;     // the buffer being filled, the other one may be in flight
+  uint8_t* reserved;// what uart_tx_reserve() handed out, NULL when dropping
+  int channel;
+  uint32_t baud;    // as set, the closest the divider gets to OUTPUT_UART_BAUD
+} uart_tx;
+
+// written by core0 only
+static struct
+{
+  uint32_t bytes;
+  uint32_t transfers;
+  uint32_t stalls;       // writes that found both buffers full
+  uint64_t stall_us;     // time spent waiting for the DMA
+  uint32_t dropped;      // UART_TX_DROP: flushes dropped
+  uint32_t dropped_bytes;
+} uart_tx_stats;
+
+
+void uart_tx_init()
+{
+  uart_tx.baud = uart_init(uart0, OUTPUT_UART_BAUD);
+  gpio_set_function(OUTPUT_UART_TX_PIN, GPIO_FUNC_UART);
+  uart_tx.channel = dma_claim_unused_channel(true);
+  dma_channel_config config = dma_channel_get_default_config(uart_tx.channel);
+  channel_config_set_transfer_data_size(&config, DMA_SIZE_8);
+  channel_config_set_read_increment(&config, true);
+  channel_config_set_write_increment(&config, false);
+  channel_config_set_dreq(&config, uart_get_dreq(uart0, true));
+  dma_channel_configure(uart_tx.channel, &config, &uart_get_hw(uart0)->dr, NULL, 0, false);
+}
+
+
+// start sending the buffer being filled when the channel is idle
+void uart_tx_kick()
+{
+  uint8_t const fill = uart_tx.fill;
+  if (uart_tx.len[fill] == 0 || dma_channel_is_busy(uart_tx.channel)) return;
+  dma_channel_transfer_from_buffer_now(uart_tx.channel, uart_tx.buf[fill], uart_tx.len[fill]);
+  uart_tx_stats.transfers++;
+  uart_tx_stats.bytes += uart_tx.len[fill];
+  uart_tx.fill = fill ^ 1;
+  uart_tx.len[fill ^ 1] = 0;
+}
+
+
+// bytes a write can take without waiting
+size_t uart_tx_room()
+{
+  uart_tx_kick();
+  return UART_TX_BUF_SIZE - uart_tx.len[uart_tx.fill];
+}
+
+
+// room for len bytes at the end of the buffer being filled, for core0 to write in place.
+// When both buffers are full it waits for the transfer in flight, or with UART_TX_DROP
+// returns NULL: the bytes are then written elsewhere and dropped by uart_tx_commit()
+uint8_t* uart_tx_reserve(size_t len)
+{
+  if (uart_tx_room() < len) {
+    uart_tx_stats.stalls++;
+    #if defined UART_TX_DROP
+      return uart_tx.reserved = NULL;
+    #else
+      uint32_t const start_us = micros();
+      while (dma_channel_is_busy(uart_tx.channel)) tight_loop_contents();
+      uart_tx_stats.stall_us += micros() - start_us;
+      uart_tx_kick();
+    #endif
+  }
+  return uart_tx.reserved = &uart_tx.buf[uart_tx.fill][uart_tx.len[uart_tx.fill]];
+}
+
+
+// the first len bytes of the reserved room are written, for the DMA to send
+void uart_tx_commit(size_t len)
+{
+  if (uart_tx.reserved == NULL) {
+    uart_tx_stats.dropped++;
+    uart_tx_stats.dropped_bytes += len;
+    return;
+  }
+  uint8_t const fill = uart_tx.fill;
+  uint8_t* const end = &uart_tx.buf[fill][uart_tx.len[fill]];
+  // a kick sent the buffer since the room was reserved, the bytes after what it sent go
+  // to the start of the other one
+  if (uart_tx.reserved != end) memcpy(end, uart_tx.reserved, len);
+  uart_tx.len[fill] += len;
+  uart_tx_kick();
+}
+
+
+// a new rate once everything queued went out at the old one, the caller reserves room
+// again after (out_begin())
+void uart_tx_set_baud(uint32_t baud)
+{
+  while (dma_channel_is_busy(uart_tx.channel) || uart_tx.len[uart_tx.fill] > 0) {
+    tight_loop_contents();
+    uart_tx_kick();
+  }
+  uart_tx_wait_blocking(uart0); // the FIFO
+  uart_tx.baud = uart_set_baudrate(uart0, baud);
+}
+
+
+// the OUTPUT_UART_BAUDS rate after the current one, the first after the last. The divider
+// only gets close to a rate, within 3% counts as that rate
+uint32_t uart_tx_next_baud()
+{
+  static const uint32_t bauds[] = { OUTPUT_UART_BAUDS };
+  for (uint32_t baud : bauds) {
+    if (baud > uart_tx.baud + uart_tx.baud / 32) return baud;
+  }
+  return bauds[0];
+}
+
+#endif
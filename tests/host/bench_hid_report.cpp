@@ -0,0 +1,101 @@
+// HID report dumps: the former out_printf() per byte against the nibble table of
+// out_hex_bytes() (event_render_hid_report()), for 8 and 64 bytes reports, and the delta
+// mode with 2 bytes changing per report. Core0's rendering only, into the output buffer
+// and stdout on /dev/null; the reports per second a UART carries at that text size follow.
+//
+//   bench_hid_report [ROUNDS]
+
+#include "sim.h"
+
+#include <chrono>
+
+
+// event_render() of EVT_HID_REPORT before the table, the endpoint in front of the report
+void render_printf(uint8_t daddr, const uint8_t* payload, uint16_t len)
+{
+  out_printf("[dev %u: ep %02x] HID Report:", daddr, payload[0]);
+  for(uint32_t i=1; i<len; i++) {
+    if ((i-1)%16 == 0) out_printf("\r\n  ");
+    out_printf("%02X ", payload[i]);
+  }
+  out_printf("\r\n");
+}
+
+
+void render_table(uint8_t daddr, const uint8_t* payload, uint16_t len)
+{
+  event_render_hid_report(daddr, payload[0], payload + 1, len - 1);
+}
+
+
+// reports of len bytes, changes bytes of each differing from the previous one
+std::vector<std::vector<uint8_t>> make_reports(size_t count, uint16_t len, uint8_t changes)
+{
+  std::vector<std::vector<uint8_t>> reports(count, std::vector<uint8_t>(len + 1));
+  for (size_t r = 0; r < count; r++) {
+    reports[r][0] = 0x83;
+    if (r > 0) reports[r] = reports[r - 1];
+    for (uint8_t c = 0; c < changes; c++) reports[r][1 + (r + c * 3) % len] += 1 + c;
+  }
+  return reports;
+}
+
+
+void bench(const char* name, void (*render)(uint8_t, const uint8_t*, uint16_t), bool delta, uint16_t len, uint8_t changes, int rounds)
+{
+  auto const reports = make_reports(256, len, changes);
+  hid_report_delta = delta;
+
+  sim_output_begin();
+  for (auto& report : reports) render(1, report.data(), report.size());
+  double const bytes = (double) sim_output_end().size() / reports.size();
+
+  auto const start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (auto& report : reports) render(1, report.data(), report.size());
+  }
+  out_flush();
+  double const us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds / reports.size();
+  fprintf(stderr, "  %-22s %2u bytes: %5.2f us per report, %5.1f text bytes, %5.0f/s at 115200 baud, %5.0f/s at 921600 baud\n",
+          name, len, us, bytes, 115200 / 10 / bytes, 921600 / 10 / bytes);
+}
+
+
+int main(int argc, char** argv)
+{
+  int const rounds = argc > 1 ? atoi(argv[1]) : 1000;
+  sim_device_t pico;
+  if (!sim_read_sysfs("corpus/pico", &pico)) {
+    fprintf(stderr, "%s: can't read corpus/pico\n", argv[0]);
+    return 1;
+  }
+  sim_view(1, pico);
+
+  // the same full dump both ways
+  auto const reports = make_reports(4, 20, 2);
+  hid_report_delta = false;
+  std::string printed, table;
+  for (auto& report : reports) {
+    sim_output_begin();
+    render_printf(1, report.data(), report.size());
+    printed += sim_output_end();
+    sim_output_begin();
+    render_table(1, report.data(), report.size());
+    table += sim_output_end();
+  }
+  if (printed != table) {
+    fprintf(stderr, "%s: the table renders other text than out_printf()\n", argv[0]);
+    return 1;
+  }
+
+  int const out = dup(STDOUT_FILENO);
+  if (freopen("/dev/null", "w", stdout) == NULL) return 1;
+  fprintf(stderr, "%d rounds of 256 reports\n", rounds);
+  for (uint16_t len : { 8, 64 }) {
+    bench("out_printf() per byte", render_printf, false, len, 2, rounds);
+    bench("table",                 render_table,  false, len, 2, rounds);
+    bench("table, delta",          render_table,  true,  len, 2, rounds);
+  }
+  dup2(out, STDOUT_FILENO);
+  return 0;
+}
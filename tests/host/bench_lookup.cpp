@@ -0,0 +1,82 @@
+// Vendor lookup before and after the minimal perfect hash: probes of usb_vid_keys[] and
+// time per lookup of the map() guess and linear walk get_vendor() used to do, against
+// the strategies of usb.org/lsusb_search.h, for every listed id (hits) and every other
+// 16 bits id (misses). A probe is a key read, a flash read on the RP2040.
+//
+//   bench_lookup [ROUNDS]
+
+#include <Arduino.h>
+#include <tusb.h>
+#include "usb.org/lsusb_info.h"
+
+#include <chrono>
+
+
+static uint32_t probes;
+static volatile int32_t found; // keeps the timed lookups
+
+static uint16_t probed_key(size_t i)
+{
+  probes++;
+  return usb_vid_keys[i];
+}
+
+
+// get_vendor() before the hash: interpolate with map(), then walk towards the key until
+// it is found or the table ends
+static int32_t walk_search(uint16_t vendor_id)
+{
+  uint16_t maybe_idx = map(vendor_id, usb_vid_keys[0], usb_vid_keys[usb_vids_count-1], 0, usb_vids_count-1);
+  if (maybe_idx >= usb_vids_count) return -1;
+  if (probed_key(maybe_idx) == vendor_id) return maybe_idx;
+  int const dir = vendor_id < usb_vid_keys[maybe_idx] ? -1 : 1;
+  int const last_idx = dir < 0 ? 0 : usb_vids_count-1;
+  while (maybe_idx != last_idx) { // the former loop read past index 0 on a miss below the guess
+    maybe_idx += dir;
+    if (probed_key(maybe_idx) == vendor_id) return maybe_idx;
+  }
+  return -1;
+}
+
+
+template<usb_ids_search_t strategy>
+static int32_t search(uint16_t vendor_id)
+{
+  return usb_ids_search<strategy>(vendor_id, usb_vids_count, probed_key, &usb_vids_mph);
+}
+
+
+static void bench(const char* name, int32_t (*lookup)(uint16_t), int rounds)
+{
+  uint64_t hit_probes = 0, miss_probes = 0;
+  uint32_t hit_worst = 0, miss_worst = 0, hits = 0;
+  for (uint32_t key=0; key<=0xffff; key++) {
+    probes = 0;
+    bool const hit = lookup(key) >= 0;
+    hits += hit;
+    (hit ? hit_probes : miss_probes) += probes;
+    uint32_t& worst = hit ? hit_worst : miss_worst;
+    if (probes > worst) worst = probes;
+  }
+
+  auto const start = std::chrono::steady_clock::now();
+  for (int round=0; round<rounds; round++) {
+    for (uint32_t key=0; key<=0xffff; key++) found = lookup(key);
+  }
+  double const ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds / 0x10000;
+
+  printf("%-14s hit avg %7.1f worst %5u, miss avg %7.1f worst %5u probes, %7.1f ns per lookup\n", name,
+         (double) hit_probes / hits, hit_worst, (double) miss_probes / (0x10000 - hits), miss_worst, ns);
+}
+
+
+int main(int argc, char** argv)
+{
+  int const rounds = argc > 1 ? atoi(argv[1]) : 20;
+  printf("%u vendors, every id of 0..0xffff, %d rounds\n", (unsigned) usb_vids_count, rounds);
+  bench("walk (before)", walk_search, rounds);
+  bench("hash",          search<USB_IDS_SEARCH_HASH>, rounds);
+  bench("binary",        search<USB_IDS_SEARCH_BINARY>, rounds);
+  bench("interpolation", search<USB_IDS_SEARCH_INTERPOLATION>, rounds);
+  return 0;
+}
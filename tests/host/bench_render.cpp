@@ -0,0 +1,242 @@
+// Descriptor rendering, the field tables formatted by hand into the output buffer
+// (render_field()) against the printf path they replaced, a printf() per field straight to
+// stdout. Both render the standard descriptors of each device (device, configuration,
+// interface, association, endpoint, HID), the text must be the same, then the time and the
+// heap allocations of each are measured with stdout on /dev/null.
+//
+//   bench_render [ROUNDS] [DEVICE...]
+//
+// The devices are sysfs directories like those of replay, corpus/ by default.
+
+#include "sim.h"
+
+#include <chrono>
+
+
+// heap allocations made while counting, malloc() and friends of the C library are
+// interposed so printf's internal ones are seen too
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* ptr, size_t size);
+
+static bool heap_counting;
+static size_t heap_calls, heap_bytes;
+
+extern "C" void* malloc(size_t size) noexcept
+{
+  if (heap_counting) { heap_calls++; heap_bytes += size; }
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) noexcept
+{
+  if (heap_counting) { heap_calls++; heap_bytes += count * size; }
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* ptr, size_t size) noexcept
+{
+  if (heap_counting) { heap_calls++; heap_bytes += size; }
+  return __libc_realloc(ptr, size);
+}
+
+
+// what render_field() prints, formatted by printf()
+void printf_field(uint8_t daddr, const uint8_t* desc, const desc_field_t& field, const char* indent, const char* eol)
+{
+  uint32_t const value = desc_field_value(desc, field.offset, field.size);
+  const char* const colon = field.fmt == FMT_EP_ATTRIBUTES ? ":" : "";
+  int const pad = (int) field.column - (int)(strlen(field.name) + strlen(colon));
+  printf("%s%s%s%*s", indent, field.name, colon, pad > 0 ? pad : 0, "");
+  switch (field.fmt) {
+    case FMT_DEC:
+      printf("%*u", field.width, value);
+      break;
+    case FMT_HEX:
+      printf("0x%0*x", field.width, value);
+      break;
+    case FMT_BCD:
+      printf("%0*x", field.width, value);
+      break;
+    case FMT_STRING: {
+      usb_device_t* dev = get_view(daddr);
+      printf("%*u %s", field.width, value, dev ? enum_string(dev, value) : "");
+    } break;
+    case FMT_CLASS:
+    case FMT_SUBCLASS:
+    case FMT_PROTOCOL: {
+      uint8_t const* triple = &desc[field.offset - (field.fmt - FMT_CLASS)];
+      auto class_sub_proto = get_class_sub_proto(triple[0], triple[1], triple[2]);
+      printf("%*u %s", field.width, value, field.fmt == FMT_CLASS ? class_sub_proto.dev_class->name : field.fmt == FMT_SUBCLASS ? class_sub_proto.dev_subclass->name : class_sub_proto.dev_proto->name);
+    } break;
+    case FMT_VENDOR:
+    case FMT_PRODUCT: {
+      uint8_t const vendor_offset = field.fmt == FMT_VENDOR ? field.offset : field.offset - 2;
+      auto vid_pid = get_vid_pid(desc_field_value(desc, vendor_offset, 2), desc_field_value(desc, vendor_offset + 2, 2));
+      printf("0x%0*x %s", field.width, value, usb_ids_name(field.fmt == FMT_VENDOR ? vid_pid.vendor->name : vid_pid.product->name).c_str);
+    } break;
+    case FMT_EP_ADDRESS:
+      printf("0x%0*x EP %u %s", field.width, value, value & 0x0f, value & 0x80 ? "IN" : "OUT");
+      break;
+    case FMT_EP_ATTRIBUTES:
+      printf("0x%0*x%s%s  Transfer Type:   %s%s%s  Synch Type:      %s%s%s  Usage Type:      %s", field.width, value,
+             eol, indent, bmAttrXfer[value & 3], eol, indent, bmAttrSync[(value >> 2) & 3], eol, indent, bmAttrUsage[(value >> 4) & 3]);
+      break;
+    case FMT_PACKET_SIZE:
+      printf("0x%0*x  1x %u bytes", field.width, value, value);
+      break;
+    case FMT_CFG_ATTRIBUTES:
+      printf("0x%0*x", field.width, value);
+      if (value & 0b01000000) printf("%s%s  Self Powered%s%sbMaxPower               %umA", eol, indent, eol, indent, desc[field.offset + 1]);
+      if (value & 0b00100000) printf("%s%s  Remote Wakeup", eol, indent);
+      break;
+    default: break;
+  }
+  printf("%s", eol);
+}
+
+
+// a descriptor and the fields to render, as the dump lays them out
+struct job_t
+{
+  uint8_t daddr;
+  const uint8_t* desc;
+  const desc_field_t* fields;
+  size_t count;
+  const char* indent;
+  const char* eol;
+};
+
+template<size_t N>
+job_t make_job(uint8_t daddr, const uint8_t* desc, const desc_field_t (&fields)[N], const char* indent, const char* eol = "\n")
+{
+  return { daddr, desc, fields, N, indent, eol };
+}
+
+
+// the standard descriptors of the devices in core0's views, complete ones only
+std::vector<std::vector<job_t>> device_jobs(size_t count)
+{
+  std::vector<std::vector<job_t>> devices(count);
+  for (size_t i = 0; i < count; i++) {
+    uint8_t const daddr = i + 1;
+    usb_device_t* dev = get_view(daddr);
+    if (dev == NULL) continue;
+    auto& jobs = devices[i];
+    jobs.push_back(make_job(daddr, (const uint8_t*) &dev->desc, device_fields, "  ", "\r\n"));
+    jobs.push_back(make_job(daddr, (const uint8_t*) &dev->desc, device_string_fields, "  ", "\r\n"));
+    for (uint8_t c = 0; c < dev->config_count; c++) {
+      const uint8_t* const config = dev->configs[c].desc;
+      for (size_t p = 0; p + 2 <= dev->configs[c].len && config[p] >= 2; p += config[p]) {
+        const uint8_t* const desc = config + p;
+        uint8_t const len = p + desc[0] <= dev->configs[c].len ? desc[0] : 0;
+        switch (desc[1]) {
+          case TUSB_DESC_CONFIGURATION:
+            if (len >= sizeof(tusb_desc_configuration_t)) jobs.push_back(make_job(daddr, desc, config_fields, "    "));
+            break;
+          case TUSB_DESC_INTERFACE:
+            if (len >= sizeof(tusb_desc_interface_t)) jobs.push_back(make_job(daddr, desc, interface_fields, "      "));
+            break;
+          case TUSB_DESC_INTERFACE_ASSOCIATION:
+            if (len >= sizeof(tusb_desc_interface_assoc_t)) jobs.push_back(make_job(daddr, desc, interface_assoc_fields, "      "));
+            break;
+          case TUSB_DESC_ENDPOINT:
+            if (len >= sizeof(tusb_desc_endpoint_t)) jobs.push_back(make_job(0, desc, endpoint_fields, "        "));
+            break;
+          case HID_DESC_TYPE_HID:
+            if (len >= sizeof(tusb_hid_descriptor_hid_t)) jobs.push_back(make_job(0, desc, hid_fields, "          "));
+            break;
+        }
+      }
+    }
+  }
+  return devices;
+}
+
+
+// one device's fields, like print_device_descriptor() ends with a flush
+void render_table(const std::vector<job_t>& jobs)
+{
+  for (auto& job : jobs) {
+    for (size_t f = 0; f < job.count; f++) render_field(job.daddr, job.desc, job.fields[f], job.indent, job.eol);
+  }
+  out_flush();
+}
+
+
+void render_printf(const std::vector<job_t>& jobs)
+{
+  for (auto& job : jobs) {
+    for (size_t f = 0; f < job.count; f++) printf_field(job.daddr, job.desc, job.fields[f], job.indent, job.eol);
+  }
+}
+
+
+struct result_t
+{
+  double us;     // per device
+  size_t calls;  // heap allocations over all the rounds
+  size_t bytes;
+};
+
+result_t bench(void (*render)(const std::vector<job_t>&), const std::vector<std::vector<job_t>>& devices, int rounds)
+{
+  heap_calls = heap_bytes = 0;
+  heap_counting = true;
+  auto const start = std::chrono::steady_clock::now();
+  for (int round = 0; round < rounds; round++) {
+    for (auto& jobs : devices) render(jobs);
+  }
+  fflush(stdout);
+  double const us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / rounds / devices.size();
+  heap_counting = false;
+  return { us, heap_calls, heap_bytes };
+}
+
+
+int main(int argc, char** argv)
+{
+  int const rounds = argc > 1 ? atoi(argv[1]) : 20000;
+  std::vector<std::string> paths(argv + (argc > 1 ? 2 : 1), argv + argc);
+  if (paths.empty()) paths = { "corpus/pico", "corpus/mouse", "corpus/hub" };
+  if (paths.size() > DEVICES_MAX) paths.resize(DEVICES_MAX);
+
+  for (size_t i = 0; i < paths.size(); i++) {
+    sim_device_t device;
+    if (!sim_read_sysfs(paths[i].c_str(), &device)) {
+      fprintf(stderr, "%s: can't read %s\n", argv[0], paths[i].c_str());
+      return 1;
+    }
+    sim_view(i + 1, device);
+  }
+  auto const devices = device_jobs(paths.size());
+
+  // the same text both ways
+  size_t fields = 0;
+  std::string table, printed;
+  for (auto& jobs : devices) {
+    for (auto& job : jobs) fields += job.count;
+    sim_output_begin();
+    render_table(jobs);
+    table += sim_output_end();
+    sim_output_begin();
+    render_printf(jobs);
+    printed += sim_output_end();
+  }
+  if (table != printed) {
+    fprintf(stderr, "%s: the printf path renders other text\n", argv[0]);
+    return 1;
+  }
+
+  int const out = dup(STDOUT_FILENO);
+  if (freopen("/dev/null", "w", stdout) == NULL) return 1;
+  result_t const printf_path = bench(render_printf, devices, rounds);
+  result_t const table_path = bench(render_table, devices, rounds);
+  dup2(out, STDOUT_FILENO);
+
+  fprintf(stderr, "%zu devices, %zu fields, %zu bytes of text, %d rounds\n", devices.size(), fields, table.size(), rounds);
+  double const bytes = (double) table.size() / devices.size();
+  fprintf(stderr, "  printf path: %6.2f us per device (%4.0f MB/s), %zu heap allocations (%zu bytes)\n", printf_path.us, bytes / printf_path.us, printf_path.calls, printf_path.bytes);
+  fprintf(stderr, "  table path:  %6.2f us per device (%4.0f MB/s), %zu heap allocations (%zu bytes), %d bytes of static buffer\n", table_path.us, bytes / table_path.us, table_path.calls, table_path.bytes, OUT_BUF_SIZE);
+  return 0;
+}
@@ -0,0 +1,136 @@
+// The usb.ids tables on the real data: every vendor and product search strategy pair of
+// usb.org/lsusb_search.h over all the listed vid:pid and twice as many misses, then the flash
+// size of the compressed name pool against plain strings, and its decoding time per name.
+//
+//   bench_usb_ids [ROUNDS]
+
+#include <Arduino.h>
+#include <tusb.h>
+#include "usb.org/lsusb_info.h"
+
+#include <chrono>
+#include <set>
+#include <string>
+#include <vector>
+
+
+static volatile uintptr_t found; // keeps the timed lookups
+
+struct vid_pid_t { uint16_t vid, pid; };
+
+
+template<usb_ids_search_t vendor_strategy, usb_ids_search_t product_strategy>
+static usb_vid_pid_t lookup(uint16_t vendor_id, uint16_t product_id)
+{
+  int32_t const v = usb_ids_search<vendor_strategy>(vendor_id, usb_vids_count, [](size_t i) { return usb_vid_keys[i]; }, &usb_vids_mph);
+  if (v < 0) return { &nullVendor, &nullProduct };
+  const vendor_id_t* const vendor = &usb_vids[v];
+  const uint16_t* const keys = &usb_pid_keys[vendor->product_id_t_idx];
+  int32_t const p = usb_ids_search<product_strategy>(product_id, vendor->product_count, [keys](size_t i) { return keys[i]; });
+  return { vendor, p < 0 ? &nullProduct : &usb_pids[vendor->product_id_t_idx + p] };
+}
+
+
+template<usb_ids_search_t vendor_strategy, usb_ids_search_t product_strategy>
+static void bench_search(const char* name, const std::vector<vid_pid_t>& hits, const std::vector<vid_pid_t>& misses, int rounds)
+{
+  double ns[2];
+  const std::vector<vid_pid_t>* const sets[2] = { &hits, &misses };
+  for (int s=0; s<2; s++) {
+    uint32_t bad = 0;
+    for (auto& ids : *sets[s]) {
+      auto const expected = find_vid_pid(ids.vid, ids.pid);
+      auto const result = lookup<vendor_strategy, product_strategy>(ids.vid, ids.pid);
+      bad += result.vendor != expected.vendor || result.product != expected.product;
+    }
+    if (bad) printf("%s: %u lookups differ from find_vid_pid()\n", name, bad);
+    auto const start = std::chrono::steady_clock::now();
+    for (int round=0; round<rounds; round++) {
+      for (auto& ids : *sets[s]) found = (uintptr_t) lookup<vendor_strategy, product_strategy>(ids.vid, ids.pid).product;
+    }
+    ns[s] = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds / sets[s]->size();
+  }
+  printf("  %-30s %6.1f ns per hit, %6.1f ns per miss\n", name, ns[0], ns[1]);
+}
+
+
+static uint32_t offset_of(usb_ids_str_t str)
+{
+  return str.offset[0] | str.offset[1] << 8 | str.offset[2] << 16;
+}
+
+
+static void bench_names(int rounds)
+{
+  // every name once, as the pool stores it
+  std::set<uint32_t> offsets;
+  for (auto& vendor : usb_vids) offsets.insert(offset_of(vendor.name));
+  for (auto& product : usb_pids) offsets.insert(offset_of(product.name));
+  std::vector<usb_ids_str_t> names;
+  std::vector<std::string> plain;
+  size_t raw = 0;
+  for (uint32_t offset : offsets) {
+    names.push_back(USB_IDS_STR(offset));
+    plain.push_back(usb_ids_name(names.back()).c_str);
+    raw += plain.back().size() + 1;
+  }
+
+  // the tables gen.py used to emit: a pointer to a string per record, next to the ids and
+  // the product index and count, padded to 16 and 8 bytes
+  size_t const before = raw + usb_vids_count * 16 + usb_pids_count * 8;
+  size_t const tokens = sizeof(usb_ids_tokens) + sizeof(usb_ids_tokens_idx);
+  size_t const after = sizeof(usb_ids_pool) + tokens + sizeof(usb_vids) + sizeof(usb_vid_keys) + sizeof(usb_pids) + sizeof(usb_pid_keys);
+  printf("name pool: %zu names, %zu bytes plain, %zu bytes encoded + %zu bytes tokens\n", names.size(), raw, sizeof(usb_ids_pool), tokens);
+  printf("  vendor and product tables: %zu bytes with plain strings, %zu bytes with the pool (%zu bytes saved)\n", before, after, before - after);
+
+  // decoding against copying the plain string to the same buffer
+  usb_ids_name_t name;
+  auto start = std::chrono::steady_clock::now();
+  for (int round=0; round<rounds; round++) {
+    for (auto& str : names) {
+      name = usb_ids_name(str);
+      found = name.c_str[0];
+    }
+  }
+  double const decode_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds / names.size();
+  start = std::chrono::steady_clock::now();
+  for (int round=0; round<rounds; round++) {
+    for (auto& text : plain) {
+      memcpy(name.c_str, text.c_str(), text.size() + 1);
+      found = name.c_str[0];
+    }
+  }
+  double const copy_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / rounds / names.size();
+  printf("  %.1f ns per name decoded, %.1f ns per plain name copied, %.1f chars per name\n", decode_ns, copy_ns, (double) raw / names.size() - 1);
+}
+
+
+int main(int argc, char** argv)
+{
+  int const rounds = argc > 1 ? atoi(argv[1]) : 20;
+
+  // every listed vid:pid with the first unlisted product id after it, and as many misses on
+  // unlisted vendor ids
+  std::vector<vid_pid_t> hits, misses;
+  for (size_t v=0; v<usb_vids_count; v++) {
+    const uint16_t* const keys = &usb_pid_keys[usb_vids[v].product_id_t_idx];
+    for (size_t p=0; p<usb_vids[v].product_count; p++) {
+      hits.push_back({ usb_vid_keys[v], keys[p] });
+      uint16_t pid = keys[p] + 1;
+      while (find_vid_pid(usb_vid_keys[v], pid).product != &nullProduct) pid++;
+      misses.push_back({ usb_vid_keys[v], pid });
+    }
+  }
+  for (uint32_t vid=0; misses.size()<2*hits.size(); vid=(vid+7)&0xffff) {
+    if (get_vendor(vid) == &nullVendor) misses.push_back({ (uint16_t) vid, 0x0001 });
+  }
+  printf("vid:pid search, %zu hits and %zu misses, %d rounds\n", hits.size(), misses.size(), rounds);
+  bench_search<USB_IDS_SEARCH_HASH,          USB_IDS_SEARCH_BINARY>       ("hash / binary", hits, misses, rounds);
+  bench_search<USB_IDS_SEARCH_HASH,          USB_IDS_SEARCH_INTERPOLATION>("hash / interpolation", hits, misses, rounds);
+  bench_search<USB_IDS_SEARCH_BINARY,        USB_IDS_SEARCH_BINARY>       ("binary / binary", hits, misses, rounds);
+  bench_search<USB_IDS_SEARCH_BINARY,        USB_IDS_SEARCH_INTERPOLATION>("binary / interpolation", hits, misses, rounds);
+  bench_search<USB_IDS_SEARCH_INTERPOLATION, USB_IDS_SEARCH_BINARY>       ("interpolation / binary", hits, misses, rounds);
+  bench_search<USB_IDS_SEARCH_INTERPOLATION, USB_IDS_SEARCH_INTERPOLATION>("interpolation / interpolation", hits, misses, rounds);
+  bench_names(rounds);
+  return 0;
+}
@@ -0,0 +1,20 @@
+#pragma once
+// The tests' assertions: a failed CHECK() is reported and counted, check_exit() is
+// main()'s return value
+
+#include <stdio.h>
+
+static int check_failures = 0;
+
+#define CHECK(cond) do { \
+  if (!(cond)) { \
+    fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+    check_failures++; \
+  } \
+} while (0)
+
+static int check_exit(const char* name)
+{
+  printf("%s: %s\n", name, check_failures ? "FAILED" : "ok");
+  return check_failures ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+// Renders a binary capture of the sketch (console command 'b', see misc/capture.h) as the
+// text it prints in text mode: each frame goes through the sketch's own event_apply() and
+// event_render(), the console text between the frames passes through.
+//
+//   decode [--hid-report-delta] CAPTURE
+//
+// CAPTURE is - for stdin. --hid-report-delta prints only the HID report bytes that
+// changed, like the 'r' command.
+
+#include "sim.h"
+
+
+// frames out of the capture, anything else is console text
+void decode(const std::string& data, size_t* frames, size_t* bad)
+{
+  const uint8_t* const bytes = (const uint8_t*) data.data();
+  size_t text_start = 0;
+  size_t pos = 0;
+  while (pos + 1 < data.size()) {
+    if (bytes[pos] != CAPTURE_SYNC1 || bytes[pos + 1] != CAPTURE_SYNC2) {
+      pos++;
+      continue;
+    }
+    const uint8_t* const frame = bytes + pos;
+    size_t frame_end = pos + CAPTURE_HEADER_SIZE + 2;
+    if (frame_end <= data.size()) {
+      uint16_t const len = frame[5] | frame[6] << 8;
+      frame_end += len;
+      if (frame_end <= data.size()) {
+        uint16_t const crc = bytes[frame_end - 2] | bytes[frame_end - 1] << 8;
+        if (crc16_ccitt(0xFFFF, frame + 2, frame_end - 2 - pos - 2) == crc) {
+          out_flush();
+          fwrite(data.data() + text_start, 1, pos - text_start, stdout);
+          uint32_t const us = frame[7] | frame[8] << 8 | frame[9] << 16 | (uint32_t) frame[10] << 24;
+          sim_us = us;
+          // the endpoint address goes back in front of the report, where core1 put it
+          if (frame[2] == EVT_HID_REPORT) {
+            sim_event(frame[2], frame[3], &frame[4], 1, frame + CAPTURE_HEADER_SIZE, len);
+          } else {
+            sim_event(frame[2], frame[3], frame + CAPTURE_HEADER_SIZE, len);
+          }
+          event_header_t const header = { frame[2], frame[3], (uint16_t)(len + (frame[2] == EVT_HID_REPORT)), us };
+          event_render(&header, event_payload);
+          (*frames)++;
+          text_start = pos = frame_end;
+          continue;
+        }
+        (*bad)++;
+      }
+    }
+    pos++;
+  }
+  out_flush();
+  fwrite(data.data() + text_start, 1, data.size() - text_start, stdout);
+  fflush(stdout);
+}
+
+
+int main(int argc, char** argv)
+{
+  int arg = 1;
+  if (arg < argc && strcmp(argv[arg], "--hid-report-delta") == 0) {
+    hid_report_delta = true;
+    arg++;
+  }
+  if (arg + 1 != argc) {
+    fprintf(stderr, "usage: %s [--hid-report-delta] CAPTURE\n", argv[0]);
+    return 2;
+  }
+  std::string data;
+  if (strcmp(argv[arg], "-") == 0) {
+    char buf[4096];
+    size_t len;
+    while ((len = fread(buf, 1, sizeof(buf), stdin)) > 0) data.append(buf, len);
+  } else if (!sim_read_file(argv[arg], &data)) {
+    fprintf(stderr, "%s: can't read %s\n", argv[0], argv[arg]);
+    return 1;
+  }
+  size_t frames = 0, bad = 0;
+  decode(data, &frames, &bad);
+  fprintf(stderr, "Decoded %zu frames (%zu bad) from %zu bytes\n", frames, bad, data.size());
+  return 0;
+}
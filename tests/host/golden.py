@@ -0,0 +1,124 @@
+#!/usr/bin/env python3
+# Golden tests of the descriptor dump: each device of the corpus (a copy of its sysfs
+# directory) is replayed through the sketch built on the host, the output is compared
+# with <device>.txt and, field by field, with the output of lsusb -v for the same device
+# in <device>.lsusb. The field comparison report is compared with <device>.compare.
+#
+#   golden.py ./replay corpus             check every device
+#   golden.py --update ./replay corpus    rewrite the expected files, review with git diff
+
+import argparse
+import difflib
+import os
+import re
+import subprocess
+import sys
+
+
+# lsusb -v text as {field path: value}, the path is made of the enclosing sections (numbered
+# within their parent) and the field name. Columns and section name decorations differ
+# between lsusb and the sketch, e.g. "Interface Descriptor #0 (control):" is "Interface Descriptor:"
+SECTION_LEVELS = {"Device Descriptor": 0, "Device Status": 0, "Configuration Descriptor": 1, "Interface Association": 2, "Interface Descriptor": 2,
+                  "Hub Descriptor": 0, "Hub Port Status": 0, "Device Qualifier": 0}
+cre_lsusb_section = re.compile(r'^(?P<name>[A-Za-z][\w ]*?)(?: #\d+)?(?: \(.*\))?:(?:\s+(?P<value>.*))?$')
+cre_lsusb_field   = re.compile(r'^(?P<name>[a-z]+[A-Z0-9]\w*):?(?:\s+(?P<value>.*))?$')
+cre_lsusb_phrase  = re.compile(r'^(?P<name>[A-Za-z][\w\-]*(?: [\w\-]+)*?)(?::\s*|\s{2,}|$)(?P<value>.*)$')
+
+def lsusb_fields(text):
+    fields = {}
+    stack = [] # (level, section path element, children count per name)
+    for line in text.splitlines():
+        line = line.strip()
+        match = cre_lsusb_section.match(line)
+        if match and not cre_lsusb_field.match(line) and (match.group('value') is None or match.group('name') in SECTION_LEVELS):
+            name = re.sub(r'^(Generic|HID) (Endpoint Descriptor)$', r'\2', match.group('name'))
+            level = SECTION_LEVELS.get(name, 3)
+            while stack and stack[-1][0] >= level:
+                stack.pop()
+            siblings = stack[-1][2] if stack else {}
+            siblings[name] = siblings.get(name, 0) + 1
+            stack.append((level, "%s %d" % (name, siblings[name]), {}))
+            if match.group('value') is not None: # "Device Status:     0x0000"
+                fields[stack[-1][1]] = " ".join(match.group('value').split())
+            continue
+        if not stack:
+            continue # before the device descriptor: "Bus 001 Device 002: ID ...", "Device 1: ID ..."
+        match = cre_lsusb_field.match(line) or cre_lsusb_phrase.match(line)
+        if not match:
+            continue
+        path = " / ".join(element for level, element, children in stack) + " / " + match.group('name')
+        while path in fields: # repeated fields, e.g. wLANGID
+            path = path + "'"
+        fields[path] = " ".join((match.group('value') or "").split())
+    return fields
+
+
+# same value, or the same number written another way (18 and 0x12) with the same text after it
+def lsusb_value_matches(value, golden):
+    if value == golden:
+        return True
+    value_words, golden_words = value.split(" ", 1), golden.split(" ", 1)
+    try:
+        return int(value_words[0], 0) == int(golden_words[0], 0) and value_words[1:] == golden_words[1:]
+    except ValueError:
+        return False
+
+
+# per field differences against a golden lsusb -v output of the same device
+def compare_lsusb(text, golden_text):
+    fields, golden = lsusb_fields(text), lsusb_fields(golden_text)
+    report, matched = [], 0
+    for path, golden_value in golden.items():
+        if path not in fields:
+            report.append("missing   %s: %s\n" % (path, golden_value))
+        elif not lsusb_value_matches(fields[path], golden_value):
+            report.append("mismatch  %s: %s, lsusb: %s\n" % (path, fields[path], golden_value))
+        else:
+            matched += 1
+    report.append("%d of %d lsusb fields match\n" % (matched, len(golden)))
+    return "".join(report).encode('utf-8')
+
+
+# True when the file holds the expected bytes, or was rewritten to them
+def check(path, actual, update):
+    expected = b""
+    if os.path.exists(path):
+        with open(path, 'rb') as expected_file:
+            expected = expected_file.read()
+    if actual == expected:
+        return True
+    if update:
+        with open(path, 'wb') as expected_file:
+            expected_file.write(actual)
+        print("  updated %s" % path)
+        return True
+    diff = difflib.unified_diff(expected.decode('utf-8', 'replace').splitlines(True), actual.decode('utf-8', 'replace').splitlines(True), path, "actual")
+    sys.stdout.writelines("  " + line for line in diff)
+    return False
+
+
+def main():
+    arg_parser = argparse.ArgumentParser(description="Replay the corpus devices and compare the output with the expected files")
+    arg_parser.add_argument("--update", action="store_true", help="rewrite the expected files instead of failing")
+    arg_parser.add_argument("replay", help="the replay tool")
+    arg_parser.add_argument("corpus", help="directory of sysfs device directories")
+    args = arg_parser.parse_args()
+
+    failed = 0
+    devices = sorted(name for name in os.listdir(args.corpus) if os.path.isfile(os.path.join(args.corpus, name, "descriptors")))
+    for name in devices:
+        base = os.path.join(args.corpus, name)
+        text = subprocess.run([args.replay, base], stdout=subprocess.PIPE, check=True).stdout
+        ok = check(base + ".txt", text, args.update)
+        if os.path.exists(base + ".lsusb"):
+            with open(base + ".lsusb", 'r', encoding='utf-8', errors='replace') as golden_file:
+                report = compare_lsusb(text.decode('utf-8', 'replace'), golden_file.read())
+            ok = check(base + ".compare", report, args.update) and ok
+        print("%s: %s" % (name, "ok" if ok else "FAILED"))
+        failed += not ok
+    print("%d of %d devices match" % (len(devices) - failed, len(devices)))
+    return 1 if failed else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,67 @@
+// Renders Linux descriptor dumps (/sys/bus/usb/devices/<device> directories, or copies of
+// their descriptors file) with the sketch's own renderer: the descriptors reach core0's
+// copy of a device as the events core1 would push (sim_view()), then print_device_descriptor()
+// dumps it.
+//
+//   replay [--bench N] DEVICE...
+//
+// --bench renders the devices N times without output and reports the throughput.
+
+#include "sim.h"
+#include <time.h>
+
+
+// the device dumped at address daddr
+void replay(uint8_t daddr, const sim_device_t& device)
+{
+  sim_view(daddr, device);
+  print_device_descriptor(daddr);
+}
+
+
+int main(int argc, char** argv)
+{
+  long bench = 0;
+  int first = 1;
+  if (argc > 2 && strcmp(argv[1], "--bench") == 0) {
+    bench = atol(argv[2]);
+    first = 3;
+  }
+  if (first >= argc) {
+    fprintf(stderr, "usage: %s [--bench N] DEVICE...\n", argv[0]);
+    return 2;
+  }
+  std::vector<sim_device_t> devices(argc - first);
+  for (int i = first; i < argc; i++) {
+    if (!sim_read_sysfs(argv[i], &devices[i - first])) {
+      fprintf(stderr, "%s: can't read %s\n", argv[0], argv[i]);
+      return 1;
+    }
+  }
+
+  if (bench == 0) {
+    for (size_t i = 0; i < devices.size(); i++) replay(i % DEVICES_MAX + 1, devices[i]);
+    out_flush();
+    return 0;
+  }
+
+  if (freopen("/dev/null", "w", stdout) == NULL) return 1;
+  size_t descriptors = 0, bytes = 0;
+  for (auto& device : devices) {
+    bytes += device.descriptors.size();
+    descriptors += device.descriptors.size() >= sizeof(tusb_desc_device_t);
+    for (auto config : sim_configs(device.descriptors)) {
+      for (size_t p = config.first; p + 2 <= config.first + config.second && device.descriptors[p] >= 2; p += device.descriptors[p]) descriptors++;
+    }
+  }
+  timespec start, end;
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (long n = 0; n < bench; n++) {
+    for (size_t i = 0; i < devices.size(); i++) replay(i % DEVICES_MAX + 1, devices[i]);
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  double const s = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+  fprintf(stderr, "Rendered %zu descriptors (%zu bytes) %ld times in %.0f ms, %.0f descriptors/s, %.1f us per device\n",
+    descriptors, bytes, bench, s * 1000, descriptors * bench / s, s * 1e6 / (bench * devices.size()));
+  return 0;
+}
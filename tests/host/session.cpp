@@ -0,0 +1,56 @@
+// A scripted session on the simulated bus, printed in one of the output modes: two devices
+// of the corpus are plugged side by side and enumerated, send HID reports and are unplugged.
+// `make test` checks that decode renders the binary session as the text session, and that
+// the JSON Lines session validates against lsusb.schema.json.
+//
+//   session text|binary|json CORPUS
+//
+// No device is plugged twice: a device rendered from the cache prints core0's rendering
+// time, which a capture doesn't hold.
+
+#include "sim.h"
+
+
+int main(int argc, char** argv)
+{
+  if (argc != 3 || (strcmp(argv[1], "text") != 0 && strcmp(argv[1], "binary") != 0 && strcmp(argv[1], "json") != 0)) {
+    fprintf(stderr, "usage: %s text|binary|json CORPUS\n", argv[0]);
+    return 2;
+  }
+  sim_device_t pico, mouse;
+  std::string const corpus = argv[2];
+  if (!sim_read_sysfs((corpus + "/pico").c_str(), &pico) || !sim_read_sysfs((corpus + "/mouse").c_str(), &mouse)) {
+    fprintf(stderr, "%s: can't read the corpus in %s\n", argv[0], argv[2]);
+    return 1;
+  }
+  // sysfs doesn't keep string descriptor 0
+  pico.langids = mouse.langids = { 0x0409 };
+  mouse.devtree = { 1, 0, 2, TUSB_SPEED_LOW };
+
+  sim_setup();
+  capture_binary = strcmp(argv[1], "binary") == 0;
+  json_lines     = strcmp(argv[1], "json") == 0;
+
+  sim_plug(1, pico);
+  sim_plug(2, mouse);
+  sim_run(500);
+
+  uint8_t const keys[][8] = { { 0x01, 0, 0x04 }, { 0x01, 0, 0x04 }, { 0x01, 0, 0x04, 0x05 }, { 0x01 } };
+  for (auto& key : keys) {
+    sim_hid_report(1, 0x83, key, sizeof(key));
+    sim_run(10);
+  }
+  uint8_t const moves[][4] = { { 0, 1, 0xff }, { 1, 1, 0xff }, { 0, 0, 0, 1 } };
+  for (auto& move : moves) {
+    sim_hid_report(2, 0x81, move, sizeof(move));
+    sim_run(10);
+  }
+  sim_hid_report(2, 0x81, moves[0], 3, XFER_RESULT_STALLED);
+  sim_run(10);
+
+  sim_unplug(2);
+  sim_unplug(1);
+  sim_run(10);
+  out_flush();
+  return 0;
+}
@@ -0,0 +1,433 @@
+#pragma once
+// Host build of the sketch: lsusb.ino compiled against the stand-ins of stub/, and a
+// simulated bus answering the TinyUSB requests from device descriptions. Each tool and
+// test is a single translation unit including this header, like the Arduino build.
+//
+// Time only moves when the simulation says so: sim_run() alternates loop1() (core1)
+// and loop() (core0) and advances sim_us by SIM_TICK_US, a control transfer completes
+// SIM_XFER_US after it was submitted.
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+#include "lsusb.ino"
+
+#define SIM_TICK_US 100
+#define SIM_XFER_US 1000
+
+struct sim_device_t
+{
+  std::vector<uint8_t> descriptors;         // device descriptor, then every configuration descriptor, like sysfs
+  std::vector<std::string> strings;         // utf-8 by string index, empty when absent
+  std::vector<uint16_t> langids = { 0x0409 }; // string descriptor 0, the device has no strings when empty
+  hcd_devtree_info_t devtree = { 1, 0, 1, TUSB_SPEED_FULL };
+
+  void set_string(uint8_t index, const std::string& utf8)
+  {
+    if (strings.size() <= index) strings.resize(index + 1);
+    strings[index] = utf8;
+  }
+};
+
+static struct
+{
+  bool attached;
+  sim_device_t device;
+  std::vector<tuh_xfer_t> endpoints; // IN transfers waiting for data, by endpoint
+} sim_bus[DEVICES_MAX + 1];
+
+// the control pipe, one request at a time for all devices like TinyUSB
+static struct
+{
+  bool busy;
+  uint64_t due_us;
+  uint8_t daddr, type, index;
+  uint8_t* buffer;
+  uint16_t len;
+  tuh_xfer_cb_t complete_cb;
+  uintptr_t user_data;
+} sim_control;
+
+static struct
+{
+  uint32_t requests;
+  uint32_t busy; // requests refused because the pipe was in use
+} sim_stats;
+
+
+// offset and length of each configuration descriptor in a descriptors blob
+std::vector<std::pair<size_t, size_t>> sim_configs(const std::vector<uint8_t>& blob)
+{
+  std::vector<std::pair<size_t, size_t>> configs;
+  size_t p = sizeof(tusb_desc_device_t);
+  while (p + sizeof(tusb_desc_configuration_t) <= blob.size() && blob[p+1] == TUSB_DESC_CONFIGURATION) {
+    size_t total_len = blob[p+2] | blob[p+3] << 8;
+    if (total_len > blob.size() - p) total_len = blob.size() - p;
+    if (total_len < sizeof(tusb_desc_configuration_t)) break;
+    configs.push_back({ p, total_len });
+    p += total_len;
+  }
+  return configs;
+}
+
+
+// utf-8 (BMP only) to a string descriptor
+static uint16_t sim_string_descriptor(const std::string& utf8, uint8_t* out, uint16_t max_len)
+{
+  uint8_t desc[256] = { 0, TUSB_DESC_STRING };
+  size_t n = 2;
+  for (size_t i = 0; i < utf8.size() && n + 2 <= 254; ) {
+    uint8_t const c = utf8[i];
+    uint16_t code = c;
+    if (c >= 0xe0 && i + 2 < utf8.size()) { code = (c & 0x0f) << 12 | (utf8[i+1] & 0x3f) << 6 | (utf8[i+2] & 0x3f); i += 3; }
+    else if (c >= 0xc0 && i + 1 < utf8.size()) { code = (c & 0x1f) << 6 | (utf8[i+1] & 0x3f); i += 2; }
+    else i++;
+    desc[n++] = code & 0xff;
+    desc[n++] = code >> 8;
+  }
+  desc[0] = n;
+  uint16_t const len = n < max_len ? n : max_len;
+  memcpy(out, desc, len);
+  return len;
+}
+
+
+static bool sim_submit(uint8_t daddr, uint8_t type, uint8_t index, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+  if (sim_control.busy) {
+    sim_stats.busy++;
+    return false;
+  }
+  sim_stats.requests++;
+  sim_control = { true, sim_us + SIM_XFER_US, daddr, type, index, (uint8_t*) buffer, len, complete_cb, user_data };
+  return true;
+}
+
+
+bool tuh_descriptor_get_device(uint8_t daddr, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+  return sim_submit(daddr, TUSB_DESC_DEVICE, 0, buffer, len, complete_cb, user_data);
+}
+
+
+bool tuh_descriptor_get_configuration(uint8_t daddr, uint8_t index, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+  return sim_submit(daddr, TUSB_DESC_CONFIGURATION, index, buffer, len, complete_cb, user_data);
+}
+
+
+bool tuh_descriptor_get_string(uint8_t daddr, uint8_t index, uint16_t, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data)
+{
+  return sim_submit(daddr, TUSB_DESC_STRING, index, buffer, len, complete_cb, user_data);
+}
+
+
+// completes the control request once it is due, a device without the descriptor stalls it
+void tuh_task(void)
+{
+  if (!sim_control.busy || sim_us < sim_control.due_us) return;
+  sim_control.busy = false;
+  tuh_xfer_t xfer = {};
+  xfer.daddr     = sim_control.daddr;
+  xfer.result    = XFER_RESULT_STALLED;
+  xfer.user_data = sim_control.user_data;
+  if (sim_control.daddr > DEVICES_MAX || !sim_bus[sim_control.daddr].attached) return; // unplugged meanwhile
+  const sim_device_t& device = sim_bus[sim_control.daddr].device;
+  uint16_t len = 0;
+  if (sim_control.type == TUSB_DESC_DEVICE) {
+    len = device.descriptors.size() < sim_control.len ? device.descriptors.size() : sim_control.len;
+    if (len > sizeof(tusb_desc_device_t)) len = sizeof(tusb_desc_device_t);
+    memcpy(sim_control.buffer, device.descriptors.data(), len);
+    xfer.result = XFER_RESULT_SUCCESS;
+  } else if (sim_control.type == TUSB_DESC_CONFIGURATION) {
+    auto configs = sim_configs(device.descriptors);
+    if (sim_control.index < configs.size()) {
+      len = configs[sim_control.index].second < sim_control.len ? configs[sim_control.index].second : sim_control.len;
+      memcpy(sim_control.buffer, &device.descriptors[configs[sim_control.index].first], len);
+      xfer.result = XFER_RESULT_SUCCESS;
+    }
+  } else if (sim_control.index == 0) {
+    if (!device.langids.empty()) {
+      uint8_t desc[2 + 2*126] = { (uint8_t)(2 + 2*device.langids.size()), TUSB_DESC_STRING };
+      memcpy(&desc[2], device.langids.data(), 2*device.langids.size());
+      len = desc[0] < sim_control.len ? desc[0] : sim_control.len;
+      memcpy(sim_control.buffer, desc, len);
+      xfer.result = XFER_RESULT_SUCCESS;
+    }
+  } else if (sim_control.index < device.strings.size() && !device.strings[sim_control.index].empty() && !device.langids.empty()) {
+    len = sim_string_descriptor(device.strings[sim_control.index], sim_control.buffer, sim_control.len);
+    xfer.result = XFER_RESULT_SUCCESS;
+  }
+  xfer.actual_len = len;
+  sim_control.complete_cb(&xfer);
+}
+
+
+bool tuh_vid_pid_get(uint8_t daddr, uint16_t* vid, uint16_t* pid)
+{
+  if (daddr > DEVICES_MAX || !sim_bus[daddr].attached || sim_bus[daddr].device.descriptors.size() < sizeof(tusb_desc_device_t)) return false;
+  tusb_desc_device_t desc;
+  memcpy(&desc, sim_bus[daddr].device.descriptors.data(), sizeof(desc));
+  *vid = desc.idVendor;
+  *pid = desc.idProduct;
+  return true;
+}
+
+
+void hcd_devtree_get_info(uint8_t daddr, hcd_devtree_info_t* devtree_info)
+{
+  *devtree_info = daddr <= DEVICES_MAX ? sim_bus[daddr].device.devtree : hcd_devtree_info_t{};
+}
+
+
+bool tuh_configure(uint8_t, uint32_t, const void*) { return true; }
+bool tuh_init(uint8_t) { return true; }
+bool tuh_hid_receive_report(uint8_t, uint8_t) { return true; }
+bool tuh_edpt_open(uint8_t, tusb_desc_endpoint_t const*) { return true; }
+
+
+// bInterfaceProtocol of the instance-th HID interface of the first configuration
+uint8_t tuh_hid_interface_protocol(uint8_t daddr, uint8_t instance)
+{
+  if (daddr > DEVICES_MAX) return HID_ITF_PROTOCOL_NONE;
+  const std::vector<uint8_t>& blob = sim_bus[daddr].device.descriptors;
+  auto configs = sim_configs(blob);
+  if (configs.empty()) return HID_ITF_PROTOCOL_NONE;
+  for (size_t p = configs[0].first; p + 2 <= configs[0].first + configs[0].second && blob[p] >= 2; p += blob[p]) {
+    if (blob[p+1] == TUSB_DESC_INTERFACE && blob[p+5] == TUSB_CLASS_HID && blob[p+3] == 0 && instance-- == 0) return blob[p+7];
+  }
+  return HID_ITF_PROTOCOL_NONE;
+}
+
+
+// TinyUSB 0.15's parser, reduced to the usage page, usage and report ID of each top level collection
+uint8_t tuh_hid_parse_report_descriptor(tuh_hid_report_info_t* report_info_arr, uint8_t arr_count, uint8_t const* desc_report, uint16_t desc_len)
+{
+  memset(report_info_arr, 0, arr_count * sizeof(tuh_hid_report_info_t));
+  uint8_t report_num = 0, depth = 0;
+  tuh_hid_report_info_t* info = report_info_arr;
+  while (desc_len > 0 && report_num < arr_count) {
+    uint8_t const header = *desc_report++;
+    desc_len--;
+    uint8_t const tag = header >> 4, type = (header >> 2) & 3, size = (header & 3) == 3 ? 4 : header & 3;
+    if (size > desc_len) break;
+    if (type == 0) { // main
+      if (tag == 0xa) depth++;
+      else if (tag == 0xc && depth > 0 && --depth == 0) { info++; report_num++; }
+    } else if (type == 1) { // global
+      if (tag == 0 && depth == 0) memcpy(&info->usage_page, desc_report, size > 2 ? 2 : size);
+      else if (tag == 8 && size > 0) info->report_id = desc_report[0];
+    } else if (type == 2) { // local
+      if (tag == 0 && depth == 0 && size > 0) info->usage = desc_report[0];
+    }
+    desc_report += size;
+    desc_len -= size;
+  }
+  return report_num;
+}
+
+
+// the sketch re-submits each IN transfer from its completion callback
+bool tuh_edpt_xfer(tuh_xfer_t* xfer)
+{
+  if (xfer->daddr > DEVICES_MAX) return false;
+  auto& endpoints = sim_bus[xfer->daddr].endpoints;
+  for (auto& pending : endpoints) {
+    if (pending.ep_addr == xfer->ep_addr) {
+      pending = *xfer;
+      return true;
+    }
+  }
+  endpoints.push_back(*xfer);
+  return true;
+}
+
+
+//--------------------------------------------------------------------+
+// Driving the simulation
+//--------------------------------------------------------------------+
+
+void sim_setup()
+{
+  setup();
+  setup1();
+}
+
+
+void sim_run(uint32_t ms)
+{
+  uint64_t const end_us = sim_us + ms * 1000ULL;
+  while (sim_us < end_us) {
+    loop1();
+    loop();
+    sim_us += SIM_TICK_US;
+  }
+}
+
+
+void sim_console(const char* chars)
+{
+  for (; *chars && Serial.input_len < sizeof(Serial.input); chars++) Serial.input[Serial.input_len++] = *chars;
+}
+
+
+void sim_plug(uint8_t daddr, const sim_device_t& device)
+{
+  sim_bus[daddr].attached = true;
+  sim_bus[daddr].device = device;
+  sim_bus[daddr].endpoints.clear();
+  tuh_mount_cb(daddr);
+}
+
+
+void sim_unplug(uint8_t daddr)
+{
+  sim_bus[daddr].attached = false;
+  sim_bus[daddr].endpoints.clear();
+  if (sim_control.busy && sim_control.daddr == daddr) sim_control.busy = false;
+  tuh_umount_cb(daddr);
+}
+
+
+// a report on an IN endpoint the sketch listens to, false when it doesn't
+bool sim_hid_report(uint8_t daddr, uint8_t ep_addr, const uint8_t* data, uint16_t len, uint8_t result = XFER_RESULT_SUCCESS)
+{
+  for (auto pending : sim_bus[daddr].endpoints) {
+    if (pending.ep_addr != ep_addr) continue;
+    len = len < pending.buflen ? len : pending.buflen;
+    memcpy((uint8_t*) pending.user_data, data, len);
+    pending.actual_len = len;
+    pending.result = result;
+    pending.complete_cb(&pending);
+    return true;
+  }
+  return false;
+}
+
+
+// core0's side of an event, without going through the ring: what the replay and the
+// capture decoder feed the renderer with
+void sim_event(uint8_t type, uint8_t daddr, const void* data = nullptr, size_t len = 0, const void* data2 = nullptr, size_t len2 = 0)
+{
+  event_header_t const header = { type, daddr, (uint16_t)(len + len2), (uint32_t) micros() };
+  if (len > 0) memcpy(event_payload, data, len);
+  if (len2 > 0) memcpy(event_payload + len, data2, len2);
+  event_apply(&header, event_payload);
+}
+
+
+// core0's copy of a device at address daddr, from the snapshot enum_push_device() sends
+void sim_view(uint8_t daddr, const sim_device_t& device)
+{
+  sim_event(EVT_UNMOUNT, daddr);
+  if (device.descriptors.size() < sizeof(tusb_desc_device_t)) return;
+  sim_event(EVT_DEVICE, daddr, device.descriptors.data(), sizeof(tusb_desc_device_t), device.langids.data(), device.langids.size() * sizeof(uint16_t));
+  for (size_t index = 1; index < device.strings.size(); index++) {
+    if (device.strings[index].empty()) continue;
+    uint8_t const string_index = index;
+    sim_event(EVT_STRING, daddr, &string_index, 1, device.strings[index].data(), device.strings[index].size());
+  }
+  for (auto config : sim_configs(device.descriptors)) {
+    sim_event(EVT_CONFIG, daddr, &device.descriptors[config.first], config.second);
+  }
+  event_device_end_t const end = { END_ENUMERATED, 0, 0 };
+  sim_event(EVT_DEVICE_END, daddr, &end, sizeof(end));
+}
+
+
+// everything the sketch prints between sim_output_begin() and sim_output_end(), for the
+// tests to look at instead of stdout
+static FILE* sim_output_file;
+static int sim_output_stdout = -1;
+
+void sim_output_begin()
+{
+  fflush(stdout);
+  sim_output_file = tmpfile();
+  sim_output_stdout = dup(STDOUT_FILENO);
+  dup2(fileno(sim_output_file), STDOUT_FILENO);
+}
+
+
+std::string sim_output_end()
+{
+  out_flush();
+  fflush(stdout);
+  dup2(sim_output_stdout, STDOUT_FILENO);
+  close(sim_output_stdout);
+  std::string output;
+  char buf[4096];
+  size_t len;
+  rewind(sim_output_file);
+  while ((len = fread(buf, 1, sizeof(buf), sim_output_file)) > 0) output.append(buf, len);
+  fclose(sim_output_file);
+  return output;
+}
+
+
+size_t sim_count(const std::string& text, const std::string& what)
+{
+  size_t count = 0;
+  for (size_t pos = text.find(what); pos != std::string::npos; pos = text.find(what, pos + what.size())) count++;
+  return count;
+}
+
+
+//--------------------------------------------------------------------+
+// Linux sysfs devices
+//--------------------------------------------------------------------+
+
+static bool sim_read_file(const std::string& path, std::string* content)
+{
+  FILE* file = fopen(path.c_str(), "rb");
+  if (file == NULL) return false;
+  char buf[4096];
+  size_t n;
+  content->clear();
+  while ((n = fread(buf, 1, sizeof(buf), file)) > 0) content->append(buf, n);
+  fclose(file);
+  return true;
+}
+
+
+// a /sys/bus/usb/devices/<device> directory, or a copy of its descriptors file. The strings
+// are those sysfs has: manufacturer, product, serial and the interfaces of the active
+// configuration. Linux doesn't keep the LANGIDs
+bool sim_read_sysfs(const char* path, sim_device_t* device)
+{
+  std::string blob, dir = path;
+  while (dir.size() > 1 && dir.back() == '/') dir.pop_back();
+  bool const is_dir = sim_read_file(dir + "/descriptors", &blob);
+  if (!is_dir && !sim_read_file(dir, &blob)) return false;
+  *device = sim_device_t();
+  device->langids.clear();
+  device->descriptors.assign(blob.begin(), blob.end());
+  if (!is_dir || blob.size() < sizeof(tusb_desc_device_t)) return true;
+
+  auto read_string = [&](const std::string& name, uint8_t index) {
+    std::string value;
+    if (index == 0 || !sim_read_file(dir + "/" + name, &value)) return;
+    while (!value.empty() && value.back() == '\n') value.pop_back();
+    device->set_string(index, value);
+  };
+  const std::vector<uint8_t>& d = device->descriptors;
+  read_string("manufacturer", d[14]);
+  read_string("product", d[15]);
+  read_string("serial", d[16]);
+
+  std::string value;
+  if (!sim_read_file(dir + "/bConfigurationValue", &value)) return true;
+  int const active = atoi(value.c_str());
+  std::string const name = dir.substr(dir.find_last_of('/') + 1);
+  for (auto config : sim_configs(d)) {
+    if (d[config.first + 5] != active) continue;
+    for (size_t p = config.first; p + 9 <= config.first + config.second && d[p] >= 2; p += d[p]) {
+      if (d[p+1] == TUSB_DESC_INTERFACE && d[p+3] == 0) {
+        read_string(name + ":" + std::to_string(active) + "." + std::to_string(d[p+2]) + "/interface", d[p+8]);
+      }
+    }
+  }
+  return true;
+}
@@ -0,0 +1,2 @@
+#pragma once
+// Host stand-in, the Adafruit layer adds nothing the sketch uses directly
@@ -0,0 +1,37 @@
+#pragma once
+// Host stand-in for the parts of the arduino-pico core the sketch uses. Time is the
+// simulated clock of sim.h, Serial is the console: input queued by the test, output
+// through stdout like the sketch's printf.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+inline uint64_t sim_us = 0; // advanced by the simulation, see sim.h
+
+inline unsigned long micros() { return (unsigned long) sim_us; }
+inline unsigned long millis() { return (unsigned long) (sim_us / 1000); }
+inline void delay(unsigned long ms) { sim_us += ms * 1000; }
+
+static inline long map(long x, long in_min, long in_max, long out_min, long out_max)
+{
+  return (x - in_min) * (out_max - out_min) / (in_max - in_min) + out_min;
+}
+
+struct HardwareSerial
+{
+  char input[64];
+  size_t input_len = 0, input_pos = 0;
+  void begin(unsigned long) {}
+  void end() {}
+  operator bool() { return true; }
+  int available() { return (int) (input_len - input_pos); }
+  int read() { return input_pos < input_len ? input[input_pos++] : -1; }
+  size_t write(const uint8_t* data, size_t len) { return fwrite(data, 1, len, stdout); }
+  size_t write(uint8_t c) { return write(&c, 1); }
+  void flush() { fflush(stdout); }
+};
+
+inline HardwareSerial Serial, Serial1;
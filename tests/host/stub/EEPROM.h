@@ -0,0 +1,16 @@
+#pragma once
+// Host stand-in for the arduino-pico EEPROM library: one 4KB sector in RAM, a test
+// writes into data to play a sector left by another firmware
+
+#include <string.h>
+
+struct EEPROMClass
+{
+  uint8_t data[4096];
+  void begin(size_t) {}
+  template<typename T> T& get(int address, T& t) { memcpy(&t, data + address, sizeof(T)); return t; }
+  template<typename T> const T& put(int address, const T& t) { memcpy(data + address, &t, sizeof(T)); return t; }
+  bool commit() { return true; }
+};
+
+inline EEPROMClass EEPROM;
@@ -0,0 +1,2 @@
+#pragma once
+// Host stand-in, hcd_devtree_get_info() is declared in tusb.h
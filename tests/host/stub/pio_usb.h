@@ -0,0 +1,8 @@
+#pragma once
+// Host stand-in for Pico-PIO-USB and the pico-sdk clock query
+
+typedef struct { uint8_t pin_dp; } pio_usb_configuration_t;
+#define PIO_USB_DEFAULT_CONFIG { 0 }
+
+enum { clk_sys = 5 };
+inline uint32_t clock_get_hz(int) { return 120000000UL; }
@@ -0,0 +1,230 @@
+#pragma once
+// Host stand-in for the parts of TinyUSB the sketch uses: same names, values and
+// packed layouts as TinyUSB 0.15. The host stack functions are answered by sim.h.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define TU_ATTR_PACKED __attribute__((packed))
+#define TU_ATTR_UNUSED __attribute__((unused))
+#define TU_ARRAY_SIZE(a) (sizeof(a)/sizeof(a[0]))
+
+#if !defined CFG_TUH_CDC
+  #define CFG_TUH_CDC 1
+#endif
+#if !defined CFG_TUH_MSC
+  #define CFG_TUH_MSC 0
+#endif
+#if !defined CFG_TUH_HID
+  #define CFG_TUH_HID 4
+#endif
+#if !defined CFG_TUH_DEVICE_MAX
+  #define CFG_TUH_DEVICE_MAX 4
+#endif
+#if !defined CFG_TUH_HUB
+  #define CFG_TUH_HUB 1
+#endif
+
+#define OPT_MODE_DEVICE    0x0001
+#define OPT_MODE_LOW_SPEED 0x0100
+#define TUH_CFGID_RPI_PIO_USB_CONFIGURATION 100
+
+typedef enum { XFER_RESULT_SUCCESS = 0, XFER_RESULT_FAILED, XFER_RESULT_STALLED, XFER_RESULT_TIMEOUT, XFER_RESULT_INVALID } xfer_result_t;
+
+enum
+{
+  TUSB_DESC_DEVICE = 1, TUSB_DESC_CONFIGURATION = 2, TUSB_DESC_STRING = 3, TUSB_DESC_INTERFACE = 4, TUSB_DESC_ENDPOINT = 5,
+  TUSB_DESC_INTERFACE_ASSOCIATION = 0x0B, TUSB_DESC_CS_INTERFACE = 0x24, TUSB_DESC_CS_ENDPOINT = 0x25
+};
+
+typedef enum
+{
+  TUSB_CLASS_UNSPECIFIED = 0, TUSB_CLASS_AUDIO = 1, TUSB_CLASS_CDC = 2, TUSB_CLASS_HID = 3, TUSB_CLASS_RESERVED_4 = 4,
+  TUSB_CLASS_PHYSICAL = 5, TUSB_CLASS_IMAGE = 6, TUSB_CLASS_PRINTER = 7, TUSB_CLASS_MSC = 8, TUSB_CLASS_HUB = 9,
+  TUSB_CLASS_CDC_DATA = 10, TUSB_CLASS_SMART_CARD = 11, TUSB_CLASS_RESERVED_12 = 12, TUSB_CLASS_CONTENT_SECURITY = 13,
+  TUSB_CLASS_VIDEO = 14, TUSB_CLASS_PERSONAL_HEALTHCARE = 15, TUSB_CLASS_AUDIO_VIDEO = 16, TUSB_CLASS_DIAGNOSTIC = 0xDC,
+  TUSB_CLASS_WIRELESS_CONTROLLER = 0xE0, TUSB_CLASS_MISC = 0xEF, TUSB_CLASS_APPLICATION_SPECIFIC = 0xFE,
+  TUSB_CLASS_VENDOR_SPECIFIC = 0xFF
+} tusb_class_code_t;
+
+typedef enum { TUSB_DIR_OUT = 0, TUSB_DIR_IN = 1, TUSB_DIR_IN_MASK = 0x80 } tusb_dir_t;
+typedef enum { TUSB_SPEED_FULL = 0, TUSB_SPEED_LOW = 1, TUSB_SPEED_HIGH = 2, TUSB_SPEED_INVALID = 0xff } tusb_speed_t;
+
+enum { HID_DESC_TYPE_HID = 0x21, HID_DESC_TYPE_REPORT = 0x22 };
+enum { HID_ITF_PROTOCOL_NONE = 0, HID_ITF_PROTOCOL_KEYBOARD = 1, HID_ITF_PROTOCOL_MOUSE = 2 };
+enum { HID_USAGE_PAGE_DESKTOP = 0x01 };
+enum { HID_USAGE_DESKTOP_KEYBOARD = 0x06 };
+enum { AUDIO_SUBCLASS_UNDEFINED = 0, AUDIO_SUBCLASS_CONTROL = 1, AUDIO_SUBCLASS_STREAMING = 2, AUDIO_SUBCLASS_MIDI_STREAMING = 3 };
+enum { AUDIO_CS_AC_INTERFACE_SELECTOR_UNIT = 0x05 };
+enum { MIDI_CS_INTERFACE_HEADER = 1, MIDI_CS_INTERFACE_IN_JACK = 2, MIDI_CS_INTERFACE_OUT_JACK = 3, MIDI_CS_INTERFACE_ELEMENT = 4 };
+enum { MIDI_JACK_EMBEDDED = 1, MIDI_JACK_EXTERNAL = 2 };
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  bLength, bDescriptorType;
+  uint16_t bcdUSB;
+  uint8_t  bDeviceClass, bDeviceSubClass, bDeviceProtocol, bMaxPacketSize0;
+  uint16_t idVendor, idProduct, bcdDevice;
+  uint8_t  iManufacturer, iProduct, iSerialNumber, bNumConfigurations;
+} tusb_desc_device_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  bLength, bDescriptorType;
+  uint16_t wTotalLength;
+  uint8_t  bNumInterfaces, bConfigurationValue, iConfiguration, bmAttributes, bMaxPower;
+} tusb_desc_configuration_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t bLength, bDescriptorType, bInterfaceNumber, bAlternateSetting, bNumEndpoints;
+  uint8_t bInterfaceClass, bInterfaceSubClass, bInterfaceProtocol, iInterface;
+} tusb_desc_interface_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t bLength, bDescriptorType, bFirstInterface, bInterfaceCount;
+  uint8_t bFunctionClass, bFunctionSubClass, bFunctionProtocol, iFunction;
+} tusb_desc_interface_assoc_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t bLength, bDescriptorType, bEndpointAddress;
+  struct TU_ATTR_PACKED { uint8_t xfer : 2; uint8_t sync : 2; uint8_t usage : 2; uint8_t : 2; } bmAttributes;
+  uint16_t wMaxPacketSize;
+  uint8_t  bInterval;
+} tusb_desc_endpoint_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  bLength, bDescriptorType;
+  uint16_t unicode_string[];
+} tusb_desc_string_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  bLength, bDescriptorType;
+  uint16_t bcdHID;
+  uint8_t  bCountryCode, bNumDescriptors, bReportType;
+  uint16_t wReportLength;
+} tusb_hid_descriptor_hid_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  bLength, bDescriptorType, bDescriptorSubType;
+  uint16_t bcdADC;
+  uint8_t  bCategory;
+  uint16_t wTotalLength;
+  uint8_t  bmControls;
+} audio_desc_cs_ac_interface_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  bLength, bDescriptorType, bDescriptorSubType, bTerminalLink, bmControls, bFormatType;
+  uint32_t bmFormats;
+  uint8_t  bNrChannels;
+  uint32_t bmChannelConfig;
+  uint8_t  iChannelNames;
+} audio_desc_cs_as_interface_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  bLength, bDescriptorType, bDescriptorSubType;
+  uint16_t bcdMSC;
+  uint16_t wTotalLength;
+} midi_desc_header_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t bLength, bDescriptorType, bDescriptorSubType, bJackType, bJackID, iJack;
+} midi_desc_in_jack_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t bLength, bDescriptorType, bDescriptorSubType, bJackType, bJackID, bNrInputPins, baSourceID, baSourcePin, iJack;
+} midi_desc_out_jack_t;
+
+enum
+{
+  CDC_FUNC_DESC_HEADER = 0x00, CDC_FUNC_DESC_CALL_MANAGEMENT = 0x01, CDC_FUNC_DESC_ABSTRACT_CONTROL_MANAGEMENT = 0x02,
+  CDC_FUNC_DESC_UNION = 0x06
+};
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t  bLength, bDescriptorType, bDescriptorSubType;
+  uint16_t bcdCDC;
+} cdc_desc_func_header_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t bLength, bDescriptorType, bDescriptorSubType;
+  struct { uint8_t handle_call : 1; uint8_t send_recv_call : 1; uint8_t : 6; } bmCapabilities;
+  uint8_t bDataInterface;
+} cdc_desc_func_call_management_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t support_comm_request : 1, support_line_request : 1, support_send_break : 1, support_notification_network_connection : 1, : 4;
+} cdc_acm_capability_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t bLength, bDescriptorType, bDescriptorSubType;
+  cdc_acm_capability_t bmCapabilities;
+} cdc_desc_func_acm_t;
+
+typedef struct TU_ATTR_PACKED
+{
+  uint8_t bLength, bDescriptorType, bDescriptorSubType, bControlInterface, bSubordinateInterface;
+} cdc_desc_func_union_t;
+
+typedef struct
+{
+  uint8_t  report_id;
+  uint8_t  usage;
+  uint16_t usage_page;
+} tuh_hid_report_info_t;
+
+typedef struct tuh_xfer_s tuh_xfer_t;
+typedef void (*tuh_xfer_cb_t)(tuh_xfer_t* xfer);
+
+struct tuh_xfer_s
+{
+  uint8_t daddr;
+  uint8_t ep_addr;
+  uint8_t result;
+  uint32_t actual_len;
+  void* setup;
+  uint32_t buflen;
+  uint8_t* buffer;
+  tuh_xfer_cb_t complete_cb;
+  uintptr_t user_data;
+  uint32_t timeout_ms;
+};
+
+typedef struct { uint8_t rhport, hub_addr, hub_port, speed; } hcd_devtree_info_t;
+
+static inline uint8_t tu_desc_len(void const* desc) { return ((uint8_t const*) desc)[0]; }
+static inline uint8_t tu_desc_type(void const* desc) { return ((uint8_t const*) desc)[1]; }
+static inline uint8_t const* tu_desc_next(void const* desc) { return (uint8_t const*) desc + tu_desc_len(desc); }
+static inline uint16_t tu_le16toh(uint16_t value) { return value; }
+static inline tusb_dir_t tu_edpt_dir(uint8_t addr) { return (addr & 0x80) ? TUSB_DIR_IN : TUSB_DIR_OUT; }
+
+// sim.h
+bool tuh_configure(uint8_t rhport, uint32_t cfg_id, const void* cfg_param);
+bool tuh_init(uint8_t rhport);
+void tuh_task(void);
+bool tuh_vid_pid_get(uint8_t daddr, uint16_t* vid, uint16_t* pid);
+void hcd_devtree_get_info(uint8_t daddr, hcd_devtree_info_t* devtree_info);
+bool tuh_descriptor_get_device(uint8_t daddr, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+bool tuh_descriptor_get_configuration(uint8_t daddr, uint8_t index, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+bool tuh_descriptor_get_string(uint8_t daddr, uint8_t index, uint16_t language_id, void* buffer, uint16_t len, tuh_xfer_cb_t complete_cb, uintptr_t user_data);
+uint8_t tuh_hid_interface_protocol(uint8_t daddr, uint8_t instance);
+uint8_t tuh_hid_parse_report_descriptor(tuh_hid_report_info_t* report_info_arr, uint8_t arr_count, uint8_t const* desc_report, uint16_t desc_len);
+bool tuh_hid_receive_report(uint8_t daddr, uint8_t instance);
+bool tuh_edpt_open(uint8_t daddr, tusb_desc_endpoint_t const* desc_ep);
+bool tuh_edpt_xfer(tuh_xfer_t* xfer);
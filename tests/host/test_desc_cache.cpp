@@ -0,0 +1,219 @@
+// Descriptor cache (misc/desc_cache.h) with the enumeration of lsusb.host.h: identical
+// units, corrupt and oversized entries, eviction in the shared arena and the layout
+// check of the flash sector. Built with DESC_CACHE_FLASH, the arena of the 4KB sector.
+
+#define DESC_CACHE_FLASH
+#include "sim.h"
+#include "check.h"
+
+
+// a vendor specific device, padded with vendor descriptors to config_len bytes of configuration
+sim_device_t make_device(uint16_t pid, const char* serial, uint16_t config_len)
+{
+  sim_device_t device;
+  uint8_t const desc[18] = { 18, TUSB_DESC_DEVICE, 0x00, 0x02, 0, 0, 0, 64, 0xfe, 0xca, (uint8_t) pid, (uint8_t)(pid >> 8), 0x00, 0x01, 1, 2, (uint8_t)(serial ? 3 : 0), 1 };
+  uint8_t const config[18] = { 9, TUSB_DESC_CONFIGURATION, (uint8_t) config_len, (uint8_t)(config_len >> 8), 1, 1, 0, 0x80, 50,
+                               9, TUSB_DESC_INTERFACE, 0, 0, 0, TUSB_CLASS_VENDOR_SPECIFIC, 0, 0, 0 };
+  device.descriptors.assign(desc, desc + sizeof(desc));
+  device.descriptors.insert(device.descriptors.end(), config, config + sizeof(config));
+  for (size_t left = config_len - sizeof(config); left > 0; ) {
+    uint8_t const len = left > 255 ? (left - 255 >= 2 ? 255 : 253) : left;
+    device.descriptors.push_back(len);
+    device.descriptors.push_back(0x41);
+    device.descriptors.insert(device.descriptors.end(), len - 2, 0x5a);
+    left -= len;
+  }
+  device.set_string(1, "Maker");
+  device.set_string(2, "Gadget");
+  if (serial) device.set_string(3, serial);
+  return device;
+}
+
+
+// what plugging the device at address 1 prints, until it is enumerated or verified
+std::string plug(const sim_device_t& device)
+{
+  sim_output_begin();
+  sim_plug(1, device);
+  sim_run(200);
+  sim_unplug(1);
+  sim_run(1);
+  return sim_output_end();
+}
+
+
+size_t used_entries()
+{
+  size_t count = 0;
+  for (auto& entry : desc_cache.entries) count += entry.lru != 0;
+  return count;
+}
+
+
+void test_identical_units()
+{
+  auto const unit_a = make_device(0x0001, "UNIT-A", 64);
+  auto const unit_b = make_device(0x0001, "UNIT-B", 64);
+  std::string output = plug(unit_a);
+  CHECK(sim_count(output, "Device Descriptor:") == 1 && sim_count(output, "enumerated in") == 1);
+
+  // the entry of unit A is the most recent for the vid:pid, nothing of it may be shown
+  output = plug(unit_b);
+  CHECK(sim_count(output, "Device Descriptor:") == 1);
+  CHECK(sim_count(output, "UNIT-A") == 0);
+  CHECK(sim_count(output, "UNIT-B") == 1 && sim_count(output, "enumerated in") == 1);
+
+  output = plug(unit_a);
+  CHECK(sim_count(output, "Device Descriptor:") == 1);
+  CHECK(sim_count(output, "UNIT-B") == 0);
+  CHECK(sim_count(output, "UNIT-A") == 2); // the dump and the other unit log
+  CHECK(sim_count(output, "rendered from cache") == 1);
+  CHECK(sim_count(output, "cache verified in 2000 us, 2 transfers") == 1); // device descriptor and serial
+
+  // no serial number: rendered before the verification, all units share the entry
+  auto const plain = make_device(0x0002, NULL, 64);
+  plug(plain);
+  output = plug(plain);
+  CHECK(sim_count(output, "Device Descriptor:") == 1 && sim_count(output, "rendered from cache") == 1);
+}
+
+
+void test_corrupt_entry()
+{
+  auto const device = make_device(0x0003, "CORRUPT", 64);
+  plug(device);
+  auto entry = desc_cache_find(0xcafe, 0x0003);
+  CHECK(entry != NULL);
+  if (entry == NULL) return;
+
+  uint32_t const stale = desc_cache_stats.stale;
+  entry->string_count = STRINGS_MAX + 1;
+  std::string output = plug(device);
+  CHECK(desc_cache_stats.stale == stale + 1);
+  CHECK(sim_count(output, "Device Descriptor:") == 1 && sim_count(output, "enumerated in") == 1);
+
+  // a string length running past the blob
+  entry = desc_cache_find(0xcafe, 0x0003);
+  CHECK(entry != NULL && desc_cache_check(entry));
+  if (entry == NULL) return;
+  desc_cache.arena[entry->blob_offset + 1] = 200;
+  CHECK(!desc_cache_check(entry));
+  output = plug(device);
+  CHECK(desc_cache_stats.stale == stale + 2);
+  CHECK(sim_count(output, "enumerated in") == 1);
+
+  // a configuration length running past the blob
+  entry = desc_cache_find(0xcafe, 0x0003);
+  CHECK(entry != NULL);
+  if (entry == NULL) return;
+  entry->blob_len -= 10;
+  CHECK(!desc_cache_check(entry));
+  entry->blob_len += 10;
+  CHECK(desc_cache_check(entry));
+}
+
+
+void test_sizes()
+{
+  // the 1159 bytes composite didn't fit the former fixed 768 bytes blob
+  auto const composite = make_device(0x0004, "COMPOSITE", 1159 - 18);
+  uint32_t const too_large = desc_cache_stats.too_large;
+  plug(composite);
+  CHECK(desc_cache_stats.too_large == too_large);
+  auto entry = desc_cache_find(0xcafe, 0x0004);
+  CHECK(entry != NULL && entry->blob_len > 1159 - 18);
+  std::string output = plug(composite);
+  CHECK(sim_count(output, "rendered from cache") == 1);
+
+  // larger than the arena: counted, and the cached entries stay as they are
+  static uint8_t before[sizeof(desc_cache)];
+  memcpy(before, &desc_cache, sizeof(desc_cache));
+  auto const huge = make_device(0x0005, "HUGE", DESC_CACHE_ARENA);
+  output = plug(huge);
+  CHECK(desc_cache_stats.too_large == too_large + 1);
+  CHECK(memcmp(before, &desc_cache, sizeof(desc_cache)) == 0);
+  CHECK(sim_count(output, "enumerated in") == 1);
+
+  // large devices evict the least recently used entries, the others stay intact
+  for (uint16_t pid = 0x0010; pid < 0x0018; pid++) {
+    plug(make_device(pid, "FILL", 900));
+    auto last = desc_cache_find(0xcafe, pid);
+    CHECK(last != NULL && last->lru == desc_cache.lru_clock);
+    size_t used = 0;
+    for (auto& entry : desc_cache.entries) {
+      if (entry.lru == 0) continue;
+      CHECK(desc_cache_check(&entry));
+      used += entry.blob_len;
+    }
+    CHECK(used <= DESC_CACHE_ARENA);
+  }
+  CHECK(desc_cache_find(0xcafe, 0x0004) == NULL);
+  CHECK(desc_cache_find(0xcafe, 0x0017) != NULL && desc_cache_find(0xcafe, 0x0016) != NULL);
+  output = plug(make_device(0x0016, "FILL", 900));
+  CHECK(sim_count(output, "rendered from cache") == 1);
+}
+
+
+void test_flash_layout()
+{
+  CHECK(used_entries() > 0);
+  desc_cache_save();
+  static uint8_t saved[sizeof(EEPROM.data)];
+  memcpy(saved, EEPROM.data, sizeof(saved));
+  size_t const used = used_entries();
+
+  desc_cache_load();
+  CHECK(used_entries() == used);
+
+  // another layout version, or another entry size (e.g. a build with another STRING_LEN)
+  EEPROM.data[4]++;
+  desc_cache_load();
+  CHECK(used_entries() == 0);
+  memcpy(EEPROM.data, saved, sizeof(saved));
+  EEPROM.data[6]++;
+  desc_cache_load();
+  CHECK(used_entries() == 0);
+
+  // a corrupt entry alone is dropped
+  memcpy(EEPROM.data, saved, sizeof(saved));
+  size_t const first_used = (desc_cache.entries[0].lru ? 0 : 1);
+  desc_cache_entry_t entry;
+  size_t const offset = DESC_CACHE_HEADER_SIZE + first_used * sizeof(entry);
+  memcpy(&entry, EEPROM.data + offset, sizeof(entry));
+  entry.config_count = CONFIGS_MAX + 1;
+  memcpy(EEPROM.data + offset, &entry, sizeof(entry));
+  desc_cache_load();
+  CHECK(used_entries() == used - 1);
+
+  // overlapping blobs discard the sector
+  memcpy(EEPROM.data, saved, sizeof(saved));
+  desc_cache_load();
+  desc_cache_entry_t* a = NULL;
+  desc_cache_entry_t* b = NULL;
+  for (auto& e : desc_cache.entries) {
+    if (e.lru == 0) continue;
+    if (a == NULL) a = &e;
+    else if (b == NULL) b = &e;
+  }
+  CHECK(a != NULL && b != NULL);
+  if (a == NULL || b == NULL) return;
+  b->blob_offset = a->blob_offset;
+  desc_cache_save();
+  desc_cache_load();
+  CHECK(used_entries() == 0);
+}
+
+
+int main()
+{
+  sim_output_begin();
+  sim_setup();
+  sim_output_end();
+  CHECK(used_entries() == 0);
+
+  test_identical_units();
+  test_corrupt_entry();
+  test_sizes();
+  test_flash_layout();
+  return check_exit("test_desc_cache");
+}
@@ -0,0 +1,200 @@
+// The descriptor field schemas of lsusb.host.h: the binary form of every descriptor of the
+// corpus devices read back to the same bytes, short descriptors rendered up to their
+// bLength, and the CDC functional descriptors walked in any order, without an IAD and cut
+// short by the interface length.
+
+#include "sim.h"
+#include "check.h"
+
+
+// desc through its binary form and back: the bytes the present fields cover are the same,
+// a buffer one byte short and a cut input are refused
+template<size_t N>
+void round_trip(const uint8_t* desc, const desc_field_t (&fields)[N])
+{
+  uint8_t out[64], back[64] = {};
+  size_t covered = 0, expected = 1;
+  for (auto& field : fields) {
+    if (!desc_field_present(desc, field)) break;
+    covered = field.offset + field.size;
+    expected += field.size;
+  }
+  size_t const len = desc_serialize(desc, fields, out, sizeof(out));
+  CHECK(len == expected);
+  CHECK(desc_serialize(desc, fields, out, len - 1) == 0);
+  CHECK(desc_deserialize(out, len, fields, back, sizeof(back)) == len);
+  CHECK(memcmp(back + fields[0].offset, desc + fields[0].offset, covered - fields[0].offset) == 0);
+  if (len > 1) CHECK(desc_deserialize(out, len - 1, fields, back, sizeof(back)) == 0);
+  out[0] = N + 1;
+  CHECK(desc_deserialize(out, len, fields, back, sizeof(back)) == 0);
+}
+
+
+void test_round_trip()
+{
+  static const char* const corpus[] = { "corpus/composite", "corpus/hub", "corpus/mouse", "corpus/pico" };
+  size_t descriptors = 0;
+  for (const char* path : corpus) {
+    sim_device_t device;
+    CHECK(sim_read_sysfs(path, &device));
+    const uint8_t* const desc_device = device.descriptors.data();
+    round_trip(desc_device, device_fields);
+    round_trip(desc_device, device_string_fields);
+    for (auto config : sim_configs(device.descriptors)) {
+      const uint8_t* p_desc = &device.descriptors[config.first];
+      const uint8_t* const desc_end = p_desc + config.second;
+      uint8_t itf_class = 0;
+      for (; p_desc + 2 <= desc_end && tu_desc_len(p_desc) >= 2; p_desc = tu_desc_next(p_desc)) {
+        switch (tu_desc_type(p_desc)) {
+          case TUSB_DESC_CONFIGURATION:         round_trip(p_desc, config_fields); break;
+          case TUSB_DESC_INTERFACE_ASSOCIATION: round_trip(p_desc, interface_assoc_fields); break;
+          case TUSB_DESC_ENDPOINT:              round_trip(p_desc, endpoint_fields); break;
+          case HID_DESC_TYPE_HID:               round_trip(p_desc, hid_fields); break;
+          case TUSB_DESC_INTERFACE:
+            round_trip(p_desc, interface_fields);
+            itf_class = ((tusb_desc_interface_t const*) p_desc)->bInterfaceClass;
+          break;
+          case TUSB_DESC_CS_INTERFACE:
+            if (itf_class != TUSB_CLASS_CDC) continue;
+            switch (p_desc[2]) {
+              case CDC_FUNC_DESC_HEADER:                      round_trip(p_desc, cdc_header_fields); break;
+              case CDC_FUNC_DESC_CALL_MANAGEMENT:             round_trip(p_desc, cdc_call_management_fields); break;
+              case CDC_FUNC_DESC_ABSTRACT_CONTROL_MANAGEMENT: round_trip(p_desc, cdc_acm_fields); break;
+              case CDC_FUNC_DESC_UNION:                       round_trip(p_desc, cdc_union_fields); break;
+              default: continue;
+            }
+          break;
+          default: continue;
+        }
+        descriptors++;
+      }
+    }
+  }
+  // the pico has every kind, the CDC function included
+  CHECK(descriptors > 50);
+}
+
+
+void test_short_descriptor()
+{
+  // an endpoint without bInterval, and one cut after bmAttributes
+  uint8_t const desc_ep[] = { 6, TUSB_DESC_ENDPOINT, 0x81, 0x03, 8, 0 };
+  uint8_t const desc_ep_short[] = { 4, TUSB_DESC_ENDPOINT, 0x81, 0x03, 0xff, 0xff };
+  sim_output_begin();
+  print_endpoint_descriptor((tusb_desc_endpoint_t const*) desc_ep);
+  std::string output = sim_output_end();
+  CHECK(sim_count(output, "wMaxPacketSize") == 1);
+  CHECK(sim_count(output, "bInterval") == 0);
+
+  sim_output_begin();
+  print_endpoint_descriptor((tusb_desc_endpoint_t const*) desc_ep_short);
+  output = sim_output_end();
+  CHECK(sim_count(output, "bmAttributes") == 1);
+  CHECK(sim_count(output, "wMaxPacketSize") == 0);
+  round_trip(desc_ep, endpoint_fields);
+  round_trip(desc_ep_short, endpoint_fields);
+}
+
+
+// a CDC ACM control interface and its data interface, with the functional descriptors
+// given, behind an IAD or not
+sim_device_t make_cdc(const std::vector<uint8_t>& functional, bool iad)
+{
+  sim_device_t device;
+  uint8_t const desc_device[] = { 18, TUSB_DESC_DEVICE, 0x00, 0x02, 0xef, 0x02, 0x01, 64, 0x8a, 0x2e, 0x0a, 0x00, 0x00, 0x01, 0, 0, 0, 1 };
+  uint8_t const desc_assoc[] = { 8, TUSB_DESC_INTERFACE_ASSOCIATION, 0, 2, TUSB_CLASS_CDC, 2, 0, 0 };
+  uint8_t const desc_control[] = {
+    9, TUSB_DESC_INTERFACE, 0, 0, 1, TUSB_CLASS_CDC, 2, 0, 0,
+  };
+  uint8_t const desc_data[] = {
+    7, TUSB_DESC_ENDPOINT, 0x81, 0x03, 8, 0, 16,
+    9, TUSB_DESC_INTERFACE, 1, 0, 2, TUSB_CLASS_CDC_DATA, 0, 0, 0,
+    7, TUSB_DESC_ENDPOINT, 0x02, 0x02, 64, 0, 0,
+    7, TUSB_DESC_ENDPOINT, 0x82, 0x02, 64, 0, 0,
+  };
+  std::vector<uint8_t> config = { 9, TUSB_DESC_CONFIGURATION, 0, 0, 2, 1, 0, 0x80, 50 };
+  if (iad) config.insert(config.end(), desc_assoc, desc_assoc + sizeof(desc_assoc));
+  config.insert(config.end(), desc_control, desc_control + sizeof(desc_control));
+  config.insert(config.end(), functional.begin(), functional.end());
+  config.insert(config.end(), desc_data, desc_data + sizeof(desc_data));
+  config[2] = (uint8_t) config.size();
+  device.descriptors.assign(desc_device, desc_device + sizeof(desc_device));
+  device.descriptors.insert(device.descriptors.end(), config.begin(), config.end());
+  return device;
+}
+
+
+std::string dump(const sim_device_t& device)
+{
+  sim_output_begin();
+  sim_view(1, device);
+  print_device_descriptor(1);
+  return sim_output_end();
+}
+
+
+void test_cdc()
+{
+  std::vector<uint8_t> const functional = {
+    5, TUSB_DESC_CS_INTERFACE, CDC_FUNC_DESC_HEADER, 0x20, 0x01,
+    5, TUSB_DESC_CS_INTERFACE, CDC_FUNC_DESC_CALL_MANAGEMENT, 0x00, 1,
+    4, TUSB_DESC_CS_INTERFACE, CDC_FUNC_DESC_ABSTRACT_CONTROL_MANAGEMENT, 0x02,
+    5, TUSB_DESC_CS_INTERFACE, CDC_FUNC_DESC_UNION, 0, 1,
+  };
+
+  // behind an IAD the data interface is rendered by the CDC parser, else by the
+  // configuration's loop, once either way
+  for (bool iad : { true, false }) {
+    std::string const output = dump(make_cdc(functional, iad));
+    CHECK(sim_count(output, "Interface Association:") == (iad ? 1 : 0));
+    CHECK(sim_count(output, "Interface Descriptor #1:") == 1);
+    CHECK(sim_count(output, "CDC Header:") == 1);
+    CHECK(sim_count(output, "CDC Call Management:") == 1);
+    CHECK(sim_count(output, "line coding and serial state") == 1);
+    CHECK(sim_count(output, "CDC Union:") == 1);
+    CHECK(sim_count(output, "bEndpointAddress 0x81") == 1);
+    CHECK(sim_count(output, "bEndpointAddress 0x82") == 1);
+  }
+
+  // the union first, no call management, a subtype the renderer doesn't know
+  std::vector<uint8_t> const reordered = {
+    5, TUSB_DESC_CS_INTERFACE, CDC_FUNC_DESC_UNION, 0, 1,
+    5, TUSB_DESC_CS_INTERFACE, CDC_FUNC_DESC_HEADER, 0x10, 0x01,
+    4, TUSB_DESC_CS_INTERFACE, 0x0a, 0x55,
+    4, TUSB_DESC_CS_INTERFACE, CDC_FUNC_DESC_ABSTRACT_CONTROL_MANAGEMENT, 0x06,
+  };
+  std::string output = dump(make_cdc(reordered, true));
+  CHECK(output.find("CDC Union:") < output.find("CDC Header:"));
+  CHECK(sim_count(output, "CDC Call Management:") == 0);
+  CHECK(sim_count(output, "UNRECOGNIZED CDC: 04 24 0a 55") == 1);
+  CHECK(sim_count(output, "send break") == 1);
+  CHECK(sim_count(output, "Interface Descriptor #1:") == 1);
+
+  // the walk ends with the length it is given, in the middle of the ACM descriptor, and on
+  // a zero bLength
+  std::vector<uint8_t> itf = { 9, TUSB_DESC_INTERFACE, 0, 0, 1, TUSB_CLASS_CDC, 2, 0, 0 };
+  itf.insert(itf.end(), functional.begin(), functional.end());
+  sim_output_begin();
+  parse_cdc_interface(1, (tusb_desc_interface_t const*) itf.data(), NULL, 9 + 5 + 5 + 2);
+  output = sim_output_end();
+  CHECK(sim_count(output, "CDC Header:") == 1);
+  CHECK(sim_count(output, "CDC Call Management:") == 1);
+  CHECK(sim_count(output, "CDC ACM:") == 0);
+
+  itf[9 + 5] = 0;
+  sim_output_begin();
+  parse_cdc_interface(1, (tusb_desc_interface_t const*) itf.data(), NULL, (uint16_t) itf.size());
+  output = sim_output_end();
+  CHECK(sim_count(output, "CDC Header:") == 1);
+  CHECK(sim_count(output, "CDC Union:") == 0);
+}
+
+
+int main()
+{
+  sim_setup();
+  test_round_trip();
+  test_short_descriptor();
+  test_cdc();
+  return check_exit("test_desc_schema");
+}
@@ -0,0 +1,326 @@
+// Enumeration of lsusb.host.h on the simulated bus: the transfers each device needs and the
+// time it takes with the 1ms control requests of sim.h, units of a model enumerated side by
+// side and re-plugged, configuration descriptors larger than a control buffer and than the
+// configuration pool, devices with several configurations and their re-dump from cache, the
+// `lsusb -t` tree of devices behind a hub.
+
+#include "sim.h"
+#include "check.h"
+
+
+// a CDC ACM function behind an IAD: strings 1 to 3 in the device descriptor, 4 to 6 in the
+// configuration, function and data interface. Each pid is enumerated in full once, a
+// re-plug is served by the descriptor cache
+sim_device_t make_cdc_acm(uint16_t pid, const char* serial = "E6614103E7452D2F")
+{
+  sim_device_t device;
+  uint8_t const desc[] = {
+    18, TUSB_DESC_DEVICE, 0x00, 0x02, 0xef, 0x02, 0x01, 64, 0x8a, 0x2e, (uint8_t) pid, (uint8_t)(pid >> 8), 0x00, 0x01, 1, 2, 3, 1,
+    9, TUSB_DESC_CONFIGURATION, 75, 0, 2, 1, 4, 0x80, 50,
+    8, TUSB_DESC_INTERFACE_ASSOCIATION, 0, 2, TUSB_CLASS_CDC, 2, 0, 5,
+    9, TUSB_DESC_INTERFACE, 0, 0, 1, TUSB_CLASS_CDC, 2, 0, 0,
+    5, TUSB_DESC_CS_INTERFACE, 0x00, 0x20, 0x01,
+    5, TUSB_DESC_CS_INTERFACE, 0x01, 0x00, 1,
+    4, TUSB_DESC_CS_INTERFACE, 0x02, 0x02,
+    5, TUSB_DESC_CS_INTERFACE, 0x06, 0, 1,
+    7, TUSB_DESC_ENDPOINT, 0x81, 0x03, 8, 0, 16,
+    9, TUSB_DESC_INTERFACE, 1, 0, 2, TUSB_CLASS_CDC_DATA, 0, 0, 6,
+    7, TUSB_DESC_ENDPOINT, 0x02, 0x02, 64, 0, 0,
+    7, TUSB_DESC_ENDPOINT, 0x82, 0x02, 64, 0, 0,
+  };
+  device.descriptors.assign(desc, desc + sizeof(desc));
+  device.set_string(1, "Raspberry Pi");
+  device.set_string(2, "Pico");
+  device.set_string(3, serial);
+  device.set_string(4, "Board CDC");
+  device.set_string(5, "Pico CDC");
+  device.set_string(6, "Pico CDC Data");
+  return device;
+}
+
+
+void test_strings()
+{
+  sim_output_begin();
+  sim_plug(1, make_cdc_acm(0x000a));
+  sim_run(20);
+  std::string const output = sim_output_end();
+
+  // device, LANGIDs, configuration header, configuration and the six strings, one after the other
+  CHECK(sim_stats.requests == 10 && sim_stats.busy == 0);
+  CHECK(sim_count(output, "Device 1: enumerated in 10000 us, 10 transfers") == 1);
+  CHECK(sim_count(output, "Device Descriptor:") == 1);
+  CHECK(sim_count(output, "E6614103E7452D2F") == 1);
+  CHECK(sim_count(output, "Pico CDC Data") == 1);
+}
+
+
+void test_no_strings()
+{
+  // string descriptor 0 stalls: no string is requested at all
+  sim_device_t device = make_cdc_acm(0x000b);
+  device.langids.clear();
+  uint32_t const requests = sim_stats.requests;
+  sim_output_begin();
+  sim_plug(2, device);
+  sim_run(20);
+  std::string const output = sim_output_end();
+  CHECK(sim_stats.requests == requests + 4);
+  CHECK(sim_count(output, "Device 2: enumerated in 4000 us, 4 transfers") == 1);
+  CHECK(sim_count(output, "Pico") == 0);
+}
+
+
+// the dump of the device at address daddr in the output of several devices
+std::string dump_of(const std::string& output, uint8_t daddr)
+{
+  std::string const head = "Device " + std::to_string(daddr) + ": ID ";
+  size_t const start = output.find(head);
+  if (start == std::string::npos) return "";
+  size_t end = output.find("\nDevice ", start);
+  while (end != std::string::npos && !isdigit(output[end + 8])) end = output.find("\nDevice ", end + 1);
+  return output.substr(start, end == std::string::npos ? std::string::npos : end - start);
+}
+
+
+void test_concurrent()
+{
+  // two units of a model, enumerated side by side through the single control pipe: a
+  // request finding it busy is retried by enum_task(), the pipe is never idle
+  uint32_t const requests = sim_stats.requests;
+  uint32_t const busy = sim_stats.busy;
+  sim_output_begin();
+  sim_plug(1, make_cdc_acm(0x000c, "UNIT-1"));
+  sim_run(2);
+  sim_plug(3, make_cdc_acm(0x000c, "UNIT-3"));
+  sim_run(40);
+  std::string output = sim_output_end();
+  CHECK(sim_stats.requests == requests + 20 && sim_stats.busy > busy);
+  CHECK(sim_count(output, "Device 1: enumerated in 10000 us, 10 transfers") == 1);
+  CHECK(sim_count(output, "Device 3: enumerated in 18000 us, 10 transfers") == 1);
+  CHECK(output.find("[tuh_mount_cb] Device attached, address = 3") < output.find("Device 1: enumerated"));
+  CHECK(sim_count(dump_of(output, 1), "UNIT-1") == 1 && sim_count(dump_of(output, 1), "UNIT-3") == 0);
+  CHECK(sim_count(dump_of(output, 3), "UNIT-3") == 1 && sim_count(dump_of(output, 3), "UNIT-1") == 0);
+
+  // re-plugged at once, each is rendered from its own entry
+  sim_unplug(1);
+  sim_unplug(3);
+  sim_output_begin();
+  sim_plug(3, make_cdc_acm(0x000c, "UNIT-3"));
+  sim_plug(1, make_cdc_acm(0x000c, "UNIT-1"));
+  sim_run(20);
+  output = sim_output_end();
+  CHECK(sim_count(output, "rendered from cache") == 2 && sim_count(output, "enumerated in") == 0);
+  CHECK(sim_count(dump_of(output, 1), "UNIT-1") == 1 && sim_count(dump_of(output, 1), "UNIT-3") == 0);
+  CHECK(sim_count(dump_of(output, 3), "UNIT-3") == 1 && sim_count(dump_of(output, 3), "UNIT-1") == 0);
+
+  // and dumped again from the device table
+  sim_output_begin();
+  sim_console("d");
+  sim_run(5);
+  output = sim_output_end();
+  CHECK(sim_count(output, "dumped from cache") == 3); // with the device of test_no_strings
+  CHECK(sim_count(dump_of(output, 1), "UNIT-1") == 1 && sim_count(dump_of(output, 1), "UNIT-3") == 0);
+  CHECK(sim_count(dump_of(output, 3), "UNIT-3") == 1 && sim_count(dump_of(output, 3), "UNIT-1") == 0);
+  sim_unplug(2);
+  sim_unplug(3);
+}
+
+
+// what the device at address daddr renders once enumerated
+std::string dump(uint8_t daddr)
+{
+  sim_output_begin();
+  print_device_descriptor(daddr);
+  return sim_output_end();
+}
+
+
+void test_large_config()
+{
+  // corpus/composite: 50 vendor interfaces with 2 endpoints each, 1159 bytes of configuration
+  sim_device_t device;
+  CHECK(sim_read_sysfs("corpus/composite", &device));
+  uint32_t const requests = sim_stats.requests;
+  sim_output_begin();
+  sim_plug(1, device);
+  sim_run(20);
+  std::string output = sim_output_end();
+  // device, LANGIDs (stalled), configuration header and the whole configuration
+  CHECK(sim_stats.requests == requests + 4);
+  CHECK(sim_count(output, "Device 1: enumerated in 4000 us, 4 transfers") == 1);
+  CHECK(sim_count(output, "truncated") == 0);
+
+  output = dump(1);
+  CHECK(sim_count(output, "wTotalLength          0x0487") == 1);
+  CHECK(sim_count(output, "bInterfaceNumber") == 50);
+  CHECK(sim_count(output, "bEndpointAddress") == 100);
+  std::string golden;
+  CHECK(sim_read_file("corpus/composite.txt", &golden));
+  CHECK(output == golden);
+}
+
+
+void test_truncated_config()
+{
+  // 50 interfaces padded with vendor descriptors to 100 bytes each: 5009 bytes
+  sim_device_t device;
+  uint8_t const desc[] = { 18, TUSB_DESC_DEVICE, 0x00, 0x02, 0, 0, 0, 64, 0xfe, 0xca, 0x51, 0x40, 0x00, 0x01, 0, 0, 0, 1,
+                           9, TUSB_DESC_CONFIGURATION, 0x91, 0x13, 50, 1, 0, 0x80, 50 };
+  device.descriptors.assign(desc, desc + sizeof(desc));
+  for (uint8_t i = 0; i < 50; i++) {
+    uint8_t const itf[] = { 9, TUSB_DESC_INTERFACE, i, 0, 2, TUSB_CLASS_VENDOR_SPECIFIC, 0, 0, 0,
+                            7, TUSB_DESC_ENDPOINT, 0x81, 0x02, 64, 0, 0,
+                            7, TUSB_DESC_ENDPOINT, 0x01, 0x02, 64, 0, 0,
+                            77, 0x41 };
+    device.descriptors.insert(device.descriptors.end(), itf, itf + sizeof(itf));
+    device.descriptors.insert(device.descriptors.end(), 75, 0x5a);
+  }
+  CHECK(device.descriptors.size() == 18 + 5009);
+
+  sim_output_begin();
+  sim_plug(1, device);
+  sim_run(20);
+  std::string output = sim_output_end();
+  CHECK(sim_count(output, "Configuration descriptor #0 truncated to 4096 of 5009 bytes") == 1);
+  CHECK(sim_count(output, "enumerated in 4000 us, 4 transfers") == 1);
+  CHECK(get_device(1)->configs[0].len == CFG_POOL_SIZE);
+
+  // the 40 whole interfaces, the 41st is cut
+  output = dump(1);
+  CHECK(sim_count(output, "bInterfaceNumber") == 41);
+  CHECK(sim_count(output, "bEndpointAddress") == 80);
+  CHECK(sim_count(output, "***TRUNCATED DESCRIPTOR") == 1);
+}
+
+
+void test_configs()
+{
+  // two configurations of one vendor interface, strings 1 to 3 in the device descriptor
+  sim_device_t device;
+  uint8_t const desc[] = {
+    18, TUSB_DESC_DEVICE, 0x00, 0x02, 0, 0, 0, 64, 0xfe, 0xca, 0x52, 0x40, 0x00, 0x01, 1, 2, 3, 2,
+    9, TUSB_DESC_CONFIGURATION, 18, 0, 1, 1, 0, 0x80, 50,
+    9, TUSB_DESC_INTERFACE, 0, 0, 0, TUSB_CLASS_VENDOR_SPECIFIC, 0, 0, 0,
+    9, TUSB_DESC_CONFIGURATION, 18, 0, 1, 2, 0, 0xc0, 0,
+    9, TUSB_DESC_INTERFACE, 0, 0, 0, TUSB_CLASS_VENDOR_SPECIFIC, 1, 0, 0,
+  };
+  device.descriptors.assign(desc, desc + sizeof(desc));
+  device.set_string(1, "Maker");
+  device.set_string(2, "Gadget");
+  device.set_string(3, "TWO-CONFIGS");
+  uint32_t const requests = sim_stats.requests;
+  sim_output_begin();
+  sim_plug(1, device);
+  sim_run(20);
+  std::string output = sim_output_end();
+  // device, LANGIDs, 2 x header/full and the 3 strings
+  CHECK(sim_stats.requests == requests + 9);
+  CHECK(sim_count(output, "Device 1: enumerated in 9000 us, 9 transfers") == 1);
+  CHECK(sim_count(output, "bConfigurationValue") == 2);
+  CHECK(get_device(1)->config_count == 2);
+
+  // the same dump again, without any transfer
+  sim_output_begin();
+  sim_console("d");
+  sim_run(5);
+  std::string const redump = sim_output_end();
+  CHECK(sim_stats.requests == requests + 9);
+  CHECK(sim_count(redump, "Device 1: dumped from cache in") == 1);
+  CHECK(redump.substr(0, redump.find("Device 1: dumped")) == dump(1));
+  CHECK(sim_count(redump, "dumped from cache") == 1);
+  CHECK(sim_count(redump, "bConfigurationValue") == 2 && sim_count(redump, "TWO-CONFIGS") == 1);
+}
+
+
+// a device with one interface of the class, plugged in a hub port, or the root port when hub_addr is 0
+sim_device_t make_tree_device(uint16_t pid, uint8_t itf_class, uint8_t hub_addr, uint8_t hub_port)
+{
+  sim_device_t device;
+  uint8_t const desc[] = {
+    18, TUSB_DESC_DEVICE, 0x00, 0x02, 0, 0, 0, 64, 0xfe, 0xca, (uint8_t) pid, (uint8_t)(pid >> 8), 0x00, 0x01, 0, 0, 0, 1,
+    9, TUSB_DESC_CONFIGURATION, 18, 0, 1, 1, 0, 0x80, 50,
+    9, TUSB_DESC_INTERFACE, 0, 0, 0, itf_class, 0, 0, 0,
+  };
+  device.descriptors.assign(desc, desc + sizeof(desc));
+  device.langids.clear();
+  device.devtree = { 1, hub_addr, hub_port, TUSB_SPEED_FULL };
+  return device;
+}
+
+
+std::string tree()
+{
+  sim_output_begin();
+  sim_console("t");
+  sim_run(1);
+  return sim_output_end();
+}
+
+
+void test_tree()
+{
+  sim_output_begin();
+  for (uint8_t daddr = 1; daddr <= DEVICES_MAX; daddr++) {
+    if (sim_bus[daddr].attached) sim_unplug(daddr);
+  }
+  sim_run(1);
+  sim_output_end();
+  CHECK(tree() == "No device attached\r\n");
+
+  // a hub in the root port, three devices in its ports 3, 1 and 2: listed by port
+  sim_output_begin();
+  sim_plug(1, make_tree_device(0x0101, TUSB_CLASS_HUB, 0, 1));
+  sim_plug(2, make_tree_device(0x0102, TUSB_CLASS_HID, 1, 3));
+  sim_plug(3, make_tree_device(0x0103, TUSB_CLASS_MSC, 1, 1));
+  sim_plug(4, make_tree_device(0x0104, TUSB_CLASS_VENDOR_SPECIFIC, 1, 2));
+  sim_run(40);
+  sim_output_end();
+  std::string output = tree();
+  CHECK(output == "/:  Bus 01.Port 1: Class=root_hub, Driver=pio_usb\r\n"
+                  "    |__ Port 1: Dev 1, If 0, Class=Hub, Driver=hub, 12M\r\n"
+                  "        |__ Port 1: Dev 3, If 0, Class=Mass Storage, Driver=[none], 12M\r\n"
+                  "        |__ Port 2: Dev 4, If 0, Class=Vendor Specific Class, Driver=[none], 12M\r\n"
+                  "        |__ Port 3: Dev 2, If 0, Class=Human Interface Device, Driver=hid, 12M\r\n");
+
+  // a device moved from the root port to the hub's port 4, at a new address
+  sim_unplug(1);
+  sim_unplug(2);
+  sim_unplug(3);
+  sim_unplug(4);
+  sim_output_begin();
+  sim_plug(5, make_tree_device(0x0105, TUSB_CLASS_VENDOR_SPECIFIC, 0, 1));
+  sim_run(20);
+  sim_output_end();
+  output = tree();
+  CHECK(sim_count(output, "    |__ Port 1: Dev 5, If 0") == 1);
+  sim_unplug(5);
+  sim_output_begin();
+  sim_plug(1, make_tree_device(0x0101, TUSB_CLASS_HUB, 0, 1));
+  sim_plug(2, make_tree_device(0x0105, TUSB_CLASS_VENDOR_SPECIFIC, 1, 4));
+  sim_run(40);
+  sim_output_end();
+  output = tree();
+  CHECK(sim_count(output, "        |__ Port 4: Dev 2, If 0") == 1 && sim_count(output, "Dev 5") == 0);
+
+  sim_output_begin();
+  sim_unplug(2);
+  sim_unplug(1);
+  sim_run(1);
+  sim_output_end();
+  CHECK(tree() == "No device attached\r\n");
+}
+
+
+int main()
+{
+  sim_setup();
+  test_strings();
+  test_no_strings();
+  test_concurrent();
+  test_large_config();
+  test_truncated_config();
+  test_configs();
+  test_tree();
+  return check_exit("test_enum");
+}
@@ -0,0 +1,144 @@
+// Event ring (misc/event_ring.h) under two threads standing for core1 and core0: records of
+// random length are pushed and popped concurrently, each must come out whole and in order,
+// and what couldn't be pushed must be what the dropped counters say. The consumer stalls
+// now and then so the ring fills up and wraps at every offset.
+
+#include <Arduino.h>
+#define EVENT_RING_SIZE 1024
+#include "misc/event_ring.h"
+#include "check.h"
+
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+#define RECORDS     1000000
+#define PAYLOAD_MAX (EVENT_RING_SIZE - sizeof(event_header_t)) // a record filling the whole ring
+
+
+// the payload of record seq: its number, then bytes derived from it
+static void fill(uint32_t seq, uint8_t* payload, uint16_t len)
+{
+  for (uint16_t i=0; i<len; i++) payload[i] = i < 4 ? (uint8_t)(seq >> (8*i)) : (uint8_t)(seq * 31 + i);
+}
+
+
+static uint16_t random_len(std::mt19937& rng)
+{
+  switch (rng() % 16) {
+    case 0:  return 4 + rng() % (PAYLOAD_MAX - 3); // up to a full ring
+    case 1:  return 4;                         // the smallest record here, a header and a number
+    default: return 4 + rng() % 96;            // what HID reports and logs look like
+  }
+}
+
+
+void test_two_threads()
+{
+  std::vector<uint16_t> lens(RECORDS);
+  std::vector<bool> pushed(RECORDS);
+  std::atomic<bool> done(false);
+  uint32_t dropped = 0, dropped_bytes = 0, largest = 0;
+
+  std::vector<uint32_t> received;
+  uint32_t bad_payload = 0;
+  received.reserve(RECORDS);
+  std::thread consumer([&] {
+    static uint8_t payload[PAYLOAD_MAX];
+    uint8_t expected[PAYLOAD_MAX];
+    event_header_t header;
+    uint32_t pops = 0;
+    for (;;) {
+      bool const finished = done.load(std::memory_order_acquire); // everything was pushed before that
+      if (!event_pop(&header, payload, sizeof(payload))) {
+        if (finished) break;
+        std::this_thread::yield();
+        continue;
+      }
+      uint32_t seq = 0;
+      memcpy(&seq, payload, header.len < 4 ? header.len : 4);
+      fill(seq, expected, header.len);
+      if (header.len < 4 || header.type != (uint8_t) seq || header.daddr != (uint8_t)(seq >> 8) || memcmp(payload, expected, header.len) != 0) bad_payload++;
+      received.push_back(seq);
+      if (++pops % 8192 == 0) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  std::mt19937 rng(1234);
+  static uint8_t payload[PAYLOAD_MAX];
+  for (uint32_t seq=0; seq<RECORDS; seq++) {
+    lens[seq] = random_len(rng);
+    fill(seq, payload, lens[seq]);
+    // two parts, split at a random point, like the events with a header struct and a string
+    uint16_t const split = rng() % (lens[seq] + 1);
+    pushed[seq] = event_push((uint8_t) seq, (uint8_t)(seq >> 8), payload, split, payload + split, lens[seq] - split);
+    uint32_t const size = sizeof(event_header_t) + lens[seq];
+    if (pushed[seq]) {
+      if (size > largest) largest = size;
+    } else {
+      dropped++;
+      dropped_bytes += size;
+      std::this_thread::yield(); // core1 moves on to its next USB event, core0 catches up meanwhile
+    }
+  }
+  done.store(true, std::memory_order_release);
+  consumer.join();
+
+  std::vector<uint32_t> expected;
+  for (uint32_t seq=0; seq<RECORDS; seq++) {
+    if (pushed[seq]) expected.push_back(seq);
+  }
+  CHECK(bad_payload == 0);
+  CHECK(received == expected); // every pushed record, once, in order
+  CHECK(event_ring_stats.events == expected.size());
+  CHECK(event_ring_stats.dropped == dropped);
+  CHECK(event_ring_stats.dropped_bytes == dropped_bytes);
+  CHECK(event_ring_stats.events + event_ring_stats.dropped == RECORDS);
+  // the stalls make the ring overflow, a record is dropped when the bytes in use leave it
+  // no room, so the ring was at least that full
+  CHECK(dropped > 0);
+  CHECK(event_ring_stats.high_water <= EVENT_RING_SIZE);
+  CHECK(event_ring_stats.high_water >= largest);
+  CHECK(event_ring_stats.high_water > EVENT_RING_SIZE - sizeof(event_header_t) - PAYLOAD_MAX);
+  CHECK(event_ring.head.load() == event_ring.tail.load());
+  printf("  %u records pushed, %u dropped, high water %u of %u bytes\n", event_ring_stats.events, event_ring_stats.dropped, event_ring_stats.high_water, EVENT_RING_SIZE);
+}
+
+
+// one thread: the limits of a single record
+void test_limits()
+{
+  static uint8_t payload[UINT16_MAX + 1];
+  uint8_t out[PAYLOAD_MAX];
+  event_header_t header;
+  event_ring_stats = {};
+
+  // a record filling the whole ring fits an empty ring only
+  CHECK(event_push(1, 0, payload, PAYLOAD_MAX));
+  CHECK(event_ring_stats.high_water == EVENT_RING_SIZE);
+  CHECK(!event_push(2, 0));
+  CHECK(event_pop(&header, out, sizeof(out)) && header.type == 1 && header.len == PAYLOAD_MAX);
+  CHECK(!event_pop(&header, out, sizeof(out)));
+  CHECK(!event_push(3, 0, payload, PAYLOAD_MAX + 1));
+
+  // payloads past 16 bits are dropped whole, not truncated
+  CHECK(!event_push(4, 0, payload, UINT16_MAX, payload, 1));
+  CHECK(event_ring_stats.dropped == 3 && event_ring_stats.dropped_bytes == sizeof(event_header_t) * 3 + (PAYLOAD_MAX + 1) + (UINT16_MAX + 1));
+
+  // a payload larger than the consumer's buffer is skipped, the next record still comes out
+  CHECK(event_push(5, 0, payload, 100));
+  CHECK(event_push(6, 0, payload, 10));
+  CHECK(event_pop(&header, out, 50) && header.type == 6 && header.len == 10);
+  CHECK(!event_pop(&header, out, sizeof(out)));
+  CHECK(event_ring_stats.events == 3);
+}
+
+
+int main()
+{
+  test_two_threads();
+  test_limits();
+  return check_exit("test_event_ring");
+}
@@ -0,0 +1,110 @@
+// HID report dumps (event_render_hid_report() in lsusb.host.h) through the event ring: the
+// full hex dump, and the delta mode of the 'r' command on the first report of an endpoint,
+// an unchanged report, changed bytes, a length change, two endpoints and a replug.
+
+#include "sim.h"
+#include "check.h"
+
+
+// what a report on the endpoint prints
+std::string report(uint8_t daddr, uint8_t ep, std::vector<uint8_t> data)
+{
+  sim_output_begin();
+  CHECK(sim_hid_report(daddr, ep, data.data(), data.size()));
+  sim_run(10);
+  return sim_output_end();
+}
+
+
+void plug(uint8_t daddr, const sim_device_t& device)
+{
+  sim_output_begin();
+  sim_plug(daddr, device);
+  sim_run(500);
+  sim_output_end();
+}
+
+
+void test_full(uint8_t daddr)
+{
+  hid_report_delta = false;
+  CHECK(report(daddr, 0x83, { 0x01, 0x00, 0x04 }) == "[dev 1: ep 83] HID Report:\r\n  01 00 04 \r\n");
+  CHECK(report(daddr, 0x83, { 0x01, 0x00, 0x04 }) == "[dev 1: ep 83] HID Report:\r\n  01 00 04 \r\n");
+  std::vector<uint8_t> long_report(20);
+  for (size_t i = 0; i < long_report.size(); i++) long_report[i] = 0xe0 + i;
+  CHECK(report(daddr, 0x83, long_report) ==
+        "[dev 1: ep 83] HID Report:\r\n  E0 E1 E2 E3 E4 E5 E6 E7 E8 E9 EA EB EC ED EE EF \r\n  F0 F1 F2 F3 \r\n");
+}
+
+
+void test_delta(uint8_t daddr)
+{
+  hid_report_delta = true;
+  // the full dump above was the last report printed for the endpoint
+  std::vector<uint8_t> keys = { 0x01, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00 };
+  CHECK(report(daddr, 0x83, keys) == "[dev 1: ep 83] HID Report:\r\n  01 00 04 00 00 00 00 00 \r\n");
+  CHECK(report(daddr, 0x83, keys) == "[dev 1: ep 83] HID Report unchanged\r\n");
+
+  keys[3] = 0x05;
+  keys[7] = 0xff;
+  CHECK(report(daddr, 0x83, keys) == "[dev 1: ep 83] HID Report delta:\r\n  03=05 07=FF \r\n");
+  CHECK(report(daddr, 0x83, keys) == "[dev 1: ep 83] HID Report unchanged\r\n");
+
+  // another length is printed whole, and is what the next report is compared with
+  keys.resize(4);
+  CHECK(report(daddr, 0x83, keys) == "[dev 1: ep 83] HID Report:\r\n  01 00 04 05 \r\n");
+  keys[0] = 0x00;
+  CHECK(report(daddr, 0x83, keys) == "[dev 1: ep 83] HID Report delta:\r\n  00=00 \r\n");
+
+  // more than 8 changes wrap
+  std::vector<uint8_t> pad(10, 0x00);
+  report(daddr, 0x83, pad);
+  pad.assign(10, 0x11);
+  CHECK(report(daddr, 0x83, pad) ==
+        "[dev 1: ep 83] HID Report delta:\r\n  00=11 01=11 02=11 03=11 04=11 05=11 06=11 07=11 \r\n  08=11 09=11 \r\n");
+}
+
+
+void test_endpoints(uint8_t daddr, uint8_t other)
+{
+  hid_report_delta = true;
+  // each endpoint of each device keeps its own last report
+  CHECK(report(other, 0x81, { 0x00, 0x01, 0xff }) == "[dev 2: ep 81] HID Report:\r\n  00 01 FF \r\n");
+  CHECK(report(other, 0x81, { 0x00, 0x01, 0xff }) == "[dev 2: ep 81] HID Report unchanged\r\n");
+  CHECK(report(daddr, 0x83, std::vector<uint8_t>(10, 0x11)) == "[dev 1: ep 83] HID Report unchanged\r\n");
+}
+
+
+void test_replug(uint8_t daddr, const sim_device_t& device)
+{
+  hid_report_delta = true;
+  std::vector<uint8_t> const keys = { 0x01, 0x00, 0x04 };
+  report(daddr, 0x83, keys);
+  sim_output_begin();
+  sim_unplug(daddr);
+  sim_run(10);
+  sim_output_end();
+  plug(daddr, device);
+  CHECK(report(daddr, 0x83, keys) == "[dev 1: ep 83] HID Report:\r\n  01 00 04 \r\n");
+}
+
+
+int main()
+{
+  sim_device_t pico, mouse;
+  if (!sim_read_sysfs("corpus/pico", &pico) || !sim_read_sysfs("corpus/mouse", &mouse)) {
+    fprintf(stderr, "test_hid_report: can't read the corpus\n");
+    return 1;
+  }
+  sim_output_begin();
+  sim_setup();
+  sim_output_end();
+  plug(1, pico);
+  plug(2, mouse);
+
+  test_full(1);
+  test_delta(1);
+  test_endpoints(1, 2);
+  test_replug(1, pico);
+  return check_exit("test_hid_report");
+}
@@ -0,0 +1,156 @@
+// Lookup cache (usb.org/lsusb_cache.h): keys conflicting in a set, replacement of the least
+// recently used way, hit and miss counting, against a model of the 2-way sets, then the
+// vid:pid and class/subclass/protocol caches in front of the usb.ids lookups.
+
+#include <Arduino.h>
+#include <tusb.h>
+#include "usb.org/lsusb_info.h"
+#include "check.h"
+
+#include <algorithm>
+#include <list>
+#include <random>
+#include <vector>
+
+#define SETS 4
+
+
+// the first count keys from start on falling in the given set
+static std::vector<uint32_t> keys_of_set(size_t set, size_t count, uint32_t start=0)
+{
+  std::vector<uint32_t> keys;
+  for (uint32_t key=start; keys.size()<count; key++) {
+    if (usb_ids_cache_t<uint32_t, SETS>::set_of(key) == set) keys.push_back(key);
+  }
+  return keys;
+}
+
+
+// a hit on key with that value, which makes its way the most recent of the set
+static bool holds(usb_ids_cache_t<uint32_t, SETS>& cache, uint32_t key, uint32_t value)
+{
+  const uint32_t* const cached = cache.get(key);
+  return cached && *cached == value;
+}
+
+
+void test_conflicts()
+{
+  usb_ids_cache_t<uint32_t, SETS> cache;
+  auto const keys = keys_of_set(1, 4);
+
+  CHECK(cache.get(keys[0]) == nullptr);
+  cache.put(keys[0], 100);
+  cache.put(keys[1], 101);
+  CHECK(holds(cache, keys[0], 100));
+  CHECK(holds(cache, keys[1], 101));
+
+  // keys[1] was used last, keys[0] goes
+  cache.put(keys[2], 102);
+  CHECK(cache.get(keys[0]) == nullptr);
+  CHECK(holds(cache, keys[2], 102));
+
+  // a hit makes its way the most recent: keys[1] stays, keys[2] goes
+  CHECK(holds(cache, keys[1], 101));
+  cache.put(keys[3], 103);
+  CHECK(cache.get(keys[2]) == nullptr);
+  CHECK(holds(cache, keys[1], 101));
+  CHECK(holds(cache, keys[3], 103));
+  CHECK(cache.hits == 6 && cache.misses == 3);
+
+  // the other sets weren't touched, two keys of each fit side by side
+  for (size_t set=0; set<SETS; set++) {
+    if (set == 1) continue;
+    for (uint32_t key : keys_of_set(set, 2)) CHECK(cache.get(key) == nullptr);
+  }
+  for (size_t set=0; set<SETS; set++) {
+    for (uint32_t key : keys_of_set(set, 2, 1000)) cache.put(key, key);
+  }
+  for (size_t set=0; set<SETS; set++) {
+    for (uint32_t key : keys_of_set(set, 2, 1000)) CHECK(holds(cache, key, key));
+  }
+  CHECK(cache.hits == 6 + 2 * SETS && cache.misses == 3 + 2 * (SETS - 1));
+
+  cache.clear();
+  CHECK(cache.hits == 0 && cache.misses == 0);
+  CHECK(cache.get(keys[1]) == nullptr && cache.misses == 1);
+}
+
+
+// random keys of a few sets, every get() and the counters against the model
+void test_model()
+{
+  usb_ids_cache_t<uint32_t, SETS> cache;
+  std::list<uint32_t> model[SETS]; // most recent first, 2 keys at most
+  uint32_t hits = 0, misses = 0, bad = 0;
+  std::mt19937 rng(42);
+  for (int i=0; i<100000; i++) {
+    uint32_t const key = rng() % 24 | (rng() % 2) << 16;
+    auto& ways = model[cache.set_of(key)];
+    auto const it = std::find(ways.begin(), ways.end(), key);
+    const uint32_t* const value = cache.get(key);
+    if (it != ways.end()) {
+      hits++;
+      ways.splice(ways.begin(), ways, it);
+      bad += value == nullptr || *value != key * 3;
+      continue;
+    }
+    misses++;
+    bad += value != nullptr;
+    // what get_vid_pid() does after a miss
+    cache.put(key, key * 3);
+    ways.push_front(key);
+    if (ways.size() > 2) ways.pop_back();
+  }
+  CHECK(bad == 0);
+  CHECK(cache.hits == hits && cache.misses == misses);
+  CHECK(hits > 0 && misses > 0);
+}
+
+
+void test_vid_pid()
+{
+  vid_pid_cache.clear();
+  auto const first = get_vid_pid(0x046d, 0xc52b);
+  auto const found = find_vid_pid(0x046d, 0xc52b);
+  CHECK(first.vendor == found.vendor && first.product == found.product);
+  CHECK(first.product != &nullProduct);
+  CHECK(vid_pid_cache.hits == 0 && vid_pid_cache.misses == 1);
+  for (int i=0; i<10; i++) {
+    auto const again = get_vid_pid(0x046d, 0xc52b);
+    CHECK(again.vendor == found.vendor && again.product == found.product);
+  }
+  CHECK(vid_pid_cache.hits == 10 && vid_pid_cache.misses == 1);
+
+  // unknown ids are cached as well, the same as find_vid_pid() returns
+  get_vid_pid(0xffff, 0xffff);
+  auto const unknown = get_vid_pid(0xffff, 0xffff);
+  CHECK(unknown.vendor == &nullVendor && unknown.product == &nullProduct);
+  CHECK(vid_pid_cache.hits == 11 && vid_pid_cache.misses == 2);
+
+  // every listed product through the cache, whatever it evicts along the way
+  uint32_t bad = 0;
+  for (size_t v=0; v<usb_vids_count; v++) {
+    for (size_t p=0; p<usb_vids[v].product_count; p++) {
+      uint16_t const pid = usb_pid_keys[usb_vids[v].product_id_t_idx + p];
+      auto const cached = get_vid_pid(usb_vid_keys[v], pid);
+      bad += cached.vendor != &usb_vids[v] || cached.product != &usb_pids[usb_vids[v].product_id_t_idx + p];
+    }
+  }
+  CHECK(bad == 0);
+
+  class_sub_proto_cache.clear();
+  auto const keyboard = get_class_sub_proto(TUSB_CLASS_HID, 1, HID_ITF_PROTOCOL_KEYBOARD);
+  CHECK(get_class_sub_proto(TUSB_CLASS_HID, 1, HID_ITF_PROTOCOL_KEYBOARD).dev_proto == keyboard.dev_proto);
+  CHECK(keyboard.dev_proto == find_class_sub_proto(TUSB_CLASS_HID, 1, HID_ITF_PROTOCOL_KEYBOARD).dev_proto);
+  CHECK(class_sub_proto_cache.hits == 1 && class_sub_proto_cache.misses == 1);
+}
+
+
+int main()
+{
+  test_conflicts();
+  test_model();
+  test_vid_pid();
+  return check_exit("test_lookup_cache");
+}
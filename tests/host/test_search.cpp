@@ -0,0 +1,221 @@
+// Search of the usb.ids tables (usb.org/lsusb_search.h): every strategy against a linear
+// scan, for every vendor id and every vendor's product ids, hits and misses, then the
+// names get_vendor() and find_vid_pid() return against usb.org/usb.ids itself, and the
+// HID usage pages, usages and the languages against a linear scan.
+
+#include <Arduino.h>
+#include <tusb.h>
+#include "usb.org/lsusb_info.h"
+#include "check.h"
+
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+
+// the index of key in keys[], the way the search functions report it
+static int32_t linear_search(uint16_t key, const uint16_t* keys, size_t count)
+{
+  for (size_t i=0; i<count; i++) {
+    if (keys[i] == key) return i;
+  }
+  return -1;
+}
+
+
+template<usb_ids_search_t strategy>
+static int32_t search(uint16_t key, const uint16_t* keys, size_t count, const usb_ids_mph_t* mph=nullptr)
+{
+  return usb_ids_search<strategy>(key, count, [keys](size_t i) { return keys[i]; }, mph);
+}
+
+
+// every key of 0..0xffff
+void test_vendor_ids()
+{
+  uint32_t bad_hash = 0, bad_binary = 0, bad_interpolation = 0, hits = 0;
+  for (uint32_t key=0; key<=0xffff; key++) {
+    int32_t const idx = linear_search(key, usb_vid_keys, usb_vids_count);
+    hits += idx >= 0;
+    bad_hash          += search<USB_IDS_SEARCH_HASH>(key, usb_vid_keys, usb_vids_count, &usb_vids_mph) != idx;
+    bad_binary        += search<USB_IDS_SEARCH_BINARY>(key, usb_vid_keys, usb_vids_count) != idx;
+    bad_interpolation += search<USB_IDS_SEARCH_INTERPOLATION>(key, usb_vid_keys, usb_vids_count) != idx;
+  }
+  CHECK(hits == usb_vids_count);
+  CHECK(bad_hash == 0);
+  CHECK(bad_binary == 0);
+  CHECK(bad_interpolation == 0);
+}
+
+
+// every product id of every vendor, the ids around them and both ends of the range
+void test_product_ids()
+{
+  uint32_t bad_binary = 0, bad_interpolation = 0, hits = 0, misses = 0, unsorted = 0;
+  for (size_t v=0; v<usb_vids_count; v++) {
+    const uint16_t* const keys = &usb_pid_keys[usb_vids[v].product_id_t_idx];
+    size_t const count = usb_vids[v].product_count;
+    std::vector<uint16_t> probes = { 0x0000, 0xffff };
+    for (size_t i=0; i<count; i++) {
+      unsorted += i > 0 && keys[i-1] >= keys[i];
+      probes.push_back(keys[i]);
+      probes.push_back(keys[i] - 1);
+      probes.push_back(keys[i] + 1);
+    }
+    for (uint16_t key : probes) {
+      int32_t const idx = linear_search(key, keys, count);
+      hits += idx >= 0;
+      misses += idx < 0;
+      bad_binary        += search<USB_IDS_SEARCH_BINARY>(key, keys, count) != idx;
+      bad_interpolation += search<USB_IDS_SEARCH_INTERPOLATION>(key, keys, count) != idx;
+    }
+  }
+  CHECK(hits > 0 && misses > 0);
+  CHECK(unsorted == 0);
+  CHECK(bad_binary == 0);
+  CHECK(bad_interpolation == 0);
+}
+
+
+// small tables: empty, a single key, keys at both ends of the range, a run of neighbours
+void test_small_tables()
+{
+  uint16_t const one[] = { 0x1234 };
+  uint16_t const ends[] = { 0x0000, 0x0001, 0xfffe, 0xffff };
+  uint16_t const run[] = { 10, 11, 12, 13, 14, 15, 16, 1000 };
+  struct { const uint16_t* keys; size_t count; } const tables[] = { { one, 0 }, { one, 1 }, { ends, 4 }, { ends + 1, 2 }, { run, 8 } };
+  for (auto& table : tables) {
+    for (uint32_t key=0; key<=0xffff; key++) {
+      int32_t const idx = linear_search(key, table.keys, table.count);
+      CHECK(search<USB_IDS_SEARCH_BINARY>(key, table.keys, table.count) == idx);
+      CHECK(search<USB_IDS_SEARCH_INTERPOLATION>(key, table.keys, table.count) == idx);
+    }
+  }
+}
+
+
+// gen.py strips the names
+static std::string trim(const std::string& text)
+{
+  size_t const first = text.find_first_not_of(" \t\r");
+  return first == std::string::npos ? "" : text.substr(first, text.find_last_not_of(" \t\r") + 1 - first);
+}
+
+
+// gen.py reads usb.ids as windows-1252, the few names beyond ASCII are compared up to their
+// first byte past it
+static bool same_name(const std::string& name, usb_ids_str_t str)
+{
+  std::string const decoded = usb_ids_name(str).c_str;
+  size_t len = 0;
+  while (len < name.size() && (uint8_t) name[len] < 0x80) len++;
+  return len == name.size() ? decoded == name : decoded.compare(0, len, name, 0, len) == 0;
+}
+
+
+// the names of usb.ids, down to its first list after the vendors
+void test_names()
+{
+  std::ifstream file("../../usb.org/usb.ids", std::ios::binary);
+  CHECK(file.good());
+  std::map<uint16_t, std::string> vendors;
+  std::map<std::pair<uint16_t, uint16_t>, std::string> products;
+  std::string line;
+  uint16_t vid = 0;
+  while (std::getline(file, line)) {
+    if (line.rfind("# List of", 0) == 0) break;
+    if (line.empty() || line[0] == '#') continue;
+    if (line[0] != '\t') {
+      vid = strtol(line.substr(0, 4).c_str(), NULL, 16);
+      vendors[vid] = trim(line.substr(6));
+    } else if (line[1] != '\t') {
+      products[{ vid, (uint16_t) strtol(line.substr(1, 4).c_str(), NULL, 16) }] = trim(line.substr(7));
+    }
+  }
+  CHECK(vendors.size() == usb_vids_count);
+
+  uint32_t bad_vendors = 0, bad_products = 0;
+  for (uint32_t key=0; key<=0xffff; key++) {
+    const vendor_id_t* const vendor = get_vendor(key);
+    auto const it = vendors.find(key);
+    if (it == vendors.end()) bad_vendors += vendor != &nullVendor;
+    else bad_vendors += vendor == &nullVendor || !same_name(it->second, vendor->name);
+  }
+  for (auto& [ids, name] : products) {
+    auto const vid_pid = find_vid_pid(ids.first, ids.second);
+    bad_products += vid_pid.product == &nullProduct || !same_name(name, vid_pid.product->name);
+    // the next id is a miss unless usb.ids lists it too
+    auto const next = find_vid_pid(ids.first, ids.second + 1);
+    bad_products += (next.product == &nullProduct) == (products.count({ ids.first, (uint16_t)(ids.second + 1) }) != 0);
+  }
+  CHECK(bad_vendors == 0);
+  CHECK(bad_products == 0);
+  CHECK(find_vid_pid(0xffff, 0x0000).vendor == &nullVendor);
+  printf("  %zu vendors, %zu products\n", vendors.size(), products.size());
+}
+
+
+// every 16 bits page id, and every 16 bits usage id of each page
+void test_hid_usages()
+{
+  uint32_t bad_pages = 0, bad_usages = 0, usages = 0;
+  for (uint32_t page_id=0; page_id<=0xffff; page_id++) {
+    const hid_usage_page_t* expected = &nullUsagePage;
+    uint32_t const listed_id = page_id >= 0xff00 ? 0xff : page_id;
+    for (size_t i=0; i<hid_usage_pages_count && listed_id<=0xff; i++) {
+      if (hid_usage_pages[i].page_id == listed_id) expected = &hid_usage_pages[i];
+    }
+    bad_pages += get_hid_usage_page(page_id) != expected;
+  }
+  for (size_t p=0; p<hid_usage_pages_count; p++) {
+    const hid_usage_page_t* const page = &hid_usage_pages[p];
+    const hid_usage_t* const slice = &hid_usages[page->usage_t_idx];
+    for (uint32_t usage_id=0; usage_id<=0xffff; usage_id++) {
+      const hid_usage_t* expected = &nullUsage;
+      for (size_t i=0; i<page->usage_count; i++) {
+        if (slice[i].usage_id == usage_id) expected = &slice[i];
+      }
+      usages += expected != &nullUsage;
+      bad_usages += get_hid_usage(page, usage_id) != expected;
+    }
+  }
+  CHECK(bad_pages == 0);
+  CHECK(bad_usages == 0);
+  CHECK(usages == hid_usages_count);
+}
+
+
+// every 16 bits LANGID
+void test_langids()
+{
+  uint32_t bad = 0, dialects = 0;
+  for (uint32_t langid=0; langid<=0xffff; langid++) {
+    const usb_lang_t* lang = &nullLang;
+    const usb_dialect_t* dialect = &nullDialect;
+    for (size_t i=0; i<usb_langs_count; i++) {
+      if (usb_langs[i].lang_id != (langid & 0x3ff)) continue;
+      lang = &usb_langs[i];
+      for (size_t d=0; d<lang->dialect_count; d++) {
+        if (usb_dialects[lang->dialect_t_idx + d].dialect_id == langid >> 10) dialect = &usb_dialects[lang->dialect_t_idx + d];
+      }
+    }
+    auto const found = get_lang(langid);
+    dialects += dialect != &nullDialect;
+    bad += found.lang != lang || found.dialect != dialect;
+  }
+  CHECK(bad == 0);
+  CHECK(dialects > 0);
+}
+
+
+int main()
+{
+  test_vendor_ids();
+  test_product_ids();
+  test_small_tables();
+  test_names();
+  test_hid_usages();
+  test_langids();
+  return check_exit("test_search");
+}
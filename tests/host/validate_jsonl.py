@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+# Checks the JSON Lines output of the sketch (console command 'j') against
+# lsusb.schema.json, the console text between the lines is skipped.
+# Needs the jsonschema package.
+#
+#   validate_jsonl.py RECORDING     - for stdin
+
+import argparse
+import json
+import os
+import sys
+
+import jsonschema
+
+
+def validate_json_lines(text, schema, out):
+    validator = jsonschema.Draft7Validator(schema)
+    lines, errors = 0, 0
+    for number, line in enumerate(text.splitlines(), 1):
+        if not line.startswith("{"):
+            continue
+        lines += 1
+        try:
+            instance = json.loads(line)
+        except ValueError as error:
+            out.write("  line %d: %s\n" % (number, error))
+            errors += 1
+            continue
+        for error in validator.iter_errors(instance):
+            out.write("  line %d: %s at /%s\n" % (number, error.message, "/".join(str(element) for element in error.absolute_path)))
+            errors += 1
+    return lines, errors
+
+
+def main():
+    arg_parser = argparse.ArgumentParser(description="Check JSON Lines recorded after the 'j' command against the schema")
+    arg_parser.add_argument("recording", help="the recorded serial output, - for stdin")
+    arg_parser.add_argument("--schema", default=os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "..", "lsusb.schema.json"), help="the schema")
+    args = arg_parser.parse_args()
+    with open(args.schema, 'r', encoding='utf-8') as schema_file:
+        schema = json.load(schema_file)
+    if args.recording == "-":
+        text = sys.stdin.read()
+    else:
+        with open(args.recording, 'r', encoding='utf-8', errors='replace') as recording_file:
+            text = recording_file.read()
+    lines, errors = validate_json_lines(text, schema, sys.stdout)
+    print("%d JSON lines, %d errors" % (lines, errors))
+    return 1 if errors else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,1328 @@
+/* usb.ids sha1: 80f86e09c44381bcf6504c2fc70de3096348c5cf */
+/* Generated by lsusb for rp2040 */
+struct hid_usage_page_t { uint8_t page_id; const char* name; uint16_t usage_t_idx; uint16_t usage_count; };
+
+constexpr hid_usage_page_t hid_usage_pages[] = 
+{
+  {0x00, "Undefined", 0, 0},
+  {0x01, "Generic Desktop Controls", 0, 48},
+  {0x02, "Simulation Controls", 48, 52},
+  {0x03, "VR Controls", 100, 13},
+  {0x04, "Sport Controls", 113, 35},
+  {0x05, "Game Controls", 148, 30},
+  {0x07, "Keyboard", 178, 172},
+  {0x08, "LEDs", 350, 78},
+  {0x09, "Buttons", 428, 6},
+  {0x0a, "Ordinal", 434, 3},
+  {0x0b, "Telephony", 437, 63},
+  {0x0c, "Consumer", 500, 227},
+  {0x0d, "Digitizer", 727, 48},
+  {0x0f, "PID Page", 775, 106},
+  {0x10, "Unicode", 881, 0},
+  {0x14, "Alphanumeric Display", 881, 36},
+  {0x80, "USB Monitor", 917, 4},
+  {0x81, "USB Monitor Enumerated Values", 921, 0},
+  {0x82, "Monitor VESA Virtual Controls", 921, 44},
+  {0x84, "Power Device Page", 965, 79},
+  {0x85, "Battery System Page", 1044, 92},
+  {0x86, "Power Pages", 1136, 0},
+  {0x87, "Power Pages", 1136, 0},
+  {0x8c, "Bar Code Scanner Page (POS)", 1136, 0},
+  {0x8d, "Scale Page (POS)", 1136, 0},
+  {0x90, "Camera Control Page", 1136, 0},
+  {0x91, "Arcade Control Page", 1136, 0},
+  {0xf0, "Cash Device", 1136, 4},
+  {0xff, "Vendor Specific", 1140, 0},
+};
+
+/* Generated by lsusb for rp2040 */
+struct hid_usage_t { uint16_t usage_id; const char* name; };
+
+constexpr hid_usage_t hid_usages[] = 
+{
+  {0x000, "Undefined"},
+  {0x001, "Pointer"},
+  {0x002, "Mouse"},
+  {0x004, "Joystick"},
+  {0x005, "Gamepad"},
+  {0x006, "Keyboard"},
+  {0x007, "Keypad"},
+  {0x008, "Multi-Axis Controller"},
+  {0x030, "Direction-X"},
+  {0x031, "Direction-Y"},
+  {0x032, "Direction-Z"},
+  {0x033, "Rotate-X"},
+  {0x034, "Rotate-Y"},
+  {0x035, "Rotate-Z"},
+  {0x036, "Slider"},
+  {0x037, "Dial"},
+  {0x038, "Wheel"},
+  {0x039, "Hat Switch"},
+  {0x03a, "Counted Buffer"},
+  {0x03b, "Byte Count"},
+  {0x03c, "Motion Wakeup"},
+  {0x03d, "Start"},
+  {0x03e, "Select"},
+  {0x040, "Vector-X"},
+  {0x041, "Vector-Y"},
+  {0x042, "Vector-Z"},
+  {0x043, "Vector-X relative Body"},
+  {0x044, "Vector-Y relative Body"},
+  {0x045, "Vector-Z relative Body"},
+  {0x046, "Vector"},
+  {0x080, "System Control"},
+  {0x081, "System Power Down"},
+  {0x082, "System Sleep"},
+  {0x083, "System Wake Up"},
+  {0x084, "System Context Menu"},
+  {0x085, "System Main Menu"},
+  {0x086, "System App Menu"},
+  {0x087, "System Menu Help"},
+  {0x088, "System Menu Exit"},
+  {0x089, "System Menu Select"},
+  {0x08a, "System Menu Right"},
+  {0x08b, "System Menu Left"},
+  {0x08c, "System Menu Up"},
+  {0x08d, "System Menu Down"},
+  {0x090, "Direction Pad Up"},
+  {0x091, "Direction Pad Down"},
+  {0x092, "Direction Pad Right"},
+  {0x093, "Direction Pad Left"},
+  {0x000, "Undefined"},
+  {0x001, "Flight Simulation Device"},
+  {0x002, "Automobile Simulation Device"},
+  {0x003, "Tank Simulation Device"},
+  {0x004, "Spaceship Simulation Device"},
+  {0x005, "Submarine Simulation Device"},
+  {0x006, "Sailing Simulation Device"},
+  {0x007, "Motorcycle Simulation Device"},
+  {0x008, "Sports Simulation Device"},
+  {0x009, "Airplane Simualtion Device"},
+  {0x00a, "Helicopter Simulation Device"},
+  {0x00b, "Magic Carpet Simulation Device"},
+  {0x00c, "Bicycle Simulation Device"},
+  {0x020, "Flight Control Stick"},
+  {0x021, "Flight Stick"},
+  {0x022, "Cyclic Control"},
+  {0x023, "Cyclic Trim"},
+  {0x024, "Flight Yoke"},
+  {0x025, "Track Control"},
+  {0x0b0, "Aileron"},
+  {0x0b1, "Aileron Trim"},
+  {0x0b2, "Anti-Torque Control"},
+  {0x0b3, "Autopilot Enable"},
+  {0x0b4, "Chaff Release"},
+  {0x0b5, "Collective Control"},
+  {0x0b6, "Dive Break"},
+  {0x0b7, "Electronic Countermeasures"},
+  {0x0b8, "Elevator"},
+  {0x0b9, "Elevator Trim"},
+  {0x0ba, "Rudder"},
+  {0x0bb, "Throttle"},
+  {0x0bc, "Flight COmmunications"},
+  {0x0bd, "Flare Release"},
+  {0x0be, "Landing Gear"},
+  {0x0bf, "Toe Break"},
+  {0x0c0, "Trigger"},
+  {0x0c1, "Weapon Arm"},
+  {0x0c2, "Weapons Select"},
+  {0x0c3, "Wing Flaps"},
+  {0x0c4, "Accelerator"},
+  {0x0c5, "Brake"},
+  {0x0c6, "Clutch"},
+  {0x0c7, "Shifter"},
+  {0x0c8, "Steering"},
+  {0x0c9, "Turret Direction"},
+  {0x0ca, "Barrel Elevation"},
+  {0x0cb, "Drive Plane"},
+  {0x0cc, "Ballast"},
+  {0x0cd, "Bicylce Crank"},
+  {0x0ce, "Handle Bars"},
+  {0x0cf, "Front Brake"},
+  {0x0d0, "Rear Brake"},
+  {0x000, "Unidentified"},
+  {0x001, "Belt"},
+  {0x002, "Body Suit"},
+  {0x003, "Flexor"},
+  {0x004, "Glove"},
+  {0x005, "Head Tracker"},
+  {0x006, "Head Mounted Display"},
+  {0x007, "Hand Tracker"},
+  {0x008, "Oculometer"},
+  {0x009, "Vest"},
+  {0x00a, "Animatronic Device"},
+  {0x020, "Stereo Enable"},
+  {0x021, "Display Enable"},
+  {0x000, "Unidentified"},
+  {0x001, "Baseball Bat"},
+  {0x002, "Golf Club"},
+  {0x003, "Rowing Machine"},
+  {0x004, "Treadmill"},
+  {0x030, "Oar"},
+  {0x031, "Slope"},
+  {0x032, "Rate"},
+  {0x033, "Stick Speed"},
+  {0x034, "Stick Face Angle"},
+  {0x035, "Stick Heel/Toe"},
+  {0x036, "Stick Follow Through"},
+  {0x038, "Stick Type"},
+  {0x039, "Stick Height"},
+  {0x047, "Stick Temp"},
+  {0x050, "Putter"},
+  {0x051, "1 Iron"},
+  {0x052, "2 Iron"},
+  {0x053, "3 Iron"},
+  {0x054, "4 Iron"},
+  {0x055, "5 Iron"},
+  {0x056, "6 Iron"},
+  {0x057, "7 Iron"},
+  {0x058, "8 Iron"},
+  {0x059, "9 Iron"},
+  {0x05a, "10 Iron"},
+  {0x05b, "11 Iron"},
+  {0x05c, "Sand Wedge"},
+  {0x05d, "Loft Wedge"},
+  {0x05e, "Power Wedge"},
+  {0x05f, "1 Wood"},
+  {0x060, "3 Wood"},
+  {0x061, "5 Wood"},
+  {0x062, "7 Wood"},
+  {0x063, "9 Wood"},
+  {0x000, "Undefined"},
+  {0x001, "3D Game Controller"},
+  {0x002, "Pinball Device"},
+  {0x003, "Gun Device"},
+  {0x020, "Point Of View"},
+  {0x021, "Turn Right/Left"},
+  {0x022, "Pitch Right/Left"},
+  {0x023, "Roll Forward/Backward"},
+  {0x024, "Move Right/Left"},
+  {0x025, "Move Forward/Backward"},
+  {0x026, "Move Up/Down"},
+  {0x027, "Lean Right/Left"},
+  {0x028, "Lean Forward/Backward"},
+  {0x029, "Height of POV"},
+  {0x02a, "Flipper"},
+  {0x02b, "Secondary Flipper"},
+  {0x02c, "Bump"},
+  {0x02d, "New Game"},
+  {0x02e, "Shoot Ball"},
+  {0x02f, "Player"},
+  {0x030, "Gun Bolt"},
+  {0x031, "Gun Clip"},
+  {0x032, "Gun Selector"},
+  {0x033, "Gun Single Shot"},
+  {0x034, "Gun Burst"},
+  {0x035, "Gun Automatic"},
+  {0x036, "Gun Safety"},
+  {0x037, "Gamepad Fire/Jump"},
+  {0x038, "Gamepad Fun"},
+  {0x039, "Gamepad Trigger"},
+  {0x000, "No Event"},
+  {0x001, "Keyboard ErrorRollOver"},
+  {0x002, "Keyboard POSTfail"},
+  {0x003, "Keyboard Error Undefined"},
+  {0x004, "A"},
+  {0x005, "B"},
+  {0x006, "C"},
+  {0x007, "D"},
+  {0x008, "E"},
+  {0x009, "F"},
+  {0x00a, "G"},
+  {0x00b, "H"},
+  {0x00c, "I"},
+  {0x00d, "J"},
+  {0x00e, "K"},
+  {0x00f, "L"},
+  {0x010, "M"},
+  {0x011, "N"},
+  {0x012, "O"},
+  {0x013, "P"},
+  {0x014, "Q"},
+  {0x015, "R"},
+  {0x016, "S"},
+  {0x017, "T"},
+  {0x018, "U"},
+  {0x019, "V"},
+  {0x01a, "W"},
+  {0x01b, "X"},
+  {0x01c, "Y"},
+  {0x01d, "Z"},
+  {0x01e, "1 and ! (One and Exclamation)"},
+  {0x01f, "2 and @ (2 and at)"},
+  {0x020, "3 and # (3 and Hash)"},
+  {0x021, "4 and $ (4 and Dollar Sign)"},
+  {0x022, "5 and % (5 and Percent Sign)"},
+  {0x023, "6 and ^ (6 and circumflex)"},
+  {0x024, "7 and & (Seven and Ampersand)"},
+  {0x025, "8 and * (Eight and asterisk)"},
+  {0x026, "9 and ( (Nine and Parenthesis Left)"},
+  {0x027, "0 and ) (Zero and Parenthesis Right)"},
+  {0x028, "Return (Enter)"},
+  {0x029, "Escape"},
+  {0x02a, "Delete (Backspace)"},
+  {0x02b, "Tab"},
+  {0x02c, "Space Bar"},
+  {0x02d, "- and _ (Minus and underscore)"},
+  {0x02e, "= and + (Equal and Plus)"},
+  {0x02f, "[ and { (Bracket and Braces Left)"},
+  {0x030, "] and } (Bracket and Braces Right)"},
+  {0x031, "\\ and | (Backslash and Bar)"},
+  {0x032, "# and ~ (Hash and Tilde, Non-US Keyboard near right shift)"},
+  {0x033, "; and : (Semicolon and Colon)"},
+  {0x034, "´ and \" (Accent Acute and Double Quotes)"},
+  {0x035, "` and ~ (Accent Grace and Tilde)"},
+  {0x036, ", and < (Comma and Less)"},
+  {0x037, ". and > (Period and Greater)"},
+  {0x038, "/ and ? (Slash and Question Mark)"},
+  {0x039, "Caps Lock"},
+  {0x03a, "F1"},
+  {0x03b, "F2"},
+  {0x03c, "F3"},
+  {0x03d, "F4"},
+  {0x03e, "F5"},
+  {0x03f, "F6"},
+  {0x040, "F7"},
+  {0x041, "F8"},
+  {0x042, "F9"},
+  {0x043, "F10"},
+  {0x044, "F11"},
+  {0x045, "F12"},
+  {0x046, "Print Screen"},
+  {0x047, "Scroll Lock"},
+  {0x048, "Pause"},
+  {0x049, "Insert"},
+  {0x04a, "Home"},
+  {0x04b, "Page Up"},
+  {0x04c, "Delete Forward (without Changing Position)"},
+  {0x04d, "End"},
+  {0x04e, "Page Down"},
+  {0x04f, "Right Arrow"},
+  {0x050, "Left Arrow"},
+  {0x051, "Down Arrow"},
+  {0x052, "Up Arrow"},
+  {0x053, "Num Lock and Clear"},
+  {0x054, "Keypad / (Division Sign)"},
+  {0x055, "Keypad * (Multiplication Sign)"},
+  {0x056, "Keypad - (Subtraction Sign)"},
+  {0x057, "Keypad + (Addition Sign)"},
+  {0x058, "Keypad Enter"},
+  {0x059, "Keypad 1 and END"},
+  {0x05a, "Keypad 2 and Down Arrow"},
+  {0x05b, "Keypad 3 and Page Down"},
+  {0x05c, "Keypad 4 and Left Arrow"},
+  {0x05d, "Keypad 5 (Tactilei Raised)"},
+  {0x05f, "Keypad 6 and Right Arrow"},
+  {0x060, "Keypad 7 and Home"},
+  {0x061, "Keypad 8 and Up Arrow"},
+  {0x062, "Keypad 8 and Page Up"},
+  {0x063, "Keypad . (decimal delimiter) and Delete"},
+  {0x064, "\\ and | (Backslash and Bar, UK and Non-US Keyboard near left shift)"},
+  {0x065, "Keyboard Application (Windows Key for Win95 or Compose)"},
+  {0x066, "Power (not a key)"},
+  {0x067, "Keypad = (Equal Sign)"},
+  {0x068, "F13"},
+  {0x069, "F14"},
+  {0x06a, "F15"},
+  {0x06b, "F16"},
+  {0x06c, "F17"},
+  {0x06d, "F18"},
+  {0x06e, "F19"},
+  {0x06f, "F20"},
+  {0x070, "F21"},
+  {0x071, "F22"},
+  {0x072, "F23"},
+  {0x073, "F24"},
+  {0x074, "Execute"},
+  {0x075, "Help"},
+  {0x076, "Menu"},
+  {0x077, "Select"},
+  {0x078, "Stop"},
+  {0x079, "Again"},
+  {0x07a, "Undo"},
+  {0x07b, "Cut"},
+  {0x07c, "Copy"},
+  {0x07d, "Paste"},
+  {0x07e, "Find"},
+  {0x07f, "Mute"},
+  {0x080, "Volume Up"},
+  {0x081, "Volume Down"},
+  {0x082, "Locking Caps Lock"},
+  {0x083, "Locking Num Lock"},
+  {0x084, "Locking Scroll Lock"},
+  {0x085, "Keypad Comma"},
+  {0x086, "Keypad Equal Sign (AS/400)"},
+  {0x087, "International 1 (PC98)"},
+  {0x088, "International 2 (PC98)"},
+  {0x089, "International 3 (PC98)"},
+  {0x08a, "International 4 (PC98)"},
+  {0x08b, "International 5 (PC98)"},
+  {0x08c, "International 6 (PC98)"},
+  {0x08d, "International 7 (Toggle Single/Double Byte Mode)"},
+  {0x08e, "International 8"},
+  {0x08f, "International 9"},
+  {0x090, "LANG 1 (Hangul/English Toggle, Korea)"},
+  {0x091, "LANG 2 (Hanja Conversion, Korea)"},
+  {0x092, "LANG 3 (Katakana, Japan)"},
+  {0x093, "LANG 4 (Hiragana, Japan)"},
+  {0x094, "LANG 5 (Zenkaku/Hankaku, Japan)"},
+  {0x095, "LANG 6"},
+  {0x096, "LANG 7"},
+  {0x097, "LANG 8"},
+  {0x098, "LANG 9"},
+  {0x099, "Alternate Erase"},
+  {0x09a, "SysReq/Attention"},
+  {0x09b, "Cancel"},
+  {0x09c, "Clear"},
+  {0x09d, "Prior"},
+  {0x09e, "Return"},
+  {0x09f, "Separator"},
+  {0x0a0, "Out"},
+  {0x0a1, "Open"},
+  {0x0a2, "Clear/Again"},
+  {0x0a3, "CrSel/Props"},
+  {0x0a4, "ExSel"},
+  {0x0e0, "Control Left"},
+  {0x0e1, "Shift Left"},
+  {0x0e2, "Alt Left"},
+  {0x0e3, "GUI Left"},
+  {0x0e4, "Control Right"},
+  {0x0e5, "Shift Right"},
+  {0x0e6, "Alt Rigth"},
+  {0x0e7, "GUI Right"},
+  {0x000, "Undefined"},
+  {0x001, "NumLock"},
+  {0x002, "CapsLock"},
+  {0x003, "Scroll Lock"},
+  {0x004, "Compose"},
+  {0x005, "Kana"},
+  {0x006, "Power"},
+  {0x007, "Shift"},
+  {0x008, "Do not disturb"},
+  {0x009, "Mute"},
+  {0x00a, "Tone Enabke"},
+  {0x00b, "High Cut Filter"},
+  {0x00c, "Low Cut Filter"},
+  {0x00d, "Equalizer Enable"},
+  {0x00e, "Sound Field ON"},
+  {0x00f, "Surround On"},
+  {0x010, "Repeat"},
+  {0x011, "Stereo"},
+  {0x012, "Sampling Rate Detect"},
+  {0x013, "Spinning"},
+  {0x014, "CAV"},
+  {0x015, "CLV"},
+  {0x016, "Recording Format Detect"},
+  {0x017, "Off-Hook"},
+  {0x018, "Ring"},
+  {0x019, "Message Waiting"},
+  {0x01a, "Data Mode"},
+  {0x01b, "Battery Operation"},
+  {0x01c, "Battery OK"},
+  {0x01d, "Battery Low"},
+  {0x01e, "Speaker"},
+  {0x01f, "Head Set"},
+  {0x020, "Hold"},
+  {0x021, "Microphone"},
+  {0x022, "Coverage"},
+  {0x023, "Night Mode"},
+  {0x024, "Send Calls"},
+  {0x025, "Call Pickup"},
+  {0x026, "Conference"},
+  {0x027, "Stand-by"},
+  {0x028, "Camera On"},
+  {0x029, "Camera Off"},
+  {0x02a, "On-Line"},
+  {0x02b, "Off-Line"},
+  {0x02c, "Busy"},
+  {0x02d, "Ready"},
+  {0x02e, "Paper-Out"},
+  {0x02f, "Paper-Jam"},
+  {0x030, "Remote"},
+  {0x031, "Forward"},
+  {0x032, "Reverse"},
+  {0x033, "Stop"},
+  {0x034, "Rewind"},
+  {0x035, "Fast Forward"},
+  {0x036, "Play"},
+  {0x037, "Pause"},
+  {0x038, "Record"},
+  {0x039, "Error"},
+  {0x03a, "Usage Selected Indicator"},
+  {0x03b, "Usage In Use Indicator"},
+  {0x03c, "Usage Multi Indicator"},
+  {0x03d, "Indicator On"},
+  {0x03e, "Indicator Flash"},
+  {0x03f, "Indicator Slow Blink"},
+  {0x040, "Indicator Fast Blink"},
+  {0x041, "Indicator Off"},
+  {0x042, "Flash On Time"},
+  {0x043, "Slow Blink On Time"},
+  {0x044, "Slow Blink Off Time"},
+  {0x045, "Fast Blink On Time"},
+  {0x046, "Fast Blink Off Time"},
+  {0x047, "Usage Color Indicator"},
+  {0x048, "Indicator Red"},
+  {0x049, "Indicator Green"},
+  {0x04a, "Indicator Amber"},
+  {0x04b, "Generic Indicator"},
+  {0x04c, "System Suspend"},
+  {0x04d, "External Power Connected"},
+  {0x000, "No Button Pressed"},
+  {0x001, "Button 1 (Primary)"},
+  {0x002, "Button 2 (Secondary)"},
+  {0x003, "Button 3 (Tertiary)"},
+  {0x004, "Button 4"},
+  {0x005, "Button 5"},
+  {0x001, "Instance 1"},
+  {0x002, "Instance 2"},
+  {0x003, "Instance 3"},
+  {0x000, "Unassigned"},
+  {0x001, "Phone"},
+  {0x002, "Answering Machine"},
+  {0x003, "Message Controls"},
+  {0x004, "Handset"},
+  {0x005, "Headset"},
+  {0x006, "Telephony Key Pad"},
+  {0x007, "Programmable Button"},
+  {0x020, "Hook Switch"},
+  {0x021, "Flash"},
+  {0x022, "Feature"},
+  {0x023, "Hold"},
+  {0x024, "Redial"},
+  {0x025, "Transfer"},
+  {0x026, "Drop"},
+  {0x027, "Park"},
+  {0x028, "Forward Calls"},
+  {0x029, "Alternate Function"},
+  {0x02a, "Line"},
+  {0x02b, "Speaker Phone"},
+  {0x02c, "Conference"},
+  {0x02d, "Ring Enable"},
+  {0x02e, "Ring Select"},
+  {0x02f, "Phone Mute"},
+  {0x030, "Caller ID"},
+  {0x050, "Speed Dial"},
+  {0x051, "Store Number"},
+  {0x052, "Recall Number"},
+  {0x053, "Phone Directory"},
+  {0x070, "Voice Mail"},
+  {0x071, "Screen Calls"},
+  {0x072, "Do Not Disturb"},
+  {0x073, "Message"},
+  {0x074, "Answer On/Offf"},
+  {0x090, "Inside Dial Tone"},
+  {0x091, "Outside Dial Tone"},
+  {0x092, "Inside Ring Tone"},
+  {0x093, "Outside Ring Tone"},
+  {0x094, "Priority Ring Tone"},
+  {0x095, "Inside Ringback"},
+  {0x096, "Priority Ringback"},
+  {0x097, "Line Busy Tone"},
+  {0x098, "Recorder Tone"},
+  {0x099, "Call Waiting Tone"},
+  {0x09a, "Confirmation Tone 1"},
+  {0x09b, "Confirmation Tone 2"},
+  {0x09c, "Tones Off"},
+  {0x09d, "Outside Ringback"},
+  {0x0b0, "Key 1"},
+  {0x0b1, "Key 2"},
+  {0x0b3, "Key 3"},
+  {0x0b4, "Key 4"},
+  {0x0b5, "Key 5"},
+  {0x0b6, "Key 6"},
+  {0x0b7, "Key 7"},
+  {0x0b8, "Key 8"},
+  {0x0b9, "Key 9"},
+  {0x0ba, "Key Star"},
+  {0x0bb, "Key Pound"},
+  {0x0bc, "Key A"},
+  {0x0bd, "Key B"},
+  {0x0be, "Key C"},
+  {0x0bf, "Key D"},
+  {0x000, "Unassigned"},
+  {0x001, "Consumer Control"},
+  {0x002, "Numeric Key Pad"},
+  {0x003, "Programmable Buttons"},
+  {0x020, "+10"},
+  {0x021, "+100"},
+  {0x022, "AM/PM"},
+  {0x030, "Power"},
+  {0x031, "Reset"},
+  {0x032, "Sleep"},
+  {0x033, "Sleep After"},
+  {0x034, "Sleep Mode"},
+  {0x035, "Illumination"},
+  {0x036, "Function Buttons"},
+  {0x040, "Menu"},
+  {0x041, "Menu Pick"},
+  {0x042, "Menu Up"},
+  {0x043, "Menu Down"},
+  {0x044, "Menu Left"},
+  {0x045, "Menu Right"},
+  {0x046, "Menu Escape"},
+  {0x047, "Menu Value Increase"},
+  {0x048, "Menu Value Decrease"},
+  {0x060, "Data on Screen"},
+  {0x061, "Closed Caption"},
+  {0x062, "Closed Caption Select"},
+  {0x063, "VCR/TV"},
+  {0x064, "Broadcast Mode"},
+  {0x065, "Snapshot"},
+  {0x066, "Still"},
+  {0x080, "Selection"},
+  {0x081, "Assign Selection"},
+  {0x082, "Mode Step"},
+  {0x083, "Recall Last"},
+  {0x084, "Enter Channel"},
+  {0x085, "Order Movie"},
+  {0x086, "Channel"},
+  {0x087, "Media Selection"},
+  {0x088, "Media Select Computer"},
+  {0x089, "Media Select TV"},
+  {0x08a, "Media Select WWW"},
+  {0x08b, "Media Select DVD"},
+  {0x08c, "Media Select Telephone"},
+  {0x08d, "Media Select Program Guide"},
+  {0x08e, "Media Select Video Phone"},
+  {0x08f, "Media Select Games"},
+  {0x090, "Media Select Messages"},
+  {0x091, "Media Select CD"},
+  {0x092, "Media Select VCR"},
+  {0x093, "Media Select Tuner"},
+  {0x094, "Quit"},
+  {0x095, "Help"},
+  {0x096, "Media Select Tape"},
+  {0x097, "Media Select Cable"},
+  {0x098, "Media Select Satellite"},
+  {0x099, "Media Select Security"},
+  {0x09a, "Media Select Home"},
+  {0x09b, "Media Select Call"},
+  {0x09c, "Channel Increment"},
+  {0x09d, "Channel Decrement"},
+  {0x09e, "Media Select SAP"},
+  {0x0a0, "VCR Plus"},
+  {0x0a1, "Once"},
+  {0x0a2, "Daily"},
+  {0x0a3, "Weekly"},
+  {0x0a4, "Monthly"},
+  {0x0b0, "Play"},
+  {0x0b1, "Pause"},
+  {0x0b2, "Record"},
+  {0x0b3, "Fast Forward"},
+  {0x0b4, "Rewind"},
+  {0x0b5, "Scan Next Track"},
+  {0x0b6, "Scan Previous Track"},
+  {0x0b7, "Stop"},
+  {0x0b8, "Eject"},
+  {0x0b9, "Random Play"},
+  {0x0ba, "Select Disc"},
+  {0x0bb, "Enter Disc"},
+  {0x0bc, "Repeat"},
+  {0x0bd, "Tracking"},
+  {0x0be, "Track Normal"},
+  {0x0bf, "Slow Tracking"},
+  {0x0c0, "Frame Forward"},
+  {0x0c1, "Frame Back"},
+  {0x0c2, "Mark"},
+  {0x0c3, "Clear Mark"},
+  {0x0c4, "Repeat from Mark"},
+  {0x0c5, "Return to Mark"},
+  {0x0c6, "Search Mark Forward"},
+  {0x0c7, "Search Mark Backward"},
+  {0x0c8, "Counter Reset"},
+  {0x0c9, "Show Counter"},
+  {0x0ca, "Tracking Increment"},
+  {0x0cb, "Tracking Decrement"},
+  {0x0cc, "Stop/Eject"},
+  {0x0cd, "Play/Pause"},
+  {0x0ce, "Play/Skip"},
+  {0x0e0, "Volume"},
+  {0x0e1, "Balance"},
+  {0x0e2, "Mute"},
+  {0x0e3, "Bass"},
+  {0x0e4, "Treble"},
+  {0x0e5, "Bass Boost"},
+  {0x0e6, "Surround Mode"},
+  {0x0e7, "Loudness"},
+  {0x0e8, "MPX"},
+  {0x0e9, "Volume Increment"},
+  {0x0ea, "Volume Decrement"},
+  {0x0f0, "Speed Select"},
+  {0x0f1, "Playback Speed"},
+  {0x0f2, "Standard Play"},
+  {0x0f3, "Long Play"},
+  {0x0f4, "Extended Play"},
+  {0x0f5, "Slow"},
+  {0x100, "Fan Enable"},
+  {0x101, "Fan Speed"},
+  {0x102, "Light Enable"},
+  {0x103, "Light Illumination Level"},
+  {0x104, "Climate Control Enable"},
+  {0x105, "Room Temperature"},
+  {0x106, "Security Enable"},
+  {0x107, "Fire Alarm"},
+  {0x108, "Police Alarm"},
+  {0x150, "Balance Right"},
+  {0x151, "Balance Left"},
+  {0x152, "Bass Increment"},
+  {0x153, "Bass Decrement"},
+  {0x154, "Treble Increment"},
+  {0x155, "Treble Decrement"},
+  {0x160, "Speaker System"},
+  {0x161, "Channel Left"},
+  {0x162, "Channel Right"},
+  {0x163, "Channel Center"},
+  {0x164, "Channel Front"},
+  {0x165, "Channel Center Front"},
+  {0x166, "Channel Side"},
+  {0x167, "Channel Surround"},
+  {0x168, "Channel Low Frequency Enhancement"},
+  {0x169, "Channel Top"},
+  {0x16a, "Channel Unknown"},
+  {0x170, "Sub-Channel"},
+  {0x171, "Sub-Channel Increment"},
+  {0x172, "Sub-Channel Decrement"},
+  {0x173, "Alternative Audio Increment"},
+  {0x174, "Alternative Audio Decrement"},
+  {0x180, "Application Launch Buttons"},
+  {0x181, "AL Launch Button Configuration Tool"},
+  {0x182, "AL Launch Button Configuration"},
+  {0x183, "AL Consumer Control Configuration"},
+  {0x184, "AL Word Processor"},
+  {0x185, "AL Text Editor"},
+  {0x186, "AL Spreadsheet"},
+  {0x187, "AL Graphics Editor"},
+  {0x188, "AL Presentation App"},
+  {0x189, "AL Database App"},
+  {0x18a, "AL Email Reader"},
+  {0x18b, "AL Newsreader"},
+  {0x18c, "AL Voicemail"},
+  {0x18d, "AL Contacts/Address Book"},
+  {0x18e, "AL Calendar/Schedule"},
+  {0x18f, "AL Task/Project Manager"},
+  {0x190, "AL Log/Jounal/Timecard"},
+  {0x191, "AL Checkbook/Finance"},
+  {0x192, "AL Calculator"},
+  {0x193, "AL A/V Capture/Playback"},
+  {0x194, "AL Local Machine Browser"},
+  {0x195, "AL LAN/Wan Browser"},
+  {0x196, "AL Internet Browser"},
+  {0x197, "AL Remote Networking/ISP Connect"},
+  {0x198, "AL Network Conference"},
+  {0x199, "AL Network Chat"},
+  {0x19a, "AL Telephony/Dialer"},
+  {0x19b, "AL Logon"},
+  {0x19c, "AL Logoff"},
+  {0x19d, "AL Logon/Logoff"},
+  {0x19e, "AL Terminal Local/Screensaver"},
+  {0x19f, "AL Control Panel"},
+  {0x1a0, "AL Command Line Processor/Run"},
+  {0x1a1, "AL Process/Task Manager"},
+  {0x1a2, "AL Select Task/Application"},
+  {0x1a3, "AL Next Task/Application"},
+  {0x1a4, "AL Previous Task/Application"},
+  {0x1a5, "AL Preemptive Halt Task/Application"},
+  {0x200, "Generic GUI Application Controls"},
+  {0x201, "AC New"},
+  {0x202, "AC Open"},
+  {0x203, "AC CLose"},
+  {0x204, "AC Exit"},
+  {0x205, "AC Maximize"},
+  {0x206, "AC Minimize"},
+  {0x207, "AC Save"},
+  {0x208, "AC Print"},
+  {0x209, "AC Properties"},
+  {0x21a, "AC Undo"},
+  {0x21b, "AC Copy"},
+  {0x21c, "AC Cut"},
+  {0x21d, "AC Paste"},
+  {0x21e, "AC Select All"},
+  {0x21f, "AC Find"},
+  {0x220, "AC Find and Replace"},
+  {0x221, "AC Search"},
+  {0x222, "AC Go To"},
+  {0x223, "AC Home"},
+  {0x224, "AC Back"},
+  {0x225, "AC Forward"},
+  {0x226, "AC Stop"},
+  {0x227, "AC Refresh"},
+  {0x228, "AC Previous Link"},
+  {0x229, "AC Next Link"},
+  {0x22b, "AC History"},
+  {0x22c, "AC Subscriptions"},
+  {0x22d, "AC Zoom In"},
+  {0x22e, "AC Zoom Out"},
+  {0x22f, "AC Zoom"},
+  {0x230, "AC Full Screen View"},
+  {0x231, "AC Normal View"},
+  {0x232, "AC View Toggle"},
+  {0x233, "AC Scroll Up"},
+  {0x234, "AC Scroll Down"},
+  {0x235, "AC Scroll"},
+  {0x236, "AC Pan Left"},
+  {0x237, "AC Pan Right"},
+  {0x238, "AC Pan"},
+  {0x239, "AC New Window"},
+  {0x23a, "AC Tile Horizontally"},
+  {0x23b, "AC Tile Vertically"},
+  {0x23c, "AC Format"},
+  {0x000, "Undefined"},
+  {0x001, "Digitizer"},
+  {0x002, "Pen"},
+  {0x003, "Light Pen"},
+  {0x004, "Touch Screen"},
+  {0x005, "Touch Pad"},
+  {0x006, "White Board"},
+  {0x007, "Coordinate Measuring Machine"},
+  {0x008, "3D Digitizer"},
+  {0x009, "Stereo Plotter"},
+  {0x00a, "Articulated Arm"},
+  {0x00b, "Armature"},
+  {0x00c, "Multiple Point Digitizer"},
+  {0x00d, "Free Space Wand"},
+  {0x020, "Stylus"},
+  {0x021, "Puck"},
+  {0x022, "Finger"},
+  {0x030, "Tip Pressure"},
+  {0x031, "Barrel Pressure"},
+  {0x032, "In Range"},
+  {0x033, "Touch"},
+  {0x034, "Untouch"},
+  {0x035, "Tap"},
+  {0x036, "Quality"},
+  {0x037, "Data Valid"},
+  {0x038, "Transducer Index"},
+  {0x039, "Tablet Function Keys"},
+  {0x03a, "Program Change Keys"},
+  {0x03b, "Battery Strength"},
+  {0x03c, "Invert"},
+  {0x03d, "X Tilt"},
+  {0x03e, "Y Tilt"},
+  {0x03f, "Azimuth"},
+  {0x040, "Altitude"},
+  {0x041, "Twist"},
+  {0x042, "Tip Switch"},
+  {0x043, "Secondary Tip Switch"},
+  {0x044, "Barrel Switch"},
+  {0x045, "Eraser"},
+  {0x046, "Tablet Pick"},
+  {0x047, "Confidence"},
+  {0x048, "Width"},
+  {0x049, "Height"},
+  {0x051, "Contact ID"},
+  {0x052, "Input Mode"},
+  {0x053, "Device Index"},
+  {0x054, "Contact Count"},
+  {0x055, "Maximum Contact Number"},
+  {0x000, "Undefined"},
+  {0x001, "Physical Interface Device"},
+  {0x020, "Normal"},
+  {0x021, "Set Effect Report"},
+  {0x022, "Effect Block Index"},
+  {0x023, "Parameter Block Offset"},
+  {0x024, "ROM Flag"},
+  {0x025, "Effect Type"},
+  {0x026, "ET Constant Force"},
+  {0x027, "ET Ramp"},
+  {0x028, "ET Custom Force Data"},
+  {0x030, "ET Square"},
+  {0x031, "ET Sine"},
+  {0x032, "ET Triangle"},
+  {0x033, "ET Sawtooth Up"},
+  {0x034, "ET Sawtooth Down"},
+  {0x040, "ET Spring"},
+  {0x041, "ET Damper"},
+  {0x042, "ET Inertia"},
+  {0x043, "ET Friction"},
+  {0x050, "Duration"},
+  {0x051, "Sample Period"},
+  {0x052, "Gain"},
+  {0x053, "Trigger Button"},
+  {0x054, "Trigger Repeat Interval"},
+  {0x055, "Axes Enable"},
+  {0x056, "Direction Enable"},
+  {0x057, "Direction"},
+  {0x058, "Type Specific Block Offset"},
+  {0x059, "Block Type"},
+  {0x05A, "Set Envelope Report"},
+  {0x05B, "Attack Level"},
+  {0x05C, "Attack Time"},
+  {0x05D, "Fade Level"},
+  {0x05E, "Fade Time"},
+  {0x05F, "Set Condition Report"},
+  {0x060, "CP Offset"},
+  {0x061, "Positive Coefficient"},
+  {0x062, "Negative Coefficient"},
+  {0x063, "Positive Saturation"},
+  {0x064, "Negative Saturation"},
+  {0x065, "Dead Band"},
+  {0x066, "Download Force Sample"},
+  {0x067, "Isoch Custom Force Enable"},
+  {0x068, "Custom Force Data Report"},
+  {0x069, "Custom Force Data"},
+  {0x06A, "Custom Force Vendor Defined Data"},
+  {0x06B, "Set Custom Force Report"},
+  {0x06C, "Custom Force Data Offset"},
+  {0x06D, "Sample Count"},
+  {0x06E, "Set Periodic Report"},
+  {0x06F, "Offset"},
+  {0x070, "Magnitude"},
+  {0x071, "Phase"},
+  {0x072, "Period"},
+  {0x073, "Set Constant Force Report"},
+  {0x074, "Set Ramp Force Report"},
+  {0x075, "Ramp Start"},
+  {0x076, "Ramp End"},
+  {0x077, "Effect Operation Report"},
+  {0x078, "Effect Operation"},
+  {0x079, "Op Effect Start"},
+  {0x07A, "Op Effect Start Solo"},
+  {0x07B, "Op Effect Stop"},
+  {0x07C, "Loop Count"},
+  {0x07D, "Device Gain Report"},
+  {0x07E, "Device Gain"},
+  {0x07F, "PID Pool Report"},
+  {0x080, "RAM Pool Size"},
+  {0x081, "ROM Pool Size"},
+  {0x082, "ROM Effect Block Count"},
+  {0x083, "Simultaneous Effects Max"},
+  {0x084, "Pool Alignment"},
+  {0x085, "PID Pool Move Report"},
+  {0x086, "Move Source"},
+  {0x087, "Move Destination"},
+  {0x088, "Move Length"},
+  {0x089, "PID Block Load Report"},
+  {0x08B, "Block Load Status"},
+  {0x08C, "Block Load Success"},
+  {0x08D, "Block Load Full"},
+  {0x08E, "Block Load Error"},
+  {0x08F, "Block Handle"},
+  {0x090, "PID Block Free Report"},
+  {0x091, "Type Specific Block Handle"},
+  {0x092, "PID State Report"},
+  {0x094, "Effect Playing"},
+  {0x095, "PID Device Control Report"},
+  {0x096, "PID Device Control"},
+  {0x097, "DC Enable Actuators"},
+  {0x098, "DC Disable Actuators"},
+  {0x099, "DC Stop All Effects"},
+  {0x09A, "DC Device Reset"},
+  {0x09B, "DC Device Pause"},
+  {0x09C, "DC Device Continue"},
+  {0x09F, "Device Paused"},
+  {0x0A0, "Actuators Enabled"},
+  {0x0A4, "Safety Switch"},
+  {0x0A5, "Actuator Override Switch"},
+  {0x0A6, "Actuator Power"},
+  {0x0A7, "Start Delay"},
+  {0x0A8, "Parameter Block Size"},
+  {0x0A9, "Device Managed Pool"},
+  {0x0AA, "Shared Parameter Blocks"},
+  {0x0AB, "Create New Effect Report"},
+  {0x0AC, "RAM Pool Available"},
+  {0x000, "Undefined"},
+  {0x001, "Alphanumeric Display"},
+  {0x020, "Display Attributes Report"},
+  {0x021, "ASCII Character Set"},
+  {0x022, "Data Read Back"},
+  {0x023, "Font Read Back"},
+  {0x024, "Display Control Report"},
+  {0x025, "Clear Display"},
+  {0x026, "Display Enable"},
+  {0x027, "Screen Saver Delay"},
+  {0x028, "Screen Saver Enable"},
+  {0x029, "Vertical Scroll"},
+  {0x02a, "Horizontal Scroll"},
+  {0x02b, "Character Report"},
+  {0x02c, "Display Data"},
+  {0x02d, "Display Status"},
+  {0x02e, "Stat Not Ready"},
+  {0x02f, "Stat Ready"},
+  {0x030, "Err Not a loadable Character"},
+  {0x031, "Err Font Data Cannot Be Read"},
+  {0x032, "Cursur Position Report"},
+  {0x033, "Row"},
+  {0x034, "Column"},
+  {0x035, "Rows"},
+  {0x036, "Columns"},
+  {0x037, "Cursor Pixel Positioning"},
+  {0x038, "Cursor Mode"},
+  {0x039, "Cursor Enable"},
+  {0x03a, "Cursor Blink"},
+  {0x03b, "Font Report"},
+  {0x03c, "Font Data"},
+  {0x03d, "Character Width"},
+  {0x03e, "Character Height"},
+  {0x03f, "Character Spacing Horizontal"},
+  {0x040, "Character Spacing Vertical"},
+  {0x041, "Unicode Character Set"},
+  {0x001, "Monitor Control"},
+  {0x002, "EDID Information"},
+  {0x003, "VDIF Information"},
+  {0x004, "VESA Version"},
+  {0x001, "Degauss"},
+  {0x010, "Brightness"},
+  {0x012, "Contrast"},
+  {0x016, "Red Video Gain"},
+  {0x018, "Green Video Gain"},
+  {0x01a, "Blue Video Gain"},
+  {0x01c, "Focus"},
+  {0x020, "Horizontal Position"},
+  {0x022, "Horizontal Size"},
+  {0x024, "Horizontal Pincushion"},
+  {0x026, "Horizontal Pincushion Balance"},
+  {0x028, "Horizontal Misconvergence"},
+  {0x02a, "Horizontal Linearity"},
+  {0x02c, "Horizontal Linearity Balance"},
+  {0x030, "Vertical Position"},
+  {0x032, "Vertical Size"},
+  {0x034, "Vertical Pincushion"},
+  {0x036, "Vertical Pincushion Balance"},
+  {0x038, "Vertical Misconvergence"},
+  {0x03a, "Vertical Linearity"},
+  {0x03c, "Vertical Linearity Balance"},
+  {0x040, "Parallelogram Balance (Key Distortion)"},
+  {0x042, "Trapezoidal Distortion (Key)"},
+  {0x044, "Tilt (Rotation)"},
+  {0x046, "Top Corner Distortion Control"},
+  {0x048, "Top Corner Distortion Balance"},
+  {0x04a, "Bottom Corner Distortion Control"},
+  {0x04c, "Bottom Corner Distortion Balance"},
+  {0x056, "Horizontal Moire"},
+  {0x058, "Vertical Moire"},
+  {0x05e, "Input Level Select"},
+  {0x060, "Input Source Select"},
+  {0x06c, "Red Video Black Level"},
+  {0x06e, "Green Video Black Level"},
+  {0x070, "Blue Video Black Level"},
+  {0x0a2, "Auto Size Center"},
+  {0x0a4, "Polarity Horizontal Sychronization"},
+  {0x0a6, "Polarity Vertical Synchronization"},
+  {0x0aa, "Screen Orientation"},
+  {0x0ac, "Horizontal Frequency in Hz"},
+  {0x0ae, "Vertical Frequency in 0.1 Hz"},
+  {0x0b0, "Settings"},
+  {0x0ca, "On Screen Display (OSD)"},
+  {0x0d4, "Stereo Mode"},
+  {0x000, "Undefined"},
+  {0x001, "iName"},
+  {0x002, "Present Status"},
+  {0x003, "Changed Status"},
+  {0x004, "UPS"},
+  {0x005, "Power Supply"},
+  {0x010, "Battery System"},
+  {0x011, "Battery System ID"},
+  {0x012, "Battery"},
+  {0x013, "Battery ID"},
+  {0x014, "Charger"},
+  {0x015, "Charger ID"},
+  {0x016, "Power Converter"},
+  {0x017, "Power Converter ID"},
+  {0x018, "Outlet System"},
+  {0x019, "Outlet System ID"},
+  {0x01a, "Input"},
+  {0x01b, "Input ID"},
+  {0x01c, "Output"},
+  {0x01d, "Output ID"},
+  {0x01e, "Flow"},
+  {0x01f, "Flow ID"},
+  {0x020, "Outlet"},
+  {0x021, "Outlet ID"},
+  {0x022, "Gang"},
+  {0x023, "Gang ID"},
+  {0x024, "Power Summary"},
+  {0x025, "Power Summary ID"},
+  {0x030, "Voltage"},
+  {0x031, "Current"},
+  {0x032, "Frequency"},
+  {0x033, "Apparent Power"},
+  {0x034, "Active Power"},
+  {0x035, "Percent Load"},
+  {0x036, "Temperature"},
+  {0x037, "Humidity"},
+  {0x038, "Bad Count"},
+  {0x040, "Config Voltage"},
+  {0x041, "Config Current"},
+  {0x042, "Config Frequency"},
+  {0x043, "Config Apparent Power"},
+  {0x044, "Config Active Power"},
+  {0x045, "Config Percent Load"},
+  {0x046, "Config Temperature"},
+  {0x047, "Config Humidity"},
+  {0x050, "Switch On Control"},
+  {0x051, "Switch Off Control"},
+  {0x052, "Toggle Control"},
+  {0x053, "Low Voltage Transfer"},
+  {0x054, "High Voltage Transfer"},
+  {0x055, "Delay Before Reboot"},
+  {0x056, "Delay Before Startup"},
+  {0x057, "Delay Before Shutdown"},
+  {0x058, "Test"},
+  {0x059, "Module Reset"},
+  {0x05a, "Audible Alarm Control"},
+  {0x060, "Present"},
+  {0x061, "Good"},
+  {0x062, "Internal Failure"},
+  {0x063, "Voltage out of range"},
+  {0x064, "Frequency out of range"},
+  {0x065, "Overload"},
+  {0x066, "Over Charged"},
+  {0x067, "Over Temperature"},
+  {0x068, "Shutdown Requested"},
+  {0x069, "Shutdown  Imminent"},
+  {0x06a, "Reserved"},
+  {0x06b, "Switch On/Off"},
+  {0x06c, "Switchable"},
+  {0x06d, "Used"},
+  {0x06e, "Boost"},
+  {0x06f, "Buck"},
+  {0x070, "Initialized"},
+  {0x071, "Tested"},
+  {0x072, "Awaiting Power"},
+  {0x073, "Communication Lost"},
+  {0x0fd, "iManufacturer"},
+  {0x0fe, "iProduct"},
+  {0x0ff, "iSerialNumber"},
+  {0x000, "Undefined"},
+  {0x001, "SMB Battery Mode"},
+  {0x002, "SMB Battery Status"},
+  {0x003, "SMB Alarm Warning"},
+  {0x004, "SMB Charger Mode"},
+  {0x005, "SMB Charger Status"},
+  {0x006, "SMB Charger Spec Info"},
+  {0x007, "SMB Selector State"},
+  {0x008, "SMB Selector Presets"},
+  {0x009, "SMB Selector Info"},
+  {0x010, "Optional Mfg. Function 1"},
+  {0x011, "Optional Mfg. Function 2"},
+  {0x012, "Optional Mfg. Function 3"},
+  {0x013, "Optional Mfg. Function 4"},
+  {0x014, "Optional Mfg. Function 5"},
+  {0x015, "Connection to SMBus"},
+  {0x016, "Output Connection"},
+  {0x017, "Charger Connection"},
+  {0x018, "Battery Insertion"},
+  {0x019, "Use Next"},
+  {0x01a, "OK to use"},
+  {0x01b, "Battery  Supported"},
+  {0x01c, "SelectorRevision"},
+  {0x01d, "Charging Indicator"},
+  {0x028, "Manufacturer Access"},
+  {0x029, "Remaining Capacity Limit"},
+  {0x02a, "Remaining Time Limit"},
+  {0x02b, "At Rate"},
+  {0x02c, "Capacity Mode"},
+  {0x02d, "Broadcast To Charger"},
+  {0x02e, "Primary Battery"},
+  {0x02f, "Charge Controller"},
+  {0x040, "Terminate Charge"},
+  {0x041, "Terminate Discharge"},
+  {0x042, "Below Remaining Capacity Limit"},
+  {0x043, "Remaining Time Limit Expired"},
+  {0x044, "Charging"},
+  {0x045, "Discharging"},
+  {0x046, "Fully Charged"},
+  {0x047, "Fully Discharged"},
+  {0x048, "Conditioning Flag"},
+  {0x049, "At Rate OK"},
+  {0x04a, "SMB Error Code"},
+  {0x04b, "Need Replacement"},
+  {0x060, "At Rate Time To Full"},
+  {0x061, "At Rate Time To Empty"},
+  {0x062, "Average Current"},
+  {0x063, "Max Error"},
+  {0x064, "Relative State Of Charge"},
+  {0x065, "Absolute State Of Charge"},
+  {0x066, "Remaining Capacity"},
+  {0x067, "Full Charge Capacity"},
+  {0x068, "Run Time To Empty"},
+  {0x069, "Average Time To Empty"},
+  {0x06a, "Average Time To Full"},
+  {0x06b, "Cycle Count"},
+  {0x080, "Batt. Pack Model Level"},
+  {0x081, "Internal Charge Controller"},
+  {0x082, "Primary Battery Support"},
+  {0x083, "Design Capacity"},
+  {0x084, "Specification Info"},
+  {0x085, "Manufacturer Date"},
+  {0x086, "Serial Number"},
+  {0x087, "iManufacturerName"},
+  {0x088, "iDeviceName"},
+  {0x089, "iDeviceChemistry"},
+  {0x08a, "Manufacturer Data"},
+  {0x08b, "Rechargeable"},
+  {0x08c, "Warning Capacity Limit"},
+  {0x08d, "Capacity Granularity 1"},
+  {0x08e, "Capacity Granularity 2"},
+  {0x08f, "iOEMInformation"},
+  {0x0c0, "Inhibit Charge"},
+  {0x0c1, "Enable Polling"},
+  {0x0c2, "Reset To Zero"},
+  {0x0d0, "AC Present"},
+  {0x0d1, "Battery Present"},
+  {0x0d2, "Power Fail"},
+  {0x0d3, "Alarm Inhibited"},
+  {0x0d4, "Thermistor Under Range"},
+  {0x0d5, "Thermistor Hot"},
+  {0x0d6, "Thermistor Cold"},
+  {0x0d7, "Thermistor Over Range"},
+  {0x0d8, "Voltage Out Of Range"},
+  {0x0d9, "Current Out Of Range"},
+  {0x0da, "Current Not Regulated"},
+  {0x0db, "Voltage Not Regulated"},
+  {0x0dc, "Master Mode"},
+  {0x0f0, "Charger Selector Support"},
+  {0x0f1, "Charger Spec"},
+  {0x0f2, "Level 2"},
+  {0x0f3, "Level 3"},
+  {0x0f1, "Cash Drawer"},
+  {0x0f2, "Cash Drawer Number"},
+  {0x0f3, "Cash Drawer Set"},
+  {0x0f4, "Cash Drawer Status"},
+};
+
+/* Generated by lsusb for rp2040 */
+constexpr uint8_t hid_usage_pages_idx[256] = 
+{
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0xff, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0xff, 0x0d,
+  0x0e, 0xff, 0xff, 0xff, 0x0f, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0x10, 0x11, 0x12, 0xff, 0x13, 0x14, 0x15, 0x16, 0xff, 0xff, 0xff, 0xff, 0x17, 0x18, 0xff, 0xff,
+  0x19, 0x1a, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+  0x1b, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x1c,
+};
+
+/* Generated by lsusb for rp2040 */
+constexpr const char* hid_item_types[64] = 
+{
+  nullptr,
+  "Usage Page", // 0x04
+  "Usage", // 0x08
+  nullptr,
+  nullptr,
+  "Logical Minimum", // 0x14
+  "Usage Minimum", // 0x18
+  nullptr,
+  nullptr,
+  "Logical Maximum", // 0x24
+  "Usage Maximum", // 0x28
+  nullptr,
+  nullptr,
+  "Physical Minimum", // 0x34
+  "Designator Index", // 0x38
+  nullptr,
+  nullptr,
+  "Physical Maximum", // 0x44
+  "Designator Minimum", // 0x48
+  nullptr,
+  nullptr,
+  "Unit Exponent", // 0x54
+  "Designator Maximum", // 0x58
+  nullptr,
+  nullptr,
+  "Unit", // 0x64
+  nullptr,
+  nullptr,
+  nullptr,
+  "Report Size", // 0x74
+  "String Index", // 0x78
+  nullptr,
+  "Input", // 0x80
+  "Report ID", // 0x84
+  "String Minimum", // 0x88
+  nullptr,
+  "Output", // 0x90
+  "Report Count", // 0x94
+  "String Maximum", // 0x98
+  nullptr,
+  "Collection", // 0xa0
+  "Push", // 0xa4
+  "Delimiter", // 0xa8
+  nullptr,
+  "Feature", // 0xb0
+  "Pop", // 0xb4
+  nullptr,
+  nullptr,
+  "End Collection", // 0xc0
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+  nullptr,
+};
+
+constexpr const char* hid_phys_items[40] = 
+{
+  "None", // 0x00
+  "Hand", // 0x01
+  "Eyeball", // 0x02
+  "Eyebrow", // 0x03
+  "Eyelid", // 0x04
+  "Ear", // 0x05
+  "Nose", // 0x06
+  "Mouth", // 0x07
+  "Upper Lip", // 0x08
+  "Lower Lip", // 0x09
+  "Jaw", // 0x0a
+  "Neck", // 0x0b
+  "Upper Arm", // 0x0c
+  "Elbow", // 0x0d
+  "Forearm", // 0x0e
+  "Wrist", // 0x0f
+  "Palm", // 0x10
+  "Thumb", // 0x11
+  "Index Finger", // 0x12
+  "Middle Finger", // 0x13
+  "Ring Finger", // 0x14
+  "Little Finger", // 0x15
+  "Head", // 0x16
+  "Shoulder", // 0x17
+  "Hip", // 0x18
+  "Waist", // 0x19
+  "Thigh", // 0x1a
+  "Knee", // 0x1b
+  "calf", // 0x1c
+  "Ankle", // 0x1d
+  "Foot", // 0x1e
+  "Heel", // 0x1f
+  "Ball of Foot", // 0x20
+  "Big Toe", // 0x21
+  "Second Toe", // 0x22
+  "Third Toe", // 0x23
+  "Fourth Toe", // 0x24
+  "Fifth Toe", // 0x25
+  "Brow", // 0x26
+  "Cheek", // 0x27
+};
+
+constexpr const char* hid_phys_biases[5] = 
+{
+  "Not Applicable", // 0x00
+  "Right Hand", // 0x01
+  "Left Hand", // 0x02
+  "Both Hands", // 0x03
+  "Either Hand", // 0x04
+};
+
+
@@ -0,0 +1,177 @@
+/* usb.ids sha1: 8b88b5601907511f62ba7678826ac83fe7d465a3 */
+/* Generated by lsusb for rp2040 */
+struct usb_lang_t { uint16_t lang_id; const char* name; uint8_t dialect_t_idx; uint8_t dialect_count; };
+
+constexpr usb_lang_t usb_langs[] = 
+{
+  {0x0001, "Arabic", 0, 16},
+  {0x0002, "Bulgarian", 16, 0},
+  {0x0003, "Catalan", 16, 0},
+  {0x0004, "Chinese", 16, 5},
+  {0x0005, "Czech", 21, 0},
+  {0x0006, "Danish", 21, 0},
+  {0x0007, "German", 21, 5},
+  {0x0008, "Greek", 26, 0},
+  {0x0009, "English", 26, 13},
+  {0x000a, "Spanish", 39, 20},
+  {0x000b, "Finnish", 59, 0},
+  {0x000c, "French", 59, 6},
+  {0x000d, "Hebrew", 65, 0},
+  {0x000e, "Hungarian", 65, 0},
+  {0x000f, "Idelandic", 65, 0},
+  {0x0010, "Italian", 65, 2},
+  {0x0011, "Japanese", 67, 0},
+  {0x0012, "Korean", 67, 1},
+  {0x0013, "Dutch", 68, 2},
+  {0x0014, "Norwegian", 70, 2},
+  {0x0015, "Polish", 72, 0},
+  {0x0016, "Portuguese", 72, 2},
+  {0x0017, "forgotten", 74, 0},
+  {0x0018, "Romanian", 74, 0},
+  {0x0019, "Russian", 74, 0},
+  {0x001a, "Serbian", 74, 3},
+  {0x001b, "Slovak", 77, 0},
+  {0x001c, "Albanian", 77, 0},
+  {0x001d, "Swedish", 77, 2},
+  {0x001e, "Thai", 79, 0},
+  {0x001f, "Turkish", 79, 0},
+  {0x0020, "Urdu", 79, 2},
+  {0x0021, "Indonesian", 81, 0},
+  {0x0022, "Ukrainian", 81, 0},
+  {0x0023, "Belarusian", 81, 0},
+  {0x0024, "Slovenian", 81, 0},
+  {0x0025, "Estonian", 81, 0},
+  {0x0026, "Latvian", 81, 0},
+  {0x0027, "Lithuanian", 81, 1},
+  {0x0028, "forgotten", 82, 0},
+  {0x0029, "Farsi", 82, 0},
+  {0x002a, "Vietnamese", 82, 0},
+  {0x002b, "Armenian", 82, 0},
+  {0x002c, "Azeri", 82, 2},
+  {0x002d, "Basque", 84, 0},
+  {0x002e, "forgotten", 84, 0},
+  {0x002f, "Macedonian", 84, 0},
+  {0x0036, "Afrikaans", 84, 0},
+  {0x0037, "Georgian", 84, 0},
+  {0x0038, "Faeroese", 84, 0},
+  {0x0039, "Hindi", 84, 0},
+  {0x003e, "Malay", 84, 2},
+  {0x003f, "Kazak", 86, 0},
+  {0x0041, "Awahili", 86, 0},
+  {0x0043, "Uzbek", 86, 2},
+  {0x0044, "Tatar", 88, 0},
+  {0x0045, "Bengali", 88, 0},
+  {0x0046, "Punjabi", 88, 0},
+  {0x0047, "Gujarati", 88, 0},
+  {0x0048, "Oriya", 88, 0},
+  {0x0049, "Tamil", 88, 0},
+  {0x004a, "Telugu", 88, 0},
+  {0x004b, "Kannada", 88, 0},
+  {0x004c, "Malayalam", 88, 0},
+  {0x004d, "Assamese", 88, 0},
+  {0x004e, "Marathi", 88, 0},
+  {0x004f, "Sanskrit", 88, 0},
+  {0x0057, "Konkani", 88, 0},
+  {0x0058, "Manipuri", 88, 0},
+  {0x0059, "Sindhi", 88, 0},
+  {0x0060, "Kashmiri", 88, 1},
+  {0x0061, "Nepali", 89, 1},
+};
+
+/* Generated by lsusb for rp2040 */
+struct usb_dialect_t { uint8_t dialect_id; const char* name; };
+
+constexpr usb_dialect_t usb_dialects[] = 
+{
+  {0x01, "Saudi Arabia"},
+  {0x02, "Iraq"},
+  {0x03, "Egypt"},
+  {0x04, "Libya"},
+  {0x05, "Algeria"},
+  {0x06, "Morocco"},
+  {0x07, "Tunesia"},
+  {0x08, "Oman"},
+  {0x09, "Yemen"},
+  {0x0a, "Syria"},
+  {0x0b, "Jordan"},
+  {0x0c, "Lebanon"},
+  {0x0d, "Kuwait"},
+  {0x0e, "U.A.E"},
+  {0x0f, "Bahrain"},
+  {0x10, "Qatar"},
+  {0x01, "Traditional"},
+  {0x02, "Simplified"},
+  {0x03, "Hongkong SAR, PRC"},
+  {0x04, "Singapore"},
+  {0x05, "Macau SAR"},
+  {0x01, "German"},
+  {0x02, "Swiss"},
+  {0x03, "Austrian"},
+  {0x04, "Luxembourg"},
+  {0x05, "Liechtenstein"},
+  {0x01, "US"},
+  {0x02, "UK"},
+  {0x03, "Australian"},
+  {0x04, "Canadian"},
+  {0x05, "New Zealand"},
+  {0x06, "Ireland"},
+  {0x07, "South Africa"},
+  {0x08, "Jamaica"},
+  {0x09, "Carribean"},
+  {0x0a, "Belize"},
+  {0x0b, "Trinidad"},
+  {0x0c, "Zimbabwe"},
+  {0x0d, "Philippines"},
+  {0x01, "Castilian"},
+  {0x02, "Mexican"},
+  {0x03, "Modern"},
+  {0x04, "Guatemala"},
+  {0x05, "Costa Rica"},
+  {0x06, "Panama"},
+  {0x07, "Dominican Republic"},
+  {0x08, "Venzuela"},
+  {0x09, "Colombia"},
+  {0x0a, "Peru"},
+  {0x0b, "Argentina"},
+  {0x0c, "Ecuador"},
+  {0x0d, "Chile"},
+  {0x0e, "Uruguay"},
+  {0x0f, "Paraguay"},
+  {0x10, "Bolivia"},
+  {0x11, "El Salvador"},
+  {0x12, "Honduras"},
+  {0x13, "Nicaragua"},
+  {0x14, "Puerto Rico"},
+  {0x01, "French"},
+  {0x02, "Belgian"},
+  {0x03, "Canadian"},
+  {0x04, "Swiss"},
+  {0x05, "Luxembourg"},
+  {0x06, "Monaco"},
+  {0x01, "Italian"},
+  {0x02, "Swiss"},
+  {0x01, "Korean"},
+  {0x01, "Dutch"},
+  {0x02, "Belgian"},
+  {0x01, "Bokmal"},
+  {0x02, "Nynorsk"},
+  {0x01, "Portuguese"},
+  {0x02, "Brazilian"},
+  {0x01, "Croatian"},
+  {0x02, "Latin"},
+  {0x03, "Cyrillic"},
+  {0x01, "Swedish"},
+  {0x02, "Finland"},
+  {0x01, "Pakistan"},
+  {0x02, "India"},
+  {0x01, "Lithuanian"},
+  {0x01, "Cyrillic"},
+  {0x02, "Latin"},
+  {0x01, "Malaysia"},
+  {0x02, "Brunei Darassalam"},
+  {0x01, "Latin"},
+  {0x02, "Cyrillic"},
+  {0x02, "India"},
+  {0x02, "India"},
+};
+
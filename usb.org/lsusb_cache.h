@@ -0,0 +1,85 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+
+// Small RAM cache in front of the flash (XIP) lookups, 2-way set associative:
+// each key maps to one set, the least recently used way of the set gets evicted.
+
+#if !defined USB_IDS_CACHE_SETS
+  #define USB_IDS_CACHE_SETS 16 // power of two, 2 entries per set
+#endif
+
+template<typename value_t, size_t sets_count=USB_IDS_CACHE_SETS>
+struct usb_ids_cache_t
+{
+  static_assert( (sets_count & (sets_count-1)) == 0, "sets_count must be a power of two" );
+
+  struct entry_t
+  {
+    uint32_t key;
+    value_t value;
+    bool valid;
+  };
+
+  entry_t entries[sets_count][2] = {};
+  uint8_t lru[sets_count] = {}; // way to evict next
+  uint32_t hits   = 0;
+  uint32_t misses = 0;
+
+  static size_t set_of( uint32_t key )
+  {
+    return usb_ids_hash( key >> 16, key ) & (sets_count-1);
+  }
+
+  // returns nullptr on miss
+  const value_t* get( uint32_t key )
+  {
+    size_t set = set_of( key );
+    for( uint8_t way=0; way<2; way++ ) {
+      if( entries[set][way].valid && entries[set][way].key == key ) {
+        lru[set] = way ^ 1;
+        hits++;
+        return &entries[set][way].value;
+      }
+    }
+    misses++;
+    return nullptr;
+  }
+
+  void put( uint32_t key, const value_t& value )
+  {
+    size_t set = set_of( key );
+    uint8_t way = lru[set];
+    entries[set][way] = { key, value, true };
+    lru[set] = way ^ 1;
+  }
+
+  void clear()
+  {
+    *this = usb_ids_cache_t();
+  }
+};
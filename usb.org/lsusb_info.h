@@ -28,22 +28,48 @@
 
 #include "./lsusb.ids.h"
 #include "./lsusb.classes_protos.h"
-
-const size_t usb_vids_count       = sizeof(usb_vids)/sizeof(vendor_id_t);
-const size_t usb_pids_count       = sizeof(usb_pids)/sizeof(product_id_t);
-const size_t usb_classes_count    = sizeof(usb_classes)/sizeof(usb_class_t);
-const size_t usb_subclasses_count = sizeof(usb_subclasses)/sizeof(usb_subclass_t);
-const size_t usb_protos_count     = sizeof(usb_protos)/sizeof(usb_proto_t);
+#include "./lsusb.hid.h"
+#include "./lsusb.languages.h"
+#include "./lsusb_search.h"
+#include "./lsusb_cache.h"
+
+// lookup strategies, see lsusb_search.h
+#if !defined USB_IDS_VENDOR_SEARCH
+  #define USB_IDS_VENDOR_SEARCH USB_IDS_SEARCH_HASH
+#endif
+#if !defined USB_IDS_PRODUCT_SEARCH
+  #define USB_IDS_PRODUCT_SEARCH USB_IDS_SEARCH_BINARY
+#endif
+
+const size_t usb_vids_count          = sizeof(usb_vids)/sizeof(vendor_id_t);
+const size_t usb_pids_count          = sizeof(usb_pids)/sizeof(product_id_t);
+const size_t usb_classes_count       = sizeof(usb_classes)/sizeof(usb_class_t);
+const size_t usb_subclasses_count    = sizeof(usb_subclasses)/sizeof(usb_subclass_t);
+const size_t usb_protos_count        = sizeof(usb_protos)/sizeof(usb_proto_t);
+const size_t hid_usage_pages_count   = sizeof(hid_usage_pages)/sizeof(hid_usage_page_t);
+const size_t hid_usages_count        = sizeof(hid_usages)/sizeof(hid_usage_t);
+const size_t usb_langs_count         = sizeof(usb_langs)/sizeof(usb_lang_t);
+
+const usb_ids_mph_t usb_vids_mph = { usb_vids_mph_disp, sizeof(usb_vids_mph_disp)/sizeof(int16_t), usb_vids_mph_slot };
 
 const char* bmAttrXfer[4]  = {"Control", "Isochronous", "Bulk", "Interrupt"};
 const char* bmAttrSync[4]  = {"None", "Asynchronous", "Adaptive", "Synchronous"};
 const char* bmAttrUsage[4] = {"Data", "Feedback", "Explicit feedback", "Reserved"};
 
-const vendor_id_t      nullVendor = { 0, "", 0, 0 };
-const usb_class_t       nullClass = { 0, "", 0, 0 };
-const usb_subclass_t nullSubclass = { 0, "", 0, 0 };
-const product_id_t    nullProduct = { 0, "" };
-const usb_proto_t       nullProto = { 0, "" };
+const vendor_id_t          nullVendor = { USB_IDS_STR(0), 0, 0 };
+constexpr usb_class_t       nullClass = { 0, "", 0, 0 };
+constexpr usb_subclass_t nullSubclass = { 0, "", 0, 0 };
+const product_id_t        nullProduct = { USB_IDS_STR(0) };
+constexpr usb_proto_t       nullProto = { 0, "" };
+constexpr hid_usage_page_t nullUsagePage = { 0, "", 0, 0 };
+constexpr hid_usage_t      nullUsage = { 0, "" };
+constexpr usb_lang_t         nullLang = { 0, "", 0, 0 };
+constexpr usb_dialect_t   nullDialect = { 0, "" };
+
+struct usb_ids_name_t
+{
+  char c_str[USB_IDS_NAME_MAX];
+};
 
 struct usb_vid_pid_t
 {
@@ -58,6 +84,12 @@ struct usb_class_sub_proto_t
   const usb_proto_t* dev_proto;
 };
 
+struct usb_lang_dialect_t
+{
+  const usb_lang_t* lang;
+  const usb_dialect_t* dialect;
+};
+
 struct bEndpointAddress_t
 {
   struct bits_t {
@@ -73,80 +105,185 @@ struct bEndpointAddress_t
 
 
 
-const usb_class_t* get_class( uint8_t class_id )
+// Streaming decoder for the usb_ids_pool[] names generated by gen.py, the decoded
+// name is returned by value so it lives on the caller's stack, e.g.:
+//   printf("%s\n", usb_ids_name( vendor->name ).c_str );
+usb_ids_name_t usb_ids_name( usb_ids_str_t str )
 {
-  for( size_t i=0; i<usb_classes_count; i++ ) {
-    if( usb_classes[i].class_id == class_id ) return &usb_classes[i];
+  usb_ids_name_t name;
+  const uint8_t* src = &usb_ids_pool[ str.offset[0] | str.offset[1]<<8 | str.offset[2]<<16 ];
+  char* dst = name.c_str; // USB_IDS_NAME_MAX is the longest decoded name, no need to check bounds
+  while( *src ) {
+    uint8_t code = *src++;
+    if( code < USB_IDS_POOL_TOKEN1 ) {
+      *dst++ = code;
+    } else if( code == USB_IDS_POOL_ESCAPE ) {
+      *dst++ = *src++;
+    } else {
+      uint16_t token_idx = code - USB_IDS_POOL_TOKEN1;
+      if( code >= USB_IDS_POOL_TOKEN2 ) {
+        token_idx = ( USB_IDS_POOL_TOKEN2 - USB_IDS_POOL_TOKEN1 ) + ( ( code - USB_IDS_POOL_TOKEN2 ) << 8 | *src++ );
+      }
+      for( const char* token = &usb_ids_tokens[usb_ids_tokens_idx[token_idx]]; *token; ) {
+        *dst++ = *token++;
+      }
+    }
   }
-  return &nullClass;
+  *dst = '\0';
+  return name;
 }
 
 
-const usb_subclass_t* get_subclass( uint8_t subclass_id, uint8_t offset, uint8_t count )
+// rank of the id bit in a 256 bits map generated by gen.py, this is the offset
+// of the id in its subclass/protocol slice
+constexpr uint8_t usb_ids_map_rank( const uint32_t* map, uint8_t id )
 {
-  if( count>0 && offset+count<=usb_subclasses_count ) {
-    for( int i=offset; i<offset+count; i++ ) {
-      if( usb_subclasses[i].subclass_id == subclass_id ) return &usb_subclasses[i];
-    }
-  }
-  return &nullSubclass;
+  uint8_t rank = __builtin_popcount( map[id>>5] & ( ( 1u << (id&31) ) - 1 ) );
+  for( uint8_t i=0; i<(id>>5); i++ ) rank += __builtin_popcount( map[i] );
+  return rank;
 }
 
 
-const usb_proto_t* get_proto( uint8_t proto_id, uint8_t offset, uint8_t count )
+constexpr bool usb_ids_map_has( const uint32_t* map, uint8_t id )
 {
-  if( count>0 && offset+count<=usb_protos_count ) {
-    for( int i=offset; i<offset+count; i++ ) {
-      if( usb_protos[i].proto_id == proto_id ) return &usb_protos[i];
-    }
-  }
-  return &nullProto;
+  return ( map[id>>5] >> (id&31) ) & 1;
 }
 
 
-usb_class_sub_proto_t get_class_sub_proto( uint8_t class_id, uint8_t subclass_id, uint8_t proto_id )
+constexpr const usb_class_t* get_class( uint8_t class_id )
+{
+  return usb_classes_idx[class_id] != 0xff ? &usb_classes[usb_classes_idx[class_id]] : &nullClass;
+}
+
+
+constexpr const usb_subclass_t* get_subclass( const usb_class_t* dev_class, uint8_t subclass_id )
+{
+  if( dev_class->subclass_count == 0 ) return &nullSubclass; // also catches &nullClass
+  const uint32_t* map = usb_subclasses_map[dev_class - usb_classes];
+  if( !usb_ids_map_has( map, subclass_id ) ) return &nullSubclass;
+  return &usb_subclasses[dev_class->subclass_t_idx + usb_ids_map_rank( map, subclass_id )];
+}
+
+
+constexpr const usb_proto_t* get_proto( const usb_subclass_t* dev_subclass, uint8_t proto_id )
+{
+  if( dev_subclass->proto_count == 0 ) return &nullProto; // also catches &nullSubclass
+  const uint32_t* map = usb_protos_map[dev_subclass - usb_subclasses];
+  if( !usb_ids_map_has( map, proto_id ) ) return &nullProto;
+  return &usb_protos[dev_subclass->proto_t_idx + usb_ids_map_rank( map, proto_id )];
+}
+
+
+// constant time, and constexpr so known triples fold at compile time
+constexpr usb_class_sub_proto_t find_class_sub_proto( uint8_t class_id, uint8_t subclass_id, uint8_t proto_id )
 {
   const usb_class_t* dev_class = get_class( class_id );
-  const usb_subclass_t* dev_subclass = &nullSubclass;
-  const usb_proto_t* dev_proto = &nullProto;
-  if( dev_class && dev_class->subclass_count > 0 ) {
-    dev_subclass = get_subclass( subclass_id, dev_class->subclass_t_idx, dev_class->subclass_count );//&usb_subclasses[dev_class->subclass_t_idx];
-    if( dev_subclass && dev_subclass->proto_count > 0 ) {
-      dev_proto = get_proto( proto_id, dev_subclass->proto_t_idx, dev_subclass->proto_count );// &usb_protos[dev_subclass->proto_t_idx];
-    }
-  }
+  const usb_subclass_t* dev_subclass = get_subclass( dev_class, subclass_id );
+  const usb_proto_t* dev_proto = get_proto( dev_subclass, proto_id );
   return { dev_class, dev_subclass, dev_proto };
 }
 
 
+usb_ids_cache_t<usb_class_sub_proto_t> class_sub_proto_cache;
+
+usb_class_sub_proto_t get_class_sub_proto( uint8_t class_id, uint8_t subclass_id, uint8_t proto_id )
+{
+  uint32_t key = class_id << 16 | subclass_id << 8 | proto_id;
+  auto cached = class_sub_proto_cache.get( key );
+  if( cached ) return *cached;
+  auto class_sub_proto = find_class_sub_proto( class_id, subclass_id, proto_id );
+  class_sub_proto_cache.put( key, class_sub_proto );
+  return class_sub_proto;
+}
+
+static_assert( find_class_sub_proto( TUSB_CLASS_HID, 1, HID_ITF_PROTOCOL_KEYBOARD ).dev_proto->proto_id == HID_ITF_PROTOCOL_KEYBOARD, "usb.org tables are out of sync" );
+
+
+// constant time, vendor defined pages (0xff00-0xffff) all resolve to the "Vendor Specific" page
+constexpr const hid_usage_page_t* get_hid_usage_page( uint16_t page_id )
+{
+  if( page_id >= 0xff00 ) page_id = 0xff;
+  else if( page_id > 0xff ) return &nullUsagePage;
+  return hid_usage_pages_idx[page_id] != 0xff ? &hid_usage_pages[hid_usage_pages_idx[page_id]] : &nullUsagePage;
+}
+
+
+// gen.py keeps each page's usage slice sorted by usage id
+constexpr const hid_usage_t* get_hid_usage( const hid_usage_page_t* page, uint16_t usage_id )
+{
+  const hid_usage_t* usages = &hid_usages[page->usage_t_idx];
+  int32_t idx = usb_ids_search<USB_IDS_SEARCH_BINARY>( usage_id, page->usage_count, [usages]( size_t i ) { return usages[i].usage_id; } );
+  return idx<0 ? &nullUsage : &usages[idx];
+}
+
+static_assert( get_hid_usage( get_hid_usage_page( HID_USAGE_PAGE_DESKTOP ), HID_USAGE_DESKTOP_KEYBOARD )->usage_id == HID_USAGE_DESKTOP_KEYBOARD, "usb.org tables are out of sync" );
+
+
+// short item prefix (tag, type and size), e.g. 0x05 is "Usage Page"
+const char* hid_item_type_to_string( uint8_t item )
+{
+  const char* name = hid_item_types[item>>2];
+  return name ? name : "";
+}
+
+
+const char* hid_phys_item_to_string( uint8_t designator )
+{
+  const char* name = designator < sizeof(hid_phys_items)/sizeof(hid_phys_items[0]) ? hid_phys_items[designator] : nullptr;
+  return name ? name : "";
+}
+
+
+const char* hid_phys_bias_to_string( uint8_t bias )
+{
+  const char* name = bias < sizeof(hid_phys_biases)/sizeof(hid_phys_biases[0]) ? hid_phys_biases[bias] : nullptr;
+  return name ? name : "";
+}
+
+
+// LANGID: primary language in the lower 10 bits, dialect in the upper 6 bits
+constexpr usb_lang_dialect_t get_lang( uint16_t langid )
+{
+  int32_t idx = usb_ids_search<USB_IDS_SEARCH_BINARY>( langid & 0x3ff, usb_langs_count, []( size_t i ) { return usb_langs[i].lang_id; } );
+  if( idx<0 ) return { &nullLang, &nullDialect };
+  const usb_lang_t* lang = &usb_langs[idx];
+  const usb_dialect_t* dialects = &usb_dialects[lang->dialect_t_idx];
+  idx = usb_ids_search<USB_IDS_SEARCH_BINARY>( langid >> 10, lang->dialect_count, [dialects]( size_t i ) { return dialects[i].dialect_id; } );
+  return { lang, idx<0 ? &nullDialect : &dialects[idx] };
+}
+
+static_assert( get_lang( 0x0409 ).dialect->dialect_id == 1, "usb.org tables are out of sync" );
+
+
+// e.g. "English (US)", empty when the language is unknown
+const char* langid_to_string( uint16_t langid )
+{
+  static char lang_str[64];
+  auto lang_dialect = get_lang( langid );
+  if( lang_dialect.dialect == &nullDialect ) return lang_dialect.lang->name;
+  snprintf( lang_str, sizeof(lang_str), "%s (%s)", lang_dialect.lang->name, lang_dialect.dialect->name );
+  return lang_str;
+}
+
+
 const vendor_id_t* get_vendor( uint16_t vendor_id )
 {
-  uint16_t maybe_idx = map( vendor_id, usb_vids[0].vendor_id, usb_vids[usb_vids_count-1].vendor_id, 0, usb_vids_count-1 );
-  if( maybe_idx >= usb_vids_count ) return &nullVendor; // overflow
-  if( usb_vids[maybe_idx].vendor_id == vendor_id ) return &usb_vids[maybe_idx]; // match!
-  int dir      = vendor_id < usb_vids[maybe_idx].vendor_id ? -1 : 1; // seek direction
-  int last_idx = vendor_id < usb_vids[maybe_idx].vendor_id ?  0 : usb_vids_count-1;
-  do {
-    maybe_idx += dir;
-    if( usb_vids[maybe_idx].vendor_id == vendor_id ) return &usb_vids[maybe_idx]; // match!
-  } while( maybe_idx!=last_idx );
-  return &nullVendor;
+  int32_t idx = usb_ids_search<USB_IDS_VENDOR_SEARCH>( vendor_id, usb_vids_count, []( size_t i ) { return usb_vid_keys[i]; }, &usb_vids_mph );
+  return idx<0 ? &nullVendor : &usb_vids[idx];
 }
 
 
+// gen.py keeps each vendor's product slice sorted by product id
 const product_id_t* get_product( const vendor_id_t *vendor, uint16_t product_id )
 {
-  if( vendor->product_count==1 ) return &usb_pids[vendor->product_id_t_idx];
-
-  for( size_t i=0; i<vendor->product_count; i++ ) {
-    auto product = &usb_pids[vendor->product_id_t_idx+i];
-    if( product->product_id == product_id ) return product;
-  }
-  return &nullProduct;
+  static_assert( USB_IDS_PRODUCT_SEARCH != USB_IDS_SEARCH_HASH, "There is no perfect hash for product ids" );
+  const uint16_t* keys = &usb_pid_keys[vendor->product_id_t_idx];
+  int32_t idx = usb_ids_search<USB_IDS_PRODUCT_SEARCH>( product_id, vendor->product_count, [keys]( size_t i ) { return keys[i]; } );
+  return idx<0 ? &nullProduct : &usb_pids[vendor->product_id_t_idx+idx];
 }
 
 
-usb_vid_pid_t get_vid_pid( uint16_t vendor_id, uint16_t product_id )
+usb_vid_pid_t find_vid_pid( uint16_t vendor_id, uint16_t product_id )
 {
   const vendor_id_t *vendor = get_vendor( vendor_id );
   const product_id_t *product = &nullProduct;
@@ -159,18 +296,26 @@ usb_vid_pid_t get_vid_pid( uint16_t vendor_id, uint16_t product_id )
 }
 
 
+usb_ids_cache_t<usb_vid_pid_t> vid_pid_cache;
+
+usb_vid_pid_t get_vid_pid( uint16_t vendor_id, uint16_t product_id )
+{
+  uint32_t key = (uint32_t)vendor_id << 16 | product_id;
+  auto cached = vid_pid_cache.get( key );
+  if( cached ) return *cached;
+  auto vid_pid = find_vid_pid( vendor_id, product_id );
+  vid_pid_cache.put( key, vid_pid );
+  return vid_pid;
+}
+
+
 const char* vendor_id_to_string( uint16_t vendor_id )
 {
-  uint16_t maybe_idx = map( vendor_id, usb_vids[0].vendor_id, usb_vids[usb_vids_count-1].vendor_id, 0, usb_vids_count-1 );
-  if( maybe_idx >= usb_vids_count ) return nullptr; // overflow
-  if( usb_vids[maybe_idx].vendor_id == vendor_id ) return usb_vids[maybe_idx].name; // match!
-  int dir      = vendor_id < usb_vids[maybe_idx].vendor_id ? -1 : 1; // seek direction
-  int last_idx = vendor_id < usb_vids[maybe_idx].vendor_id ?  0 : usb_vids_count-1;
-  do {
-    maybe_idx += dir;
-    if( usb_vids[maybe_idx].vendor_id == vendor_id ) return usb_vids[maybe_idx].name; // match!
-  } while( maybe_idx!=last_idx );
-  return nullptr;
+  static usb_ids_name_t vendor_name;
+  const vendor_id_t *vendor = get_vendor( vendor_id );
+  if( vendor == &nullVendor ) return nullptr;
+  vendor_name = usb_ids_name( vendor->name );
+  return vendor_name.c_str;
 }
 
 
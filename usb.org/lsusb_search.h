@@ -0,0 +1,98 @@
+/*\
+ *
+ * lsusb-rp2040 MIT License
+ *
+ * Copyright (c) 2023 tobozo
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ *
+\*/
+
+#pragma once
+
+// Generic search engine over the sorted tables generated by gen.py.
+//
+// A table is described by its record count and a key projection (index -> key),
+// so the same code serves both the dense key arrays (usb_vid_keys[], usb_pid_keys[])
+// and the keys embedded in structs. The strategy is picked at compile time, all of
+// them return the record index, or -1 when the key is not in the table.
+
+enum usb_ids_search_t
+{
+  USB_IDS_SEARCH_INTERPOLATION, // sorted keys, O(log log n) on evenly spread keys
+  USB_IDS_SEARCH_BINARY,        // sorted keys, branchless O(log n)
+  USB_IDS_SEARCH_HASH,          // any order, O(1) with a minimal perfect hash from gen.py
+};
+
+// hash-and-displace tables emitted by gen.py's mph_to_c()
+struct usb_ids_mph_t
+{
+  const int16_t* disp;
+  size_t disp_count;
+  const uint16_t* slot;
+};
+
+
+// must match mph_hash() in gen.py
+constexpr uint32_t usb_ids_hash( uint32_t seed, uint16_t key )
+{
+  uint32_t h = key * 0x9E3779B1u + seed * 0x85EBCA6Bu;
+  h ^= h >> 15;
+  h *= 0x2C1B3C6Du;
+  h ^= h >> 12;
+  return h;
+}
+
+
+template<usb_ids_search_t strategy, typename key_at_t>
+constexpr int32_t usb_ids_search( uint16_t key, size_t count, key_at_t key_at, const usb_ids_mph_t* mph=nullptr )
+{
+  if( count==0 ) return -1;
+
+  if constexpr( strategy == USB_IDS_SEARCH_HASH ) {
+    // one displacement read, one slot read, and a single key probe to verify the match
+    int16_t disp = mph->disp[ usb_ids_hash( 0, key ) % mph->disp_count ];
+    size_t slot = disp < 0 ? -disp-1 : usb_ids_hash( disp, key ) % count;
+    size_t idx = mph->slot[slot];
+    return key_at( idx ) == key ? idx : -1;
+  } else if constexpr( strategy == USB_IDS_SEARCH_BINARY ) {
+    size_t base = 0;
+    while( count>1 ) {
+      size_t half = count/2;
+      base  += ( key_at( base+half ) <= key ) ? half : 0; // compiles to a conditional select
+      count -= half;
+    }
+    return key_at( base ) == key ? base : -1;
+  } else {
+    // the guess is always clamped to [lo, hi] so there's no over/underflow at either end,
+    // (key-lo_key)*(hi-lo) fits in 32 bits as long as count <= 0x10000
+    size_t lo = 0, hi = count-1;
+    while( lo<=hi ) {
+      uint16_t lo_key = key_at( lo ), hi_key = key_at( hi );
+      if( key<lo_key || key>hi_key ) return -1;
+      size_t idx = hi_key==lo_key ? lo : lo + uint32_t( key-lo_key ) * ( hi-lo ) / ( hi_key-lo_key );
+      uint16_t idx_key = key_at( idx );
+      if( idx_key == key ) return idx;
+      if( idx_key < key ) lo = idx+1;
+      else if( idx==0 ) return -1;
+      else hi = idx-1;
+    }
+    return -1;
+  }
+}